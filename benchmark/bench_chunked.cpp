@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+#include "GNSSChunkedParser.h"
+#include "bench_common.h"
+
+// GNSS_BENCH_CAPTURE_MB overrides the size of the synthetic capture
+static size_t capture_bytes()
+{
+    const char *env = getenv("GNSS_BENCH_CAPTURE_MB");
+    size_t mb = env ? strtoul(env, nullptr, 10) : 2048;
+    return mb * 1024 * 1024;
+}
+
+static uint64_t fold(uint64_t hash, int type, size_t length)
+{
+    return (hash ^ (static_cast<uint64_t>(type) << 32 | length)) * 1099511628211ull;
+}
+
+// The 33816/2193 capture replayed with runs of corrupted bytes between
+// copies, so that false preambles and broken frames straddle chunk seams
+static std::vector<uint8_t> make_capture(const std::vector<uint8_t> &data, size_t size)
+{
+    std::vector<uint8_t> capture;
+    capture.reserve(size);
+    srand(7);
+
+    while (capture.size() < size)
+    {
+        size_t length = std::min(data.size(), size - capture.size());
+        capture.insert(capture.end(), data.begin(), data.begin() + length);
+
+        for (int i = 0; i < 64 && capture.size() < size; i++)
+        {
+            const uint8_t noise[] = {0xD3, '$', 0x00, 0x12, '*'};
+            capture.push_back(noise[rand() % sizeof(noise)]);
+        }
+    }
+
+    return capture;
+}
+
+void run_chunked_benchmarks()
+{
+    const char *path = "test/test-data/test-data-33816-2193.bin";
+    std::vector<uint8_t> data = load_file(path);
+    if (data.empty())
+    {
+        printf("Cannot open %s, run from the repository root\n", path);
+        return;
+    }
+
+    std::vector<uint8_t> capture = make_capture(data, capture_bytes());
+    printf("\nChunked parsing of a %.1f GB synthetic capture\n", capture.size() / 1e9);
+
+    GNSSParser parser;
+    uint64_t expected = 14695981039346656037ull;
+    size_t expected_frames = 0;
+
+    uint64_t start = bench_now_ns();
+    parser.encode_to(&capture[0], capture.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                     {
+                         if (valid)
+                         {
+                             expected = fold(expected, view.type, view.length());
+                             expected_frames++;
+                         } });
+    uint64_t sequential_ns = bench_now_ns() - start;
+    printf("Sequential GNSSParser    %7.3f GB/s  %zu frames\n", static_cast<double>(capture.size()) / sequential_ns, expected_frames);
+
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= cores; threads *= 2)
+    {
+        GNSSChunkedParser chunked(threads);
+        uint64_t hash = 14695981039346656037ull;
+        size_t frames = 0;
+
+        start = bench_now_ns();
+        chunked.parse(&capture[0], capture.size(), [&](const GNSSChunkedParser::Frame &frame)
+                      {
+                          hash = fold(hash, frame.type, frame.length);
+                          frames++; });
+        uint64_t elapsed = bench_now_ns() - start;
+
+        printf("Chunked, %2zu threads     %7.3f GB/s  %zu frames  %s\n", threads,
+               static_cast<double>(capture.size()) / elapsed, frames,
+               hash == expected && frames == expected_frames ? "identical" : "MISMATCH");
+
+        if (threads < cores && threads * 2 > cores)
+            threads = cores / 2;
+    }
+}
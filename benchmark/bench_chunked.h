@@ -0,0 +1,6 @@
+#ifndef __BENCH_CHUNKED_H__
+#define __BENCH_CHUNKED_H__
+
+void run_chunked_benchmarks();
+
+#endif // __BENCH_CHUNKED_H__
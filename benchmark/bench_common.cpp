@@ -0,0 +1,139 @@
+#include "bench_common.h"
+#include <stdio.h>
+#include <chrono>
+#include <algorithm>
+#include "GNSSParser.h"
+
+uint64_t bench_now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static uint32_t crc24q(const uint8_t *data, size_t length)
+{
+    uint32_t crc = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= static_cast<uint32_t>(data[i]) << 16;
+        for (int j = 0; j < 8; j++)
+        {
+            crc <<= 1;
+            if (crc & 0x1000000)
+                crc ^= 0x1864CFB;
+        }
+    }
+    return crc & 0xFFFFFF;
+}
+
+void append_nmea_sentence(std::vector<uint8_t> &stream, size_t length)
+{
+    // "$GPTXT," + filler + "*hh\r\n"
+    const char *prefix = "$GPTXT,";
+    size_t start = stream.size();
+    for (const char *p = prefix; *p; p++)
+        stream.push_back(*p);
+
+    while (stream.size() - start < length - 5)
+        stream.push_back('0' + (stream.size() % 10));
+
+    uint8_t checksum = 0;
+    for (size_t i = start + 1; i < stream.size(); i++)
+        checksum ^= stream[i];
+
+    char tail[6];
+    snprintf(tail, sizeof(tail), "*%02X\r\n", checksum);
+    for (int i = 0; i < 5; i++)
+        stream.push_back(tail[i]);
+}
+
+void append_rtcm3_frame(std::vector<uint8_t> &stream, uint16_t message_number, size_t payload_length)
+{
+    size_t start = stream.size();
+    stream.push_back(0xD3);
+    stream.push_back((payload_length >> 8) & 0x03);
+    stream.push_back(payload_length & 0xFF);
+
+    for (size_t i = 0; i < payload_length; i++)
+    {
+        if (i == 0)
+            stream.push_back(message_number >> 4);
+        else if (i == 1)
+            stream.push_back((message_number & 0x0F) << 4);
+        else
+            stream.push_back((i * 131 + 7) & 0xFF);
+    }
+
+    uint32_t crc = crc24q(&stream[start], stream.size() - start);
+    stream.push_back((crc >> 16) & 0xFF);
+    stream.push_back((crc >> 8) & 0xFF);
+    stream.push_back(crc & 0xFF);
+}
+
+void append_ubx_frame(std::vector<uint8_t> &stream, uint8_t message_class, uint8_t id, size_t payload_length)
+{
+    stream.push_back(0xB5);
+    stream.push_back(0x62);
+    stream.push_back(message_class);
+    stream.push_back(id);
+    stream.push_back(payload_length & 0xFF);
+    stream.push_back((payload_length >> 8) & 0xFF);
+
+    // Binary payload with the odd RTCM3 preamble in it
+    for (size_t i = 0; i < payload_length; i++)
+        stream.push_back(i % 61 == 5 ? 0xD3 : (i * 89 + id) & 0xFF);
+
+    uint8_t a = 0, b = 0;
+    for (size_t i = stream.size() - payload_length - 4; i < stream.size(); i++)
+    {
+        a += stream[i];
+        b += a;
+    }
+    stream.push_back(a);
+    stream.push_back(b);
+}
+
+std::vector<uint8_t> load_file(const char *path)
+{
+    std::vector<uint8_t> data;
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return data;
+
+    uint8_t buffer[65536];
+    size_t bytes_read;
+    while ((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        data.insert(data.end(), buffer, buffer + bytes_read);
+
+    fclose(file);
+    return data;
+}
+
+size_t parse_in_chunks(const std::vector<uint8_t> &stream, size_t chunk)
+{
+    GNSSParser parser;
+    size_t messages = 0;
+    size_t pos = 0;
+
+    while (pos < stream.size())
+    {
+        while (parser.available())
+        {
+            parser.getMessage();
+            messages++;
+        }
+
+        size_t to_write = std::min(std::min(chunk, parser.available_write_space()), stream.size() - pos);
+        parser.encode(&stream[pos], to_write);
+        pos += to_write;
+    }
+
+    while (parser.available())
+    {
+        parser.getMessage();
+        messages++;
+    }
+
+    return messages;
+}
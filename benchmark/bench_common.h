@@ -0,0 +1,27 @@
+#ifndef __BENCH_COMMON_H__
+#define __BENCH_COMMON_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// Monotonic wall clock in nanoseconds
+uint64_t bench_now_ns();
+
+// Appends a valid NMEA sentence of exactly `length` bytes (including "\r\n")
+void append_nmea_sentence(std::vector<uint8_t> &stream, size_t length);
+
+// Appends a valid RTCM3 frame with the given message number and payload length
+void append_rtcm3_frame(std::vector<uint8_t> &stream, uint16_t message_number, size_t payload_length);
+
+// Appends a valid UBX frame with the given class, ID and payload length
+void append_ubx_frame(std::vector<uint8_t> &stream, uint8_t message_class, uint8_t id, size_t payload_length);
+
+// Reads a whole file, returns an empty vector if it cannot be opened
+std::vector<uint8_t> load_file(const char *path);
+
+// Feeds the stream through encode(buffer, length) in chunks of at most
+// `chunk` bytes, draining messages as they appear. Returns the message count.
+size_t parse_in_chunks(const std::vector<uint8_t> &stream, size_t chunk);
+
+#endif // __BENCH_COMMON_H__
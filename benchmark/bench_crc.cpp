@@ -0,0 +1,40 @@
+#include <stdio.h>
+#include <vector>
+#include "GNSSCRC24Q.h"
+#include "bench_common.h"
+
+typedef uint32_t (*CRCFunction)(uint32_t crc, const uint8_t *data, size_t length);
+
+static const size_t TOTAL_BYTES = 256 * 1024 * 1024;
+
+static void bench_engine(const char *name, CRCFunction function, const std::vector<uint8_t> &data, size_t block)
+{
+    size_t iterations = TOTAL_BYTES / block;
+    uint32_t crc = 0;
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < iterations; i++)
+        crc ^= function(crc, &data[(i * 64) % (data.size() - block)], block);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    double gbps = static_cast<double>(iterations * block) / elapsed;
+    printf("CRC-24Q %-12s %6zu byte blocks  %7.2f GB/s  (%06X)\n", name, block, gbps, crc);
+}
+
+void run_crc_benchmarks()
+{
+    printf("\nCRC-24Q engines (selected: %d)\n", GNSSCRC24Q::engine());
+
+    std::vector<uint8_t> data(128 * 1024);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (i * 2654435761u) >> 24;
+
+    const size_t blocks[] = {64, 256, 1029, 65536};
+    for (size_t block : blocks)
+    {
+        bench_engine("table", GNSSCRC24Q::updateTable, data, block);
+        bench_engine("slicing-by-8", GNSSCRC24Q::updateSlicingBy8, data, block);
+        if (GNSSCRC24Q::clmulSupported())
+            bench_engine("clmul", GNSSCRC24Q::updateClmul, data, block);
+    }
+}
@@ -0,0 +1,6 @@
+#ifndef __BENCH_CRC_H__
+#define __BENCH_CRC_H__
+
+void run_crc_benchmarks();
+
+#endif // __BENCH_CRC_H__
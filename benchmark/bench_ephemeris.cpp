@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "GNSSEphemeris.h"
+#include "bench_common.h"
+
+static const double TIME = 345600 + 600;
+
+// Ten minutes past the GLONASS reference time tb = 41 * 900 s Moscow time
+static const double GLONASS_TIME = 345600 + 41 * 900 - 3 * 3600 + 18 + 600;
+
+// Satellites spread over six planes, the orbit size of the system
+static GNSSKeplerEphemeris orbit(GNSSSystem::Type system, uint8_t prn, double sqrt_a)
+{
+    GNSSKeplerEphemeris eph = {};
+    eph.system = system;
+    eph.prn = prn;
+    eph.iode = 1;
+    eph.toe = eph.toc = system == GNSSSystem::BEIDOU ? 345600 - 14 : 345600;
+    eph.af0 = 1e-5 * prn;
+    eph.af1 = -1e-12;
+    eph.sqrt_a = sqrt_a;
+    eph.e = 0.001 + 0.0002 * (prn % 50);
+    eph.m0 = prn * 0.7;
+    eph.delta_n = 4e-9;
+    eph.omega0 = (prn % 6) * 1.047;
+    eph.omega_dot = -8e-9;
+    eph.i0 = 0.96;
+    eph.omega = prn * 0.3;
+    eph.cuc = -1e-6;
+    eph.cus = 8e-6;
+    eph.crc = 200;
+    eph.crs = -30;
+    eph.cic = 1e-7;
+    eph.cis = -5e-8;
+    return eph;
+}
+
+static void fill(GNSSEphemerisCache &cache, bool glonass)
+{
+    for (uint8_t prn = 1; prn <= 32; prn++)
+        cache.add(orbit(GNSSSystem::GPS, prn, 5153.6));
+    for (uint8_t prn = 193; prn <= 202; prn++)
+        cache.add(orbit(GNSSSystem::QZSS, prn, 6493.3));
+    for (uint8_t prn = 1; prn <= 36; prn++)
+        cache.add(orbit(GNSSSystem::GALILEO, prn, 5440.6));
+    for (uint8_t prn = 1; prn <= 63; prn++)
+        cache.add(orbit(GNSSSystem::BEIDOU, prn, prn <= 5 || prn >= 59 ? 6493.4 : 5282.6));
+
+    for (uint8_t slot = 1; glonass && slot <= 24; slot++)
+    {
+        GNSSGlonassEphemeris eph = {};
+        eph.slot = slot;
+        eph.tb = 41 * 900;
+        double angle = slot * 0.26;
+        eph.position[0] = 25.5e6 * cos(angle);
+        eph.position[1] = 25.5e6 * sin(angle);
+        eph.velocity[2] = 3950;
+        eph.tau_n = 1e-5;
+        cache.add(eph);
+    }
+}
+
+static void bench_compute(const char *label, bool glonass, double time)
+{
+    static GNSSEphemerisCache cache;
+    static GNSSSatelliteStates states;
+    cache.clear();
+    fill(cache, glonass);
+
+    const int rounds = glonass ? 2000 : 20000;
+    size_t satellites = 0;
+    double checksum = 0;
+
+    uint64_t start = bench_now_ns();
+    for (int round = 0; round < rounds; round++)
+    {
+        satellites += cache.compute(time + round * 1e-3, states);
+        checksum += states.x[round % states.count];
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    printf("Ephemeris compute %-30s %3zu sats  %8.0f sats/ms  %6.1f ns/sat  (%.0f)\n", label, states.count,
+           satellites * 1e6 / elapsed, static_cast<double>(elapsed) / satellites, checksum);
+}
+
+// The same ephemeris sent again and again, as receivers do: decode and
+// compare, nothing recomputed
+static void bench_repeats()
+{
+    static GNSSEphemerisCache cache;
+    cache.clear();
+
+    const uint16_t numbers[] = {1019, 1042, 1045, 1046, 1020};
+    const size_t lengths[] = {61, 64, 62, 63, 45};
+    std::vector<std::vector<uint8_t>> frames;
+    for (size_t i = 0; i < 5; i++)
+    {
+        for (uint8_t prn = 1; prn <= 24; prn++)
+        {
+            std::vector<uint8_t> frame;
+            append_rtcm3_frame(frame, numbers[i], lengths[i]);
+            frame[4] = (frame[4] & 0xF0) | (prn >> 2); // satellite ID at bit 12
+            frame[5] = (frame[5] & 0x3F) | ((prn & 3) << 6);
+            frames.push_back(frame);
+        }
+    }
+
+    const size_t total = 2000000;
+    size_t updated = 0;
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < total; i++)
+    {
+        const std::vector<uint8_t> &frame = frames[i % frames.size()];
+        updated += cache.add(frame.data(), frame.size()) == GNSSEphemerisCache::UPDATED;
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    printf("Ephemeris repeats %-30s %7.2f M msgs/s  %6.1f ns/msg  (%zu updated, %zu cached)\n",
+           "1019/1042/1045/1046/1020", total * 1e3 / elapsed, static_cast<double>(elapsed) / total, updated,
+           cache.size());
+}
+
+void run_ephemeris_benchmarks()
+{
+    printf("\nBroadcast ephemeris cache and batch satellite positions\n");
+
+    bench_compute("GPS+QZSS+Galileo+BeiDou", false, TIME);
+    bench_compute("all, GLONASS 10 min from tb", true, GLONASS_TIME);
+    bench_repeats();
+}
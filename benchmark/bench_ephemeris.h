@@ -0,0 +1,6 @@
+#ifndef __BENCH_EPHEMERIS_H__
+#define __BENCH_EPHEMERIS_H__
+
+void run_ephemeris_benchmarks();
+
+#endif // __BENCH_EPHEMERIS_H__
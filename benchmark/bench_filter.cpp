@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <vector>
+#include "GNSSParser.h"
+#include "GNSSRTCM3.h"
+#include "bench_common.h"
+
+static const size_t STREAM_BYTES = 8 * 1024 * 1024;
+static const int ROUNDS = 3;
+
+// MSM7 epochs of four constellations with a station position and an NMEA
+// sentence each; the consumer only wants the position
+static std::vector<uint8_t> make_stream()
+{
+    const uint16_t numbers[] = {1077, 1087, 1097, 1127};
+    std::vector<uint8_t> stream;
+    size_t epoch = 0;
+    while (stream.size() < STREAM_BYTES)
+    {
+        for (uint16_t number : numbers)
+            append_rtcm3_frame(stream, number, 300 + (epoch * 97 + number) % 300);
+        append_rtcm3_frame(stream, 1005, 19);
+        append_nmea_sentence(stream, 72);
+        epoch++;
+    }
+    return stream;
+}
+
+// Drains the queue as a consumer would, keeping 1005 only
+static size_t run(const std::vector<uint8_t> &stream, const GNSSMessageFilter *filter)
+{
+    static GNSSParser parser;
+    parser.clear();
+    parser.setFilter(filter);
+
+    GNSSParser::MessageView views[16];
+    size_t kept = 0;
+    size_t pos = 0;
+    while (pos < stream.size())
+    {
+        pos += parser.encode_stream(stream.data() + pos, stream.size() - pos);
+        size_t count;
+        while ((count = parser.peekMessages(views, 16)) > 0)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                if (views[i].type == GNSSParserBase::Message::Type::RTCM3 &&
+                    GNSSRTCM3Header(views[i]).messageNumber() == 1005)
+                    kept++;
+            }
+            parser.release(count);
+        }
+    }
+    return kept;
+}
+
+static void measure(const char *name, const std::vector<uint8_t> &stream, const GNSSMessageFilter *filter)
+{
+    uint64_t best = UINT64_MAX;
+    size_t kept = 0;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        uint64_t start = bench_now_ns();
+        kept = run(stream, filter);
+        uint64_t elapsed = bench_now_ns() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    printf("%-32s %8.1f MB/s  (%zu kept)\n", name, stream.size() * 1e3 / best, kept);
+}
+
+void run_filter_benchmarks()
+{
+    printf("\nMessage filter (1005 wanted out of MSM7 epochs)\n");
+
+    std::vector<uint8_t> stream = make_stream();
+
+    measure("No filter, consumer discards", stream, nullptr);
+
+    GNSSMessageFilter filter;
+    filter.allowRTCM3(1005);
+    filter.blockNMEA();
+    measure("Filter, rejected frames checked", stream, &filter);
+
+    filter.setSkipRejected(true);
+    measure("Filter, rejected frames skipped", stream, &filter);
+}
@@ -0,0 +1,6 @@
+#ifndef __BENCH_FILTER_H__
+#define __BENCH_FILTER_H__
+
+void run_filter_benchmarks();
+
+#endif // __BENCH_FILTER_H__
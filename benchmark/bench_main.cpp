@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <string.h>
+#include "bench_scanner.h"
+#include "bench_crc.h"
+#include "bench_resync.h"
+#include "bench_spsc.h"
+#include "bench_pool.h"
+#include "bench_chunked.h"
+#include "bench_msm.h"
+#include "bench_ephemeris.h"
+#include "bench_station.h"
+#include "bench_nmea.h"
+#include "bench_filter.h"
+#include "bench_ubx.h"
+#include "bench_suite.h"
+
+// Usage: benchmark [--suite] [--json <path>]
+//   --suite        run only the capture / synthetic stream suite
+//   --json <path>  also write the suite results as JSON ("-" for stdout)
+int main(int argc, char **argv)
+{
+    bool suite_only = false;
+    const char *json_path = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--suite") == 0)
+        {
+            suite_only = true;
+        }
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            json_path = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--suite] [--json <path>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (!suite_only)
+    {
+        run_scanner_benchmarks();
+        run_crc_benchmarks();
+        run_resync_benchmarks();
+        run_spsc_benchmarks();
+        run_pool_benchmarks();
+        run_chunked_benchmarks();
+        run_msm_benchmarks();
+        run_ephemeris_benchmarks();
+        run_station_benchmarks();
+        run_nmea_benchmarks();
+        run_filter_benchmarks();
+        run_ubx_benchmarks();
+    }
+
+    run_suite_benchmarks(json_path);
+    return 0;
+}
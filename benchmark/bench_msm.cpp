@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <vector>
+#include "GNSSEpochAssembler.h"
+#include "GNSSMSM.h"
+#include "bench_common.h"
+
+static const size_t TOTAL_MESSAGES = 2000000;
+
+typedef std::vector<std::vector<uint8_t>> Frames;
+
+// MSMs of a capture, framed by the parser
+static Frames capture_msms(const char *capture)
+{
+    Frames frames;
+    std::vector<uint8_t> data = load_file(capture);
+
+    GNSSParser parser;
+    parser.encode_to(data.data(), data.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                     {
+                         if (valid && view.type == GNSSParser::Message::Type::RTCM3 && GNSSRTCM3Header(view).isMSM())
+                         {
+                             frames.push_back(std::vector<uint8_t>(view.length()));
+                             view.copyTo(frames.back().data());
+                         }
+                     });
+    return frames;
+}
+
+// A full MSM: 16 satellites, 4 signals, all 64 cells, arbitrary observables
+static std::vector<uint8_t> full_msm(uint16_t number)
+{
+    unsigned type = number % 10;
+    bool extended = type == 5 || type == 7;
+    bool fine = type >= 6;
+    size_t satellite_bits = extended ? 8 + 4 + 10 + 14 : 8 + 10;
+    size_t cell_bits = fine ? 20 + 24 + 10 + 1 + 10 : 15 + 22 + 4 + 1 + 6;
+    if (extended)
+        cell_bits += 15;
+
+    size_t bits = 169 + 64 + 16 * satellite_bits + 64 * cell_bits;
+    std::vector<uint8_t> payload((bits + 7) / 8);
+    for (size_t i = 0; i < payload.size(); i++)
+        payload[i] = (i * 2654435761u) >> 24;
+
+    // Message number, then the masks at bit 73
+    payload[0] = number >> 4;
+    payload[1] = (payload[1] & 0x0F) | ((number & 0x0F) << 4);
+    uint8_t masks[] = {0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, // satellites 17-32
+                       0x61, 0x01, 0x00, 0x00,                         // signals 2, 3, 8, 16
+                       0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}; // cells
+    for (size_t i = 0; i < sizeof(masks) * 8; i++)
+    {
+        size_t bit = 73 + i;
+        uint8_t value = (masks[i / 8] >> (7 - i % 8)) & 1;
+        payload[bit / 8] = (payload[bit / 8] & ~(0x80 >> (bit % 8))) | (value << (7 - bit % 8));
+    }
+
+    std::vector<uint8_t> frame = {0xD3, uint8_t(payload.size() >> 8), uint8_t(payload.size() & 0xFF)};
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    uint32_t crc = GNSSCRC24Q::calculate(frame.data(), frame.size());
+    frame.push_back(crc >> 16);
+    frame.push_back(crc >> 8);
+    frame.push_back(crc);
+    return frame;
+}
+
+static void bench_decode(const char *label, const Frames &frames)
+{
+    if (frames.empty())
+    {
+        printf("MSM decode %-28s no frames\n", label);
+        return;
+    }
+
+    GNSSMSMObservations obs;
+    size_t cells = 0;
+    size_t failures = 0;
+    double checksum = 0;
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < TOTAL_MESSAGES; i++)
+    {
+        const std::vector<uint8_t> &frame = frames[i % frames.size()];
+        if (!GNSSMSMDecoder::decode(frame.data(), frame.size(), obs))
+        {
+            failures++;
+            continue;
+        }
+        cells += obs.cell_count;
+        checksum += obs.cnr[0];
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    printf("MSM decode %-28s %7.2f M msgs/s  %7.1f M cells/s  %6.1f ns/msg  (%zu failed, %.0f)\n", label,
+           TOTAL_MESSAGES * 1e3 / elapsed, cells * 1e3 / elapsed, static_cast<double>(elapsed) / TOTAL_MESSAGES,
+           failures, checksum);
+}
+
+// Whole stream through the parser and the epoch assembler, with the latency
+// from an epoch's last message to its hand-over
+static void bench_epochs(const char *capture)
+{
+    std::vector<uint8_t> data = load_file(capture);
+    if (data.empty())
+    {
+        printf("Cannot open %s, run from the repository root\n", capture);
+        return;
+    }
+
+    const int rounds = 20;
+    GNSSEpochAssembler assembler;
+    size_t epochs = 0;
+    auto count = [&](const GNSSEpoch &)
+    { epochs++; };
+
+    uint64_t start = bench_now_ns();
+    for (int round = 0; round < rounds; round++)
+    {
+        GNSSParser parser;
+        parser.encode_to(data.data(), data.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                         {
+                             if (valid)
+                                 assembler.add(view, count);
+                         });
+        assembler.flush(count);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    const GNSSEpochAssembler::Latency &latency = assembler.latency();
+    printf("Epoch assembly %-24s %7.3f M epochs/s  %7.1f MB/s  latency mean %.0f ns, max %llu ns\n",
+           capture + sizeof("test/test-data/") - 1, epochs * 1e3 / elapsed, data.size() * rounds * 1e3 / elapsed,
+           latency.mean_ns(), static_cast<unsigned long long>(latency.max_ns));
+}
+
+void run_msm_benchmarks()
+{
+    printf("\nMSM decoding into structure-of-arrays observations\n");
+
+    bench_decode("capture 33816-2193 (MSM4)", capture_msms("test/test-data/test-data-33816-2193.bin"));
+
+    const uint16_t numbers[] = {1074, 1075, 1077};
+    for (uint16_t number : numbers)
+    {
+        char label[32];
+        snprintf(label, sizeof(label), "%u, 16 sats x 4 signals", number);
+        bench_decode(label, Frames(1, full_msm(number)));
+    }
+
+    bench_epochs("test/test-data/test-data-33816-2193.bin");
+}
@@ -0,0 +1,6 @@
+#ifndef __BENCH_MSM_H__
+#define __BENCH_MSM_H__
+
+void run_msm_benchmarks();
+
+#endif // __BENCH_MSM_H__
@@ -0,0 +1,130 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GNSSNMEA.h"
+#include "bench_common.h"
+
+static const size_t TOTAL_SENTENCES = 2000000;
+
+// The decodable sentences of a multi-GNSS receiver's epoch
+static const char *SENTENCES[] = {
+    "$GNGGA,140656.00,4430.39666339,N,02600.98986769,E,7,17,1.0,89.7706,M,35.4899,M,,*42\r\n",
+    "$GNRMC,140656.00,A,4430.39666339,N,02600.98986769,E,0.006,221.9,070125,6.1,E,M,S*5C\r\n",
+    "$GNGSA,M,3,24,28,29,31,32,,,,,,,,1.5,1.0,1.1,1*3C\r\n",
+    "$GNGSA,M,3,67,77,86,87,,,,,,,,,1.5,1.0,1.1,2*3B\r\n",
+    "$GNGSA,M,3,13,19,21,,,,,,,,,,1.5,1.0,1.1,3*33\r\n",
+    "$GNGSA,M,3,23,25,28,37,43,,,,,,,,1.5,1.0,1.1,4*32\r\n",
+    "$GNVTG,221.9,T,215.8,M,0.006,N,0.011,K,M*2B\r\n",
+    "$GNGST,140656.00,0.52,0.012,0.009,87.2,0.010,0.011,0.021*4F\r\n",
+};
+static const size_t SENTENCE_COUNT = sizeof(SENTENCES) / sizeof(SENTENCES[0]);
+
+static double baseline_coordinate(const char *text)
+{
+    double value = strtod(text, nullptr);
+    double degrees = floor(value / 100);
+    return degrees + (value - degrees * 100) / 60;
+}
+
+// What we did before: strtok over a copy, strtod per field. strtok merges
+// empty fields, so indices after one are off; only the cost is compared.
+static double baseline_decode(const char *sentence)
+{
+    char copy[GNSSParserBase::MAX_NMEA_LENGTH + 1];
+    strncpy(copy, sentence, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = '\0';
+
+    const char *tokens[GNSSNMEAFields::MAX_FIELDS];
+    size_t count = 0;
+    for (char *token = strtok(copy, ",*"); token && count < GNSSNMEAFields::MAX_FIELDS; token = strtok(nullptr, ",*"))
+        tokens[count++] = token;
+
+    double sum = 0;
+    const char *type = count ? tokens[0] + 3 : "";
+    if (!strcmp(type, "GGA") && count >= 12)
+    {
+        sum += strtod(tokens[1], nullptr) + baseline_coordinate(tokens[2]) + baseline_coordinate(tokens[4]);
+        sum += atoi(tokens[6]) + atoi(tokens[7]) + strtod(tokens[8], nullptr) + strtod(tokens[9], nullptr) +
+               strtod(tokens[11], nullptr);
+    }
+    else if (!strcmp(type, "RMC") && count >= 13)
+    {
+        sum += strtod(tokens[1], nullptr) + baseline_coordinate(tokens[3]) + baseline_coordinate(tokens[5]);
+        sum += strtod(tokens[7], nullptr) + strtod(tokens[8], nullptr) + atoi(tokens[9]) + strtod(tokens[10], nullptr);
+    }
+    else
+    {
+        for (size_t i = 1; i < count; i++)
+            sum += strtod(tokens[i], nullptr);
+    }
+    return sum;
+}
+
+static double fields_decode(const char *sentence, size_t length)
+{
+    GNSSNMEAFields fields(sentence, length);
+    GNSSNMEAGGA gga;
+    GNSSNMEARMC rmc;
+    GNSSNMEAGSA gsa;
+    GNSSNMEAVTG vtg;
+    GNSSNMEAGST gst;
+    if (GNSSNMEADecoder::decode(fields, gga))
+        return gga.time + gga.latitude + gga.longitude + gga.altitude;
+    if (GNSSNMEADecoder::decode(fields, rmc))
+        return rmc.time + rmc.latitude + rmc.longitude + rmc.speed;
+    if (GNSSNMEADecoder::decode(fields, gsa))
+        return gsa.pdop + gsa.satellite_count;
+    if (GNSSNMEADecoder::decode(fields, vtg))
+        return vtg.course + vtg.speed_kmh;
+    if (GNSSNMEADecoder::decode(fields, gst))
+        return gst.rms + gst.latitude_sigma;
+    return 0;
+}
+
+void run_nmea_benchmarks()
+{
+    printf("\nNMEA field decoding (GGA, RMC, GSA, VTG, GST)\n");
+
+    size_t lengths[SENTENCE_COUNT];
+    for (size_t i = 0; i < SENTENCE_COUNT; i++)
+        lengths[i] = strlen(SENTENCES[i]);
+
+    volatile double sink = 0;
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < TOTAL_SENTENCES; i++)
+        sink = sink + baseline_decode(SENTENCES[i % SENTENCE_COUNT]);
+    uint64_t baseline = bench_now_ns() - start;
+    printf("strtok + strtod                  %7.2f M sentences/s  %6.1f ns/sentence\n",
+           TOTAL_SENTENCES * 1e3 / baseline, static_cast<double>(baseline) / TOTAL_SENTENCES);
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < TOTAL_SENTENCES; i++)
+        sink = sink + fields_decode(SENTENCES[i % SENTENCE_COUNT], lengths[i % SENTENCE_COUNT]);
+    uint64_t elapsed = bench_now_ns() - start;
+    printf("GNSSNMEAFields + typed decoders  %7.2f M sentences/s  %6.1f ns/sentence  (%.1fx)\n",
+           TOTAL_SENTENCES * 1e3 / elapsed, static_cast<double>(elapsed) / TOTAL_SENTENCES,
+           static_cast<double>(baseline) / elapsed);
+
+    // Number conversion alone, over every field of the GGA sentence
+    GNSSNMEAFields fields(SENTENCES[0], lengths[0]);
+    char texts[GNSSNMEAFields::MAX_FIELDS][GNSSParserBase::MAX_NMEA_LENGTH];
+    for (size_t f = 0; f < fields.count(); f++)
+    {
+        memcpy(texts[f], fields.field(f).data, fields.field(f).length);
+        texts[f][fields.field(f).length] = '\0';
+    }
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < TOTAL_SENTENCES; i++)
+        sink = sink + strtod(texts[1 + i % (fields.count() - 1)], nullptr);
+    baseline = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < TOTAL_SENTENCES; i++)
+        sink = sink + fields.number(1 + i % (fields.count() - 1));
+    elapsed = bench_now_ns() - start;
+    printf("Number fields: strtod %5.1f ns, GNSSNMEAFields::number %5.1f ns  (%.1fx)\n",
+           static_cast<double>(baseline) / TOTAL_SENTENCES, static_cast<double>(elapsed) / TOTAL_SENTENCES,
+           static_cast<double>(baseline) / elapsed);
+}
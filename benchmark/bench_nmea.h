@@ -0,0 +1,6 @@
+#ifndef __BENCH_NMEA_H__
+#define __BENCH_NMEA_H__
+
+void run_nmea_benchmarks();
+
+#endif // __BENCH_NMEA_H__
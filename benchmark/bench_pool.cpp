@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <vector>
+#include "GNSSParserPool.h"
+#include "bench_common.h"
+
+static const size_t STREAMS = 256;
+static const size_t BATCH = 1024;
+static const size_t BYTES_PER_STREAM = 1024 * 1024;
+
+static const char *CAPTURES[] = {
+    "test/test-data/test-data-5-2.bin",
+    "test/test-data/test-data-56-5.bin",
+    "test/test-data/test-data-656-43.bin",
+    "test/test-data/test-data-33816-2193.bin",
+};
+
+struct CountingSink
+{
+    std::vector<size_t> *frames;
+
+    void operator()(size_t stream_id, const GNSSParserBase::MessageView &, bool valid) const
+    {
+        (*frames)[stream_id] += valid;
+    }
+};
+
+// Every stream replays one capture in BATCH sized submissions, streams
+// interleaved the way packets from many stations arrive
+static void bench_workers(const std::vector<std::vector<uint8_t>> &captures, size_t workers)
+{
+    std::vector<size_t> frames(STREAMS, 0);
+    CountingSink sink = {&frames};
+    std::vector<size_t> positions(STREAMS, 0);
+    size_t bytes = 0;
+
+    uint64_t start = bench_now_ns();
+    {
+        GNSSParserPool<CountingSink> pool(STREAMS, sink, workers);
+
+        while (bytes < STREAMS * BYTES_PER_STREAM)
+        {
+            for (size_t id = 0; id < STREAMS; id++)
+            {
+                // Loop over the capture, cutting batches at its end
+                const std::vector<uint8_t> &capture = captures[id % captures.size()];
+                size_t length = std::min(BATCH, capture.size() - positions[id]);
+                pool.submit(id, &capture[positions[id]], length);
+                positions[id] = (positions[id] + length) % capture.size();
+                bytes += length;
+            }
+        }
+
+        pool.wait();
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    size_t messages = 0;
+    for (size_t count : frames)
+        messages += count;
+
+    printf("Pool %2zu workers  %3zu streams  %7.1f MB  %7.3f GB/s  %6.2f M msgs/s\n", workers, STREAMS,
+           bytes / 1e6, static_cast<double>(bytes) / elapsed, messages * 1e3 / elapsed);
+}
+
+void run_pool_benchmarks()
+{
+    printf("\nParser pool scaling, %zu streams replaying the test captures\n", STREAMS);
+
+    std::vector<std::vector<uint8_t>> captures;
+    for (const char *capture : CAPTURES)
+    {
+        std::vector<uint8_t> data = load_file(capture);
+        if (data.empty())
+        {
+            printf("Cannot open %s, run from the repository root\n", capture);
+            return;
+        }
+        captures.push_back(data);
+    }
+
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t workers = 1; workers <= cores; workers *= 2)
+    {
+        bench_workers(captures, workers);
+        if (workers < cores && workers * 2 > cores)
+            bench_workers(captures, cores);
+    }
+}
@@ -0,0 +1,6 @@
+#ifndef __BENCH_POOL_H__
+#define __BENCH_POOL_H__
+
+void run_pool_benchmarks();
+
+#endif // __BENCH_POOL_H__
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "GNSSSyncSearch.h"
+#include "bench_common.h"
+
+typedef size_t (*FindFunction)(const uint8_t *data, size_t length, const GNSSSyncSearch::Set &set);
+
+static const char *CAPTURES[] = {
+    "test/test-data/test-data-5-2.bin",
+    "test/test-data/test-data-56-5.bin",
+    "test/test-data/test-data-656-43.bin",
+    "test/test-data/test-data-33816-2193.bin",
+};
+
+// Binary noise with no byte that could start a frame, like a UBX/SBF burst
+// that happens to contain no preamble
+static void append_clean_noise(std::vector<uint8_t> &stream, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t c = rand() & 0xFF;
+        stream.push_back(GNSSSyncSearch::isSyncByte(c) ? c ^ 0x01 : c);
+    }
+}
+
+static void bench_find(const char *name, FindFunction function, const std::vector<uint8_t> &noise)
+{
+    const int rounds = 8;
+    size_t found = 0;
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < rounds; i++)
+        found += function(&noise[0], noise.size(), GNSSSyncSearch::FRAME_STARTS);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    printf("Sync search %-7s %7.2f GB/s  (%zu)\n", name,
+           static_cast<double>(noise.size()) * rounds / elapsed, found);
+}
+
+static void bench_parser_over_noise(const char *label, const std::vector<uint8_t> &stream)
+{
+    uint64_t start = bench_now_ns();
+    size_t messages = parse_in_chunks(stream, 4096);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    printf("Parser resync %-28s %8.1f MB  %7.3f GB/s  %zu msgs\n", label,
+           stream.size() / 1e6, static_cast<double>(stream.size()) / elapsed, messages);
+}
+
+void run_resync_benchmarks()
+{
+    printf("\nResynchronisation over garbage (sync search engine: %d)\n", GNSSSyncSearch::engine());
+    srand(2024);
+
+    std::vector<uint8_t> noise;
+    append_clean_noise(noise, 64 * 1024 * 1024);
+
+    bench_find("scalar", GNSSSyncSearch::findScalar, noise);
+    bench_find("sse2", GNSSSyncSearch::findSSE2, noise);
+    if (GNSSSyncSearch::supported(GNSSSyncSearch::AVX2))
+        bench_find("avx2", GNSSSyncSearch::findAVX2, noise);
+    if (GNSSSyncSearch::supported(GNSSSyncSearch::NEON))
+        bench_find("neon", GNSSSyncSearch::findNEON, noise);
+
+    // Captures with a binary burst injected after every 4 KiB of real data
+    for (const char *capture : CAPTURES)
+    {
+        std::vector<uint8_t> data = load_file(capture);
+        if (data.empty())
+        {
+            printf("Cannot open %s, run from the repository root\n", capture);
+            continue;
+        }
+
+        std::vector<uint8_t> stream;
+        while (stream.size() < 64 * 1024 * 1024)
+        {
+            for (size_t pos = 0; pos < data.size(); pos += 4096)
+            {
+                size_t end = std::min(pos + 4096, data.size());
+                stream.insert(stream.end(), data.begin() + pos, data.begin() + end);
+                append_clean_noise(stream, 32 * 1024);
+            }
+        }
+
+        bench_parser_over_noise(capture + sizeof("test/test-data/") - 1, stream);
+    }
+}
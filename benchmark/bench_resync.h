@@ -0,0 +1,6 @@
+#ifndef __BENCH_RESYNC_H__
+#define __BENCH_RESYNC_H__
+
+void run_resync_benchmarks();
+
+#endif // __BENCH_RESYNC_H__
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <vector>
+#include "GNSSParser.h"
+#include "bench_common.h"
+
+static const size_t STREAM_BYTES = 8 * 1024 * 1024;
+
+// Feeds the stream one byte at a time and returns nanoseconds per byte
+static double feed_byte_at_a_time(const std::vector<uint8_t> &stream, size_t &messages)
+{
+    GNSSParser parser;
+    messages = 0;
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < stream.size(); i++)
+    {
+        parser.encode(stream[i]);
+        while (parser.available())
+        {
+            parser.getMessage();
+            messages++;
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    return static_cast<double>(elapsed) / stream.size();
+}
+
+static void bench_nmea_length(size_t length)
+{
+    std::vector<uint8_t> stream;
+    while (stream.size() < STREAM_BYTES)
+        append_nmea_sentence(stream, length);
+
+    size_t messages;
+    double ns_per_byte = feed_byte_at_a_time(stream, messages);
+    printf("NMEA  %5zu bytes/msg  %8zu msgs  %6.2f ns/byte\n", length, messages, ns_per_byte);
+}
+
+static void bench_rtcm3_length(size_t payload_length)
+{
+    std::vector<uint8_t> stream;
+    while (stream.size() < STREAM_BYTES)
+        append_rtcm3_frame(stream, 1077, payload_length);
+
+    size_t messages;
+    double ns_per_byte = feed_byte_at_a_time(stream, messages);
+    printf("RTCM3 %5zu bytes/msg  %8zu msgs  %6.2f ns/byte\n", payload_length + 6, messages, ns_per_byte);
+}
+
+static void bench_bulk(const char *capture)
+{
+    std::vector<uint8_t> data = load_file(capture);
+    if (data.empty())
+    {
+        printf("Cannot open %s, run from the repository root\n", capture);
+        return;
+    }
+
+    std::vector<uint8_t> stream;
+    while (stream.size() < 8 * STREAM_BYTES)
+        stream.insert(stream.end(), data.begin(), data.end());
+
+    uint64_t start = bench_now_ns();
+    size_t chunked = parse_in_chunks(stream, 4096);
+    uint64_t chunked_ns = bench_now_ns() - start;
+
+    GNSSParser parser;
+    size_t streamed = 0;
+    start = bench_now_ns();
+    parser.encode_stream(&stream[0], stream.size(), [&](const GNSSParser::MessageView &)
+                         { streamed++; });
+    uint64_t streamed_ns = bench_now_ns() - start;
+
+    GNSSParser push_parser;
+    size_t pushed = 0;
+    start = bench_now_ns();
+    push_parser.encode_to(&stream[0], stream.size(), [&](const GNSSParser::MessageView &, bool valid)
+                          { pushed += valid; });
+    uint64_t pushed_ns = bench_now_ns() - start;
+
+    printf("%-28s %6.1f MB  4 KiB chunks %7.3f GB/s (%zu)  encode_stream %7.3f GB/s (%zu)  encode_to %7.3f GB/s (%zu)\n",
+           capture + sizeof("test/test-data/") - 1, stream.size() / 1e6,
+           static_cast<double>(stream.size()) / chunked_ns, chunked,
+           static_cast<double>(stream.size()) / streamed_ns, streamed,
+           static_cast<double>(stream.size()) / pushed_ns, pushed);
+}
+
+void run_scanner_benchmarks()
+{
+    printf("\nByte-at-a-time encode(), per-byte cost by message length\n");
+
+    const size_t nmea_lengths[] = {16, 32, 64, 96, 128};
+    for (size_t length : nmea_lengths)
+        bench_nmea_length(length);
+
+    const size_t rtcm3_lengths[] = {8, 64, 256, 512, 1023};
+    for (size_t length : rtcm3_lengths)
+        bench_rtcm3_length(length);
+
+    printf("\nBulk input, whole capture in one encode_stream() / encode_to() call\n");
+
+    const char *captures[] = {
+        "test/test-data/test-data-656-43.bin",
+        "test/test-data/test-data-33816-2193.bin",
+    };
+    for (const char *capture : captures)
+        bench_bulk(capture);
+}
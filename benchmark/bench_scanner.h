@@ -0,0 +1,6 @@
+#ifndef __BENCH_SCANNER_H__
+#define __BENCH_SCANNER_H__
+
+void run_scanner_benchmarks();
+
+#endif // __BENCH_SCANNER_H__
@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GNSSConcurrentParser.h"
+#include "bench_common.h"
+
+static const size_t SENTENCES = 1000000;
+static const size_t SENTENCES_PER_CHUNK = 16;
+
+// "$GPSEQ,<10 digit sequence>,<filler>*hh\r\n", 72 bytes each
+static std::vector<uint8_t> make_sequenced_stream()
+{
+    std::vector<uint8_t> stream;
+    char sentence[80];
+
+    for (size_t seq = 0; seq < SENTENCES; seq++)
+    {
+        int length = snprintf(sentence, sizeof(sentence), "$GPSEQ,%010zu,0123456789012345678901234567890123456789012345", seq);
+        uint8_t checksum = 0;
+        for (int i = 1; i < length; i++)
+            checksum ^= sentence[i];
+        length += snprintf(sentence + length, sizeof(sentence) - length, "*%02X\r\n", checksum);
+        stream.insert(stream.end(), sentence, sentence + length);
+    }
+
+    return stream;
+}
+
+static size_t sequence_of(const uint8_t *message)
+{
+    return strtoul(reinterpret_cast<const char *>(message) + 7, nullptr, 10);
+}
+
+struct Result
+{
+    uint64_t elapsed_ns;
+    size_t messages;
+    std::vector<uint64_t> latencies;
+};
+
+static void report(const char *label, size_t bytes, Result &result)
+{
+    std::sort(result.latencies.begin(), result.latencies.end());
+    size_t n = result.latencies.size();
+
+    printf("%-22s %7.3f GB/s  %6.2f M msgs/s  latency p50 %7.2f us  p99 %8.2f us  (%zu msgs)\n", label,
+           static_cast<double>(bytes) / result.elapsed_ns,
+           result.messages * 1e3 / result.elapsed_ns,
+           n ? result.latencies[n / 2] / 1e3 : 0.0,
+           n ? result.latencies[n * 99 / 100] / 1e3 : 0.0,
+           result.messages);
+}
+
+// Producer side shared by both variants: stamps each chunk, then pushes it
+// through `push`, which returns the number of bytes taken
+template <class Push>
+static void produce(const std::vector<uint8_t> &stream, std::vector<uint64_t> &stamps, Push push)
+{
+    size_t chunk_bytes = stream.size() / SENTENCES * SENTENCES_PER_CHUNK;
+
+    for (size_t chunk = 0; chunk * chunk_bytes < stream.size(); chunk++)
+    {
+        size_t pos = chunk * chunk_bytes;
+        size_t end = std::min(pos + chunk_bytes, stream.size());
+        stamps[chunk] = bench_now_ns();
+
+        while (pos < end)
+        {
+            size_t consumed = push(&stream[pos], end - pos);
+            if (consumed == 0)
+                std::this_thread::yield();
+            pos += consumed;
+        }
+    }
+}
+
+static Result run_mutex(const std::vector<uint8_t> &stream)
+{
+    GNSSParser parser;
+    std::mutex mutex;
+    std::vector<uint64_t> stamps(SENTENCES / SENTENCES_PER_CHUNK + 1);
+    Result result = {0, 0, std::vector<uint64_t>()};
+    result.latencies.reserve(SENTENCES);
+
+    uint64_t start = bench_now_ns();
+    std::thread producer([&]
+                         { produce(stream, stamps, [&](const uint8_t *data, size_t length)
+                                   {
+                                       std::lock_guard<std::mutex> lock(mutex);
+                                       return parser.encode_stream(data, length); }); });
+
+    while (result.messages < SENTENCES)
+    {
+        bool got = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (parser.available())
+            {
+                GNSSParser::Message msg = parser.getMessage();
+                size_t seq = sequence_of(msg.data);
+                result.latencies.push_back(bench_now_ns() - stamps[seq / SENTENCES_PER_CHUNK]);
+                result.messages++;
+                got = true;
+            }
+        }
+        if (!got)
+            std::this_thread::yield();
+    }
+
+    producer.join();
+    result.elapsed_ns = bench_now_ns() - start;
+    return result;
+}
+
+static Result run_spsc(const std::vector<uint8_t> &stream, bool blocking)
+{
+    GNSSConcurrentParser parser;
+    std::vector<uint64_t> stamps(SENTENCES / SENTENCES_PER_CHUNK + 1);
+    Result result = {0, 0, std::vector<uint64_t>()};
+    result.latencies.reserve(SENTENCES);
+
+    uint64_t start = bench_now_ns();
+    std::thread producer([&]
+                         { produce(stream, stamps, [&](const uint8_t *data, size_t length)
+                                   { return parser.encode_stream(data, length); }); });
+
+    while (result.messages < SENTENCES)
+    {
+        if (blocking)
+            parser.wait();
+        else if (!parser.available())
+            std::this_thread::yield();
+
+        while (parser.available())
+        {
+            GNSSParser::Message msg = parser.getMessage();
+            size_t seq = sequence_of(msg.data);
+            result.latencies.push_back(bench_now_ns() - stamps[seq / SENTENCES_PER_CHUNK]);
+            result.messages++;
+        }
+    }
+
+    producer.join();
+    result.elapsed_ns = bench_now_ns() - start;
+    return result;
+}
+
+void run_spsc_benchmarks()
+{
+    printf("\nReader thread -> consumer thread, %zu sentences in %zu-sentence chunks\n", SENTENCES, SENTENCES_PER_CHUNK);
+
+    std::vector<uint8_t> stream = make_sequenced_stream();
+
+    Result mutex = run_mutex(stream);
+    report("Mutex wrapper", stream.size(), mutex);
+
+    Result spinning = run_spsc(stream, false);
+    report("SPSC, polling", stream.size(), spinning);
+
+    Result blocking = run_spsc(stream, true);
+    report("SPSC, wait()", stream.size(), blocking);
+}
@@ -0,0 +1,6 @@
+#ifndef __BENCH_SPSC_H__
+#define __BENCH_SPSC_H__
+
+void run_spsc_benchmarks();
+
+#endif // __BENCH_SPSC_H__
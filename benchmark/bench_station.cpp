@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <vector>
+#include "GNSSStation.h"
+#include "bench_common.h"
+
+static const size_t TOTAL_MESSAGES = 5000000;
+
+// Station metadata frames of a capture, in stream order
+static std::vector<std::vector<uint8_t>> capture_metadata(const char *capture)
+{
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<uint8_t> data = load_file(capture);
+
+    GNSSParser parser;
+    parser.encode_to(data.data(), data.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                     {
+                         if (valid && view.type == GNSSParser::Message::Type::RTCM3 &&
+                             GNSSStationDecoder::messageBit(GNSSRTCM3Header(view).messageNumber()))
+                         {
+                             frames.push_back(std::vector<uint8_t>(view.length()));
+                             view.copyTo(frames.back().data());
+                         }
+                     });
+    return frames;
+}
+
+static GNSSParserBase::MessageView view_of(const std::vector<uint8_t> &frame)
+{
+    GNSSParserBase::MessageView view = {GNSSParserBase::Message::Type::RTCM3, frame.data(), frame.size(), nullptr, 0};
+    return view;
+}
+
+void run_station_benchmarks()
+{
+    printf("\nReference station metadata (1006 / 1033 repeats)\n");
+
+    std::vector<std::vector<uint8_t>> frames = capture_metadata("test/test-data/test-data-33816-2193.bin");
+    if (frames.empty())
+    {
+        printf("No station metadata frames, run from the repository root\n");
+        return;
+    }
+
+    // Every repeat decoded, as without the cache
+    GNSSStationInfo info;
+    GNSSStationDecoder::reset(info, 0);
+    size_t decoded = 0;
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < TOTAL_MESSAGES; i++)
+        decoded += GNSSStationDecoder::decode(view_of(frames[i % frames.size()]), info);
+    uint64_t elapsed = bench_now_ns() - start;
+    printf("Station decode every frame       %7.2f M msgs/s  %6.1f ns/msg  (%zu decoded)\n",
+           TOTAL_MESSAGES * 1e3 / elapsed, static_cast<double>(elapsed) / TOTAL_MESSAGES, decoded);
+
+    static GNSSStationCache cache;
+    size_t notified = 0;
+    start = bench_now_ns();
+    for (size_t i = 0; i < TOTAL_MESSAGES; i++)
+        cache.add(view_of(frames[i % frames.size()]), [&](const GNSSStationInfo &, uint16_t) { notified++; });
+    elapsed = bench_now_ns() - start;
+    printf("Station cache, repeats skipped   %7.2f M msgs/s  %6.1f ns/msg  (%zu changes)\n",
+           TOTAL_MESSAGES * 1e3 / elapsed, static_cast<double>(elapsed) / TOTAL_MESSAGES, notified);
+}
@@ -0,0 +1,6 @@
+#ifndef __BENCH_STATION_H__
+#define __BENCH_STATION_H__
+
+void run_station_benchmarks();
+
+#endif // __BENCH_STATION_H__
@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "GNSSParser.h"
+#include "bench_common.h"
+
+static const size_t STREAM_BYTES = 8 * 1024 * 1024;
+static const int ROUNDS = 3;
+
+// Local to this file, bench_spsc.cpp has a Result of its own
+namespace
+{
+    struct Dataset
+    {
+        std::string name;
+        std::vector<uint8_t> stream;
+    };
+
+    struct Result
+    {
+        std::string dataset;
+        std::string mode;
+        size_t bytes;
+        size_t messages;
+        uint64_t elapsed_ns;
+    };
+}
+
+// Small deterministic generator, so every run sees the same streams
+static uint32_t next_random(uint32_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static void repeat_to_size(std::vector<uint8_t> &stream, const std::vector<uint8_t> &data)
+{
+    while (stream.size() < STREAM_BYTES)
+        stream.insert(stream.end(), data.begin(), data.end());
+}
+
+// GGA/RMC/GSV-sized sentences with the odd short one
+static void make_nmea_heavy(std::vector<uint8_t> &stream)
+{
+    const size_t lengths[] = {72, 68, 70, 66, 52, 36, 82, 48};
+    uint32_t state = 1;
+    while (stream.size() < STREAM_BYTES)
+        append_nmea_sentence(stream, lengths[next_random(state) % 8]);
+}
+
+// MSM4/MSM7 observations for four constellations, a station position now
+// and then and an NMEA GGA per epoch
+static void make_rtcm_msm_heavy(std::vector<uint8_t> &stream)
+{
+    const uint16_t numbers[] = {1077, 1087, 1097, 1127, 1074, 1084, 1094, 1124};
+    uint32_t state = 2;
+    while (stream.size() < STREAM_BYTES)
+    {
+        for (uint16_t number : numbers)
+            append_rtcm3_frame(stream, number, 120 + next_random(state) % 480);
+        append_rtcm3_frame(stream, 1005, 19);
+        append_nmea_sentence(stream, 72);
+    }
+}
+
+// Valid frames making up a quarter of the stream, random bytes in between.
+// The noise keeps its preamble bytes, so false starts are part of the load.
+static void make_noise_heavy(std::vector<uint8_t> &stream)
+{
+    uint32_t state = 3;
+    while (stream.size() < STREAM_BYTES)
+    {
+        size_t noise = 256 + next_random(state) % 512;
+        for (size_t i = 0; i < noise; i++)
+            stream.push_back(next_random(state) & 0xFF);
+
+        if (next_random(state) & 1)
+            append_nmea_sentence(stream, 72);
+        else
+            append_rtcm3_frame(stream, 1077, 120 + next_random(state) % 120);
+    }
+}
+
+static size_t drain(GNSSParser &parser)
+{
+    GNSSParser::MessageView views[16];
+    size_t messages = 0;
+    size_t count;
+    while ((count = parser.peekMessages(views, 16)) > 0)
+    {
+        parser.release(count);
+        messages += count;
+    }
+    return messages;
+}
+
+static size_t feed_bytes(GNSSParser &parser, const std::vector<uint8_t> &stream)
+{
+    size_t messages = 0;
+    for (size_t i = 0; i < stream.size(); i++)
+    {
+        parser.encode(stream[i]);
+        messages += drain(parser);
+    }
+    return messages;
+}
+
+// Writes chunk sizes from `sizes` in turn, as a UART or socket reader would,
+// limited by the free ring space. Bulk mode is a single huge chunk size.
+static size_t feed_chunks(GNSSParser &parser, const std::vector<uint8_t> &stream, const std::vector<size_t> &sizes)
+{
+    size_t messages = 0;
+    size_t pos = 0;
+    size_t turn = 0;
+
+    while (pos < stream.size())
+    {
+        messages += drain(parser);
+
+        size_t chunk = sizes[turn++ % sizes.size()];
+        size_t space = parser.available_write_space();
+        size_t length = stream.size() - pos;
+        if (length > chunk)
+            length = chunk;
+        if (length > space)
+            length = space;
+
+        parser.encode(&stream[pos], length);
+        pos += length;
+    }
+
+    return messages + drain(parser);
+}
+
+// Mostly short reads with the occasional long one, 1 byte to 2 KiB
+static std::vector<size_t> varied_sizes()
+{
+    std::vector<size_t> sizes;
+    uint32_t state = 4;
+    for (int i = 0; i < 4096; i++)
+    {
+        size_t magnitude = size_t(1) << (next_random(state) % 12);
+        sizes.push_back(magnitude + next_random(state) % magnitude);
+    }
+    return sizes;
+}
+
+static Result run(const Dataset &dataset, const char *mode, const std::vector<size_t> &sizes)
+{
+    Result result = {dataset.name, mode, dataset.stream.size(), 0, UINT64_MAX};
+
+    // Best of a few rounds, each on a fresh parser
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        GNSSParser parser;
+        uint64_t start = bench_now_ns();
+        result.messages = sizes.empty() ? feed_bytes(parser, dataset.stream)
+                                        : feed_chunks(parser, dataset.stream, sizes);
+        uint64_t elapsed = bench_now_ns() - start;
+        if (elapsed < result.elapsed_ns)
+            result.elapsed_ns = elapsed;
+    }
+
+    return result;
+}
+
+static double mb_per_s(const Result &result) { return result.bytes * 1e3 / result.elapsed_ns; }
+static double msgs_per_s(const Result &result) { return result.messages * 1e9 / result.elapsed_ns; }
+static double ns_per_byte(const Result &result) { return static_cast<double>(result.elapsed_ns) / result.bytes; }
+
+static void write_json(const char *path, const std::vector<Result> &results)
+{
+    FILE *file = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!file)
+    {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return;
+    }
+
+    fprintf(file, "{\n  \"stream_bytes\": %zu,\n  \"rounds\": %d,\n  \"stats\": %s,\n  \"parser_bytes\": %zu,\n  \"results\": [\n",
+            STREAM_BYTES, ROUNDS, GNSS_PARSER_STATS ? "true" : "false", sizeof(GNSSParser));
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result &result = results[i];
+        fprintf(file,
+                "    {\"dataset\": \"%s\", \"mode\": \"%s\", \"bytes\": %zu, \"messages\": %zu, "
+                "\"mb_per_s\": %.2f, \"msgs_per_s\": %.0f, \"ns_per_byte\": %.3f}%s\n",
+                result.dataset.c_str(), result.mode.c_str(), result.bytes, result.messages,
+                mb_per_s(result), msgs_per_s(result), ns_per_byte(result),
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    if (file != stdout)
+        fclose(file);
+}
+
+void run_suite_benchmarks(const char *json_path)
+{
+    // Keep stdout clean when the JSON goes there
+    FILE *table = json_path && strcmp(json_path, "-") == 0 ? stderr : stdout;
+    // Compare runs built with and without GNSS_PARSER_STATS to see what the
+    // counters cost; disabled, the parser must not grow by a single byte
+    fprintf(table, "\nSuite: %zu MB per stream, best of %d, counters %s, sizeof(GNSSParser) %zu\n",
+            STREAM_BYTES >> 20, ROUNDS, GNSS_PARSER_STATS ? "on" : "off", sizeof(GNSSParser));
+
+    const char *captures[] = {"5-2", "56-5", "656-43", "33816-2193"};
+    std::vector<Dataset> datasets;
+
+    for (const char *capture : captures)
+    {
+        std::string path = std::string("test/test-data/test-data-") + capture + ".bin";
+        std::vector<uint8_t> data = load_file(path.c_str());
+        if (data.empty())
+        {
+            fprintf(table, "Cannot open %s, run from the repository root\n", path.c_str());
+            continue;
+        }
+
+        datasets.push_back(Dataset());
+        datasets.back().name = std::string("capture-") + capture;
+        repeat_to_size(datasets.back().stream, data);
+    }
+
+    datasets.push_back(Dataset());
+    datasets.back().name = "nmea-heavy";
+    make_nmea_heavy(datasets.back().stream);
+
+    datasets.push_back(Dataset());
+    datasets.back().name = "rtcm-msm-heavy";
+    make_rtcm_msm_heavy(datasets.back().stream);
+
+    datasets.push_back(Dataset());
+    datasets.back().name = "noise-heavy";
+    make_noise_heavy(datasets.back().stream);
+
+    struct Mode
+    {
+        const char *name;
+        std::vector<size_t> sizes; // empty: byte at a time
+    };
+    const Mode modes[] = {
+        {"byte", {}},
+        {"chunk-16", {16}},
+        {"chunk-256", {256}},
+        {"chunk-varied", varied_sizes()},
+        {"bulk", {SIZE_MAX}},
+    };
+
+    std::vector<Result> results;
+    fprintf(table, "%-20s %-13s %10s %10s %12s %9s\n", "dataset", "mode", "messages", "MB/s", "msgs/s", "ns/byte");
+
+    for (const Dataset &dataset : datasets)
+    {
+        for (const Mode &mode : modes)
+        {
+            results.push_back(run(dataset, mode.name, mode.sizes));
+            const Result &result = results.back();
+            fprintf(table, "%-20s %-13s %10zu %10.1f %12.0f %9.3f\n", result.dataset.c_str(), result.mode.c_str(),
+                   result.messages, mb_per_s(result), msgs_per_s(result), ns_per_byte(result));
+        }
+    }
+
+    if (json_path)
+        write_json(json_path, results);
+}
@@ -0,0 +1,9 @@
+#ifndef __BENCH_SUITE_H__
+#define __BENCH_SUITE_H__
+
+// Runs every input stream through every feeding mode and prints one line per
+// run. With a path, the results are also written there as JSON ("-" for
+// stdout) for regression tracking.
+void run_suite_benchmarks(const char *json_path);
+
+#endif // __BENCH_SUITE_H__
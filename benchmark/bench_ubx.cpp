@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <vector>
+#include "GNSSFletcher.h"
+#include "GNSSParser.h"
+#include "bench_common.h"
+
+typedef uint16_t (*FletcherFunction)(uint16_t sum, const uint8_t *data, size_t length);
+
+static const size_t TOTAL_BYTES = 256 * 1024 * 1024;
+static const size_t STREAM_BYTES = 8 * 1024 * 1024;
+static const int ROUNDS = 3;
+
+static void bench_engine(const char *name, FletcherFunction function, const std::vector<uint8_t> &data, size_t block)
+{
+    size_t iterations = TOTAL_BYTES / block;
+    uint16_t sum = 0;
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < iterations; i++)
+        sum ^= function(sum, &data[(i * 64) % (data.size() - block)], block);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    double gbps = static_cast<double>(iterations * block) / elapsed;
+    printf("Fletcher %-9s %6zu byte blocks  %7.2f GB/s  (%04X)\n", name, block, gbps, sum);
+}
+
+// A receiver sending NAV-PVT, RXM-RAWX and RXM-SFRBX next to NMEA and RTCM3
+// on one port
+static std::vector<uint8_t> make_stream()
+{
+    std::vector<uint8_t> stream;
+    size_t epoch = 0;
+    while (stream.size() < STREAM_BYTES)
+    {
+        append_ubx_frame(stream, 0x01, 0x07, 92);
+        append_ubx_frame(stream, 0x02, 0x15, 16 + 32 * (20 + epoch % 12));
+        append_ubx_frame(stream, 0x02, 0x13, 8 + 4 * 10);
+        append_nmea_sentence(stream, 72);
+        append_rtcm3_frame(stream, 1077, 300 + (epoch * 37) % 200);
+        epoch++;
+    }
+    return stream;
+}
+
+template <class Parser>
+static void measure(const char *name, const std::vector<uint8_t> &stream)
+{
+    static Parser parser;
+    uint64_t best = UINT64_MAX;
+    size_t frames = 0;
+
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        parser.clear();
+        frames = 0;
+        uint64_t start = bench_now_ns();
+        for (size_t pos = 0; pos < stream.size(); pos += 1024)
+        {
+            size_t length = std::min<size_t>(1024, stream.size() - pos);
+            parser.encode_to(stream.data() + pos, length, [&](const GNSSParserBase::MessageView &, bool valid)
+                             { frames += valid; });
+        }
+        uint64_t elapsed = bench_now_ns() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    printf("%-32s %8.1f MB/s  (%zu frames)\n", name, stream.size() * 1e3 / best, frames);
+}
+
+void run_ubx_benchmarks()
+{
+    printf("\nFletcher engines (selected: %d)\n", GNSSFletcher::engine());
+
+    std::vector<uint8_t> data(128 * 1024);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (i * 2654435761u) >> 24;
+
+    const size_t blocks[] = {100, 1000, 65536};
+    for (size_t block : blocks)
+    {
+        bench_engine("bytewise", GNSSFletcher::updateBytewise, data, block);
+        bench_engine("blocked", GNSSFletcher::updateBlocked, data, block);
+        if (GNSSFletcher::engine() == GNSSFletcher::SSE2)
+            bench_engine("sse2", GNSSFletcher::updateSSE2, data, block);
+        if (GNSSFletcher::engine() == GNSSFletcher::NEON)
+            bench_engine("neon", GNSSFletcher::updateNEON, data, block);
+    }
+
+    printf("\nUBX-heavy stream, 1 KiB writes\n");
+    std::vector<uint8_t> stream = make_stream();
+    measure<BasicGNSSParser<4096, 128, GNSSProtocol::NMEA | GNSSProtocol::RTCM3>>("UBX unframed, rescanned", stream);
+    measure<GNSSParser>("UBX framed", stream);
+}
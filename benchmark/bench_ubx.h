@@ -0,0 +1,6 @@
+#ifndef __BENCH_UBX_H__
+#define __BENCH_UBX_H__
+
+void run_ubx_benchmarks();
+
+#endif // __BENCH_UBX_H__
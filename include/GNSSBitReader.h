@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Reads big-endian bit fields, most significant bit first, as laid out in
+// RTCM3 payloads. Fields of up to 64 bits are read with one unaligned 8 byte
+// load where the data allows it, byte by byte near the end.
+//
+// Reading past the end yields zero bits and sets overflow(), so a decoder can
+// read a whole message and check once at the end.
+class GNSSBitReader
+{
+public:
+    GNSSBitReader(const uint8_t *data, size_t length)
+        : data_(data), length_(length), bits_(length * 8), pos_(0), overflow_(false)
+    {
+    }
+
+    // Unsigned field of count bits, count <= 64
+    uint64_t read(unsigned count)
+    {
+        uint64_t value = get(data_, length_, pos_, count);
+        pos_ += count;
+        if (pos_ > bits_)
+            overflow_ = true;
+        return value;
+    }
+
+    // Two's complement field of count bits, 0 < count <= 64
+    int64_t readSigned(unsigned count)
+    {
+        return signExtend(read(count), count);
+    }
+
+    // Sign-magnitude field of count bits (the "intS" fields of GLONASS
+    // messages), 1 < count <= 64
+    int64_t readSignMagnitude(unsigned count)
+    {
+        uint64_t value = read(count);
+        uint64_t magnitude = value & ((uint64_t(1) << (count - 1)) - 1);
+        return value >> (count - 1) ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+    }
+
+    bool readBit() { return read(1) != 0; }
+
+    void skip(size_t count)
+    {
+        pos_ += count;
+        if (pos_ > bits_)
+            overflow_ = true;
+    }
+
+    size_t position() const { return pos_; }
+    size_t remaining() const { return pos_ < bits_ ? bits_ - pos_ : 0; }
+    bool overflow() const { return overflow_; }
+
+    // Field of count bits starting bit bits into data, without a reader
+    static uint64_t get(const uint8_t *data, size_t length, size_t bit, unsigned count)
+    {
+        if (count == 0)
+            return 0;
+
+        size_t index = bit >> 3;
+        unsigned shift = bit & 7;
+
+        // Fast path: the field and its leading bits fit in one 64-bit window
+        if (shift + count <= 64 && index + 8 <= length)
+        {
+            uint64_t window = load64(data + index);
+            return (window << shift) >> (64 - count);
+        }
+
+        uint64_t value = 0;
+        for (unsigned i = 0; i < count; i++, bit++)
+        {
+            index = bit >> 3;
+            uint64_t b = index < length ? (data[index] >> (7 - (bit & 7))) & 1 : 0;
+            value = (value << 1) | b;
+        }
+        return value;
+    }
+
+    static int64_t signExtend(uint64_t value, unsigned count)
+    {
+        if (count == 0 || count >= 64)
+            return static_cast<int64_t>(value);
+
+        uint64_t sign = uint64_t(1) << (count - 1);
+        return static_cast<int64_t>((value ^ sign) - sign);
+    }
+
+private:
+    static uint64_t load64(const uint8_t *p)
+    {
+        return (uint64_t(p[0]) << 56) | (uint64_t(p[1]) << 48) | (uint64_t(p[2]) << 40) | (uint64_t(p[3]) << 32) |
+               (uint64_t(p[4]) << 24) | (uint64_t(p[5]) << 16) | (uint64_t(p[6]) << 8) | uint64_t(p[7]);
+    }
+
+    const uint8_t *data_;
+    size_t length_;
+    size_t bits_;
+    size_t pos_;
+    bool overflow_;
+};
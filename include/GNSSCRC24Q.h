@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// CRC-24Q as used by RTCM3 (polynomial 0x1864CFB, no reflection, init 0).
+//
+// update() picks the fastest engine available on the running CPU: carry-less
+// multiply folding (x86 PCLMULQDQ / ARMv8 PMULL), slicing-by-8 tables, or the
+// plain byte-at-a-time table. All engines produce identical results and can
+// be chained, so a frame split over the two segments of a ring buffer is
+// checked in place.
+class GNSSCRC24Q
+{
+public:
+    enum Engine
+    {
+        TABLE,
+        SLICING_BY_8,
+        CLMUL
+    };
+
+    static uint32_t update(uint32_t crc, const uint8_t *data, size_t length)
+    {
+        // Short runs, e.g. bytes arriving one at a time, skip the dispatch
+        if (length < 8)
+        {
+            for (size_t i = 0; i < length; i++)
+                crc = update(crc, data[i]);
+            return crc;
+        }
+
+        return updateBlock(crc, data, length);
+    }
+
+    static uint32_t update(uint32_t crc,
+                           const uint8_t *first, size_t first_length,
+                           const uint8_t *second, size_t second_length);
+
+    static uint32_t calculate(const uint8_t *data, size_t length)
+    {
+        return update(0, data, length);
+    }
+
+    static uint32_t update(uint32_t crc, uint8_t byte)
+    {
+        return ((crc << 8) & 0xFFFFFF) ^ CRC24Q_TABLE[((crc >> 16) ^ byte) & 0xFF];
+    }
+
+    // Individual engines, exposed for testing and benchmarking
+    static uint32_t updateTable(uint32_t crc, const uint8_t *data, size_t length);
+    static uint32_t updateSlicingBy8(uint32_t crc, const uint8_t *data, size_t length);
+    static uint32_t updateClmul(uint32_t crc, const uint8_t *data, size_t length);
+
+    static bool clmulSupported();
+    static Engine engine();
+
+private:
+    static const uint32_t CRC24Q_TABLE[256];
+    static const Engine SELECTED_ENGINE;
+
+    static Engine initialize();
+    static uint32_t updateBlock(uint32_t crc, const uint8_t *data, size_t length);
+};
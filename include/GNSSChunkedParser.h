@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "GNSSParser.h"
+
+// Parses a large in-memory capture (typically a mapped file) on several
+// threads. The capture is cut into chunks, each chunk is framed on its own
+// thread starting from its first byte, and the seams are then repaired: where
+// the frame sequence of one chunk runs into the next, the next chunk's frames
+// are replaced up to the point where both sequences meet again.
+//
+// The result is the list of valid frames GNSSParser reports for the same
+// bytes, in the same order, once the end of the capture is flushed through
+// it: a candidate cut off by the end fails like one failing its check. Chunks are processed in waves of one chunk per
+// thread, so memory use does not grow with the capture size.
+class GNSSChunkedParser
+{
+public:
+    struct Frame
+    {
+        GNSSParserBase::Message::Type type;
+        size_t offset; // from the start of the capture
+        size_t length;
+    };
+
+    // Threads defaults to the number of hardware threads
+    explicit GNSSChunkedParser(size_t threads = 0, size_t chunk_size = 4 * 1024 * 1024);
+
+    // Calls visitor(const Frame &) for every valid frame, in stream order
+    template <class Visitor>
+    void parse(const uint8_t *data, size_t size, Visitor visitor);
+
+    std::vector<Frame> parse(const uint8_t *data, size_t size);
+
+    size_t threads() const { return threads_; }
+    size_t chunkSize() const { return chunk_size_; }
+
+private:
+    // Frames of one chunk, framed as if the stream started at `begin`
+    struct Chunk
+    {
+        size_t begin;
+        size_t end;
+        std::vector<Frame> frames;
+        size_t exit; // first idle scanner position at or past `end`
+    };
+
+    // Where the true frame sequence stands between waves
+    struct Cursor
+    {
+        size_t pos;
+    };
+
+    void parseWave(const uint8_t *data, size_t size, size_t begin, Cursor &cursor, std::vector<Frame> &frames);
+    static void merge(const uint8_t *data, size_t size, const Chunk &chunk, Cursor &cursor, std::vector<Frame> &frames);
+
+    size_t threads_;
+    size_t chunk_size_;
+    std::vector<Chunk> chunks_;
+};
+
+template <class Visitor>
+void GNSSChunkedParser::parse(const uint8_t *data, size_t size, Visitor visitor)
+{
+    std::vector<Frame> frames;
+    Cursor cursor = {0};
+
+    for (size_t begin = 0; begin < size; begin += threads_ * chunk_size_)
+    {
+        parseWave(data, size, begin, cursor, frames);
+        for (const Frame &frame : frames)
+        {
+            visitor(frame);
+        }
+        frames.clear();
+    }
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include "GNSSParser.h"
+#include "GNSSSPSCQueue.h"
+
+#if !defined(GNSS_PARSER_EVENTFD)
+#if defined(__linux__) && !defined(ARDUINO)
+#define GNSS_PARSER_EVENTFD 1
+#else
+#define GNSS_PARSER_EVENTFD 0
+#endif
+#endif
+
+#if GNSS_PARSER_EVENTFD
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+// Parser shared by one producer thread, which calls encode() or
+// encode_stream(), and one consumer thread, which calls available(),
+// peekMessage() / peekMessages() / release() or getMessage(). The ring buffer
+// and the message queue are handed over through atomic positions, so neither
+// side takes a lock.
+//
+// wait() and wait_for() block the consumer until a message is queued. On
+// Linux, eventFd() gives a descriptor that turns readable when messages are
+// queued, for poll() or epoll; read it before draining the queue.
+//
+// clear(), dropped(), stats(), resetStats() and encode_to() belong to the
+// producer side.
+inline namespace GNSS_PARSER_LAYOUT
+{
+
+template <size_t BufferSize = 4096, size_t MaxMessages = 128, uint32_t Protocols = GNSSProtocol::ALL>
+class BasicGNSSConcurrentParser : public BasicGNSSParser<BufferSize, MaxMessages, Protocols, GNSSSPSCQueue>
+{
+    typedef BasicGNSSParser<BufferSize, MaxMessages, Protocols, GNSSSPSCQueue> Base;
+
+public:
+    BasicGNSSConcurrentParser() = default;
+    explicit BasicGNSSConcurrentParser(typename Base::Storage storage) : Base(storage) {}
+    ~BasicGNSSConcurrentParser();
+
+    BasicGNSSConcurrentParser(const BasicGNSSConcurrentParser &) = delete;
+    BasicGNSSConcurrentParser &operator=(const BasicGNSSConcurrentParser &) = delete;
+
+    // Producer side
+    bool encode(uint8_t byte);
+    bool encode(const uint8_t *buffer, size_t length);
+    size_t encode_stream(const uint8_t *buffer, size_t length);
+
+    // Consumer side
+    void wait();
+    template <class Rep, class Period>
+    bool wait_for(const std::chrono::duration<Rep, Period> &timeout);
+
+#if GNSS_PARSER_EVENTFD
+    // Created on first use, closed with the parser. Returns -1 on failure.
+    int eventFd();
+#endif
+
+private:
+    void notify();
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::atomic<bool> waiting_{false};
+    std::atomic<int> event_fd_{-1};
+};
+
+typedef BasicGNSSConcurrentParser<> GNSSConcurrentParser;
+
+} // inline namespace GNSS_PARSER_LAYOUT
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols>
+BasicGNSSConcurrentParser<BufferSize, MaxMessages, Protocols>::~BasicGNSSConcurrentParser()
+{
+#if GNSS_PARSER_EVENTFD
+    if (event_fd_ >= 0)
+        close(event_fd_);
+#endif
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols>
+bool BasicGNSSConcurrentParser<BufferSize, MaxMessages, Protocols>::encode(uint8_t byte)
+{
+    bool result = Base::encode(byte);
+    notify();
+    return result;
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols>
+bool BasicGNSSConcurrentParser<BufferSize, MaxMessages, Protocols>::encode(const uint8_t *buffer, size_t length)
+{
+    bool result = Base::encode(buffer, length);
+    notify();
+    return result;
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols>
+size_t BasicGNSSConcurrentParser<BufferSize, MaxMessages, Protocols>::encode_stream(const uint8_t *buffer, size_t length)
+{
+    size_t consumed = Base::encode_stream(buffer, length);
+    notify();
+    return consumed;
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols>
+void BasicGNSSConcurrentParser<BufferSize, MaxMessages, Protocols>::notify()
+{
+    if (!this->available())
+    {
+        return;
+    }
+
+#if GNSS_PARSER_EVENTFD
+    int fd = event_fd_.load(std::memory_order_acquire);
+    if (fd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(fd, &one, sizeof(one));
+        (void)written;
+    }
+#endif
+
+    // Pairs with the fence in wait_for(): either the waiter sees the queued
+    // message, or we see it waiting and wake it up under the mutex
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.notify_one();
+    }
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols>
+void BasicGNSSConcurrentParser<BufferSize, MaxMessages, Protocols>::wait()
+{
+    while (!wait_for(std::chrono::seconds(1)))
+    {
+    }
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols>
+template <class Rep, class Period>
+bool BasicGNSSConcurrentParser<BufferSize, MaxMessages, Protocols>::wait_for(const std::chrono::duration<Rep, Period> &timeout)
+{
+    if (this->available())
+    {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool ready = ready_.wait_for(lock, timeout, [this]
+                                 { return this->available(); });
+
+    waiting_.store(false, std::memory_order_relaxed);
+    return ready;
+}
+
+#if GNSS_PARSER_EVENTFD
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols>
+int BasicGNSSConcurrentParser<BufferSize, MaxMessages, Protocols>::eventFd()
+{
+    int fd = event_fd_.load(std::memory_order_acquire);
+    if (fd >= 0)
+    {
+        return fd;
+    }
+
+    fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int expected = -1;
+    if (fd >= 0 && !event_fd_.compare_exchange_strong(expected, fd))
+    {
+        // Lost a race with another caller
+        close(fd);
+        fd = expected;
+    }
+
+    // Messages may already be waiting
+    if (fd >= 0 && this->available())
+    {
+        uint64_t one = 1;
+        ssize_t written = write(fd, &one, sizeof(one));
+        (void)written;
+    }
+
+    return fd;
+}
+#endif
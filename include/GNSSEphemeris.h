@@ -0,0 +1,173 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "GNSSParser.h"
+#include "GNSSRTCM3.h"
+
+// Broadcast orbit and clock of a GPS (1019), QZSS (1044), BeiDou (1042) or
+// Galileo (1045 F/NAV, 1046 I/NAV) satellite, scaled to SI units. Angles are
+// in radians, times in seconds of the week of the satellite's own system.
+struct GNSSKeplerEphemeris
+{
+    GNSSSystem::Type system;
+    uint8_t prn;    // QZSS 193 to 202
+    uint16_t week;  // as broadcast, GPS and QZSS modulo 1024
+    uint16_t iode;  // IODE, IODnav (Galileo) or AODE (BeiDou)
+    uint16_t iodc;  // IODC or AODC, 0 for Galileo
+    uint8_t health; // 0 when healthy; Galileo signal health and data validity bits
+    uint8_t accuracy; // URA index, SISA (Galileo) or URAI (BeiDou)
+
+    double toe; // s
+    double toc; // s
+    double af0; // s
+    double af1; // s/s
+    double af2; // s/s^2
+    double tgd; // s; TGD, BGD (Galileo) or TGD1 (BeiDou)
+
+    double sqrt_a; // sqrt(m)
+    double e;
+    double m0;
+    double delta_n;   // rad/s
+    double omega0;    // longitude of the ascending node at the start of the week
+    double omega_dot; // rad/s
+    double i0;
+    double idot;  // rad/s
+    double omega; // argument of perigee
+    double cuc, cus, crc, crs, cic, cis; // rad, m
+};
+
+// Broadcast state vector of a GLONASS satellite (1020), in PZ-90 and SI units
+struct GNSSGlonassEphemeris
+{
+    uint8_t slot; // 1 to 24
+    int8_t frequency_channel; // -7 to 6
+    uint8_t health; // Bn MSB, 0 when healthy
+    uint32_t tb;    // reference time, s of the Moscow day, up to 95 * 900
+
+    double position[3];     // m
+    double velocity[3];     // m/s
+    double acceleration[3]; // lunisolar, m/s^2
+    double tau_n;   // s
+    double gamma_n; // relative frequency offset
+};
+
+// Positions and clocks computed for every cached satellite at one time,
+// structure of arrays
+struct GNSSSatelliteStates
+{
+    static constexpr size_t MAX_SATELLITES = 32 + 10 + 36 + 63 + 32;
+
+    size_t count;
+    GNSSSystem::Type system[MAX_SATELLITES];
+    uint8_t prn[MAX_SATELLITES]; // PRN, GLONASS slot
+    bool healthy[MAX_SATELLITES];
+    double x[MAX_SATELLITES]; // ECEF, m (WGS84, CGCS2000, GTRF or PZ-90)
+    double y[MAX_SATELLITES];
+    double z[MAX_SATELLITES];
+    double clock[MAX_SATELLITES]; // satellite clock offset, s, relativistic term included, group delay not
+};
+
+// Caches the latest broadcast ephemeris of every satellite and computes all
+// their positions at once.
+//
+// Entries are keyed by system and PRN, with O(1) lookup; a message carrying
+// the IODE and reference time already cached changes nothing, so receivers
+// repeating the same ephemeris every few seconds cost one decode and a
+// compare. On change the entry's derived orbit constants are recomputed once.
+//
+// compute() works on a packed structure of arrays of those constants in
+// branch-free loops over all Keplerian orbits, with a fixed number of Kepler
+// iterations, which compilers vectorise where a vector math library is
+// available (-O3 -ffast-math with glibc). BeiDou GEO satellites get their
+// extra rotation in a second pass. GLONASS state vectors are integrated with
+// Runge-Kutta from their reference time, one satellite at a time.
+//
+// The cache is about 40 kB and compute() takes 7 kB of stack for its
+// scratch arrays; keep both off small stacks.
+class GNSSEphemerisCache
+{
+public:
+    enum Update
+    {
+        IGNORED,   // not an ephemeris message, or malformed
+        UNCHANGED, // same IODE and reference time as the cached entry
+        UPDATED    // new satellite or new ephemeris
+    };
+
+    static constexpr size_t KEPLER_SLOTS = 32 + 10 + 36 + 63; // GPS, QZSS, Galileo, BeiDou
+    static constexpr size_t GLONASS_SLOTS = 32;
+
+    explicit GNSSEphemerisCache(int leap_seconds = 18);
+
+    GNSSEphemerisCache(const GNSSEphemerisCache &) = delete;
+    GNSSEphemerisCache &operator=(const GNSSEphemerisCache &) = delete;
+
+    // Adds a whole frame, from its 0xD3 preamble. Messages other than
+    // 1019, 1020, 1042, 1044, 1045 and 1046 are IGNORED.
+    Update add(const uint8_t *frame, size_t length);
+
+    // A wrapped view is first copied to the stack
+    Update add(const GNSSParserBase::MessageView &view);
+
+    Update add(const GNSSKeplerEphemeris &ephemeris);
+    Update add(const GNSSGlonassEphemeris &ephemeris);
+
+    // Cached entries, nullptr when there is none
+    const GNSSKeplerEphemeris *find(GNSSSystem::Type system, uint8_t prn) const;
+    const GNSSGlonassEphemeris *findGlonass(uint8_t slot) const;
+
+    size_t size() const { return kepler_count_ + glonass_count_; }
+    void clear();
+
+    // Positions and clocks of all cached satellites at a GPS time of week in
+    // seconds, Keplerian orbits first. Returns states.count.
+    size_t compute(double gps_time, GNSSSatelliteStates &states) const;
+
+    // Decoders for single frames, false for other messages or short payloads
+    static bool decode(const uint8_t *frame, size_t length, GNSSKeplerEphemeris &ephemeris);
+    static bool decode(const uint8_t *frame, size_t length, GNSSGlonassEphemeris &ephemeris);
+
+private:
+    static int keplerSlot(GNSSSystem::Type system, uint8_t prn);
+    void prepare(size_t index, const GNSSKeplerEphemeris &ephemeris);
+    void computeGlonass(double gps_time, GNSSSatelliteStates &states) const;
+
+    int leap_seconds_;
+
+    // Entries by slot; index_ maps a slot to its place in the packed arrays
+    GNSSKeplerEphemeris kepler_[KEPLER_SLOTS];
+    int16_t index_[KEPLER_SLOTS];
+    GNSSGlonassEphemeris glonass_[GLONASS_SLOTS];
+    bool glonass_valid_[GLONASS_SLOTS];
+    size_t kepler_count_;
+    size_t glonass_count_;
+
+    // Packed orbit constants, times in GPS seconds of week
+    struct Orbits
+    {
+        GNSSSystem::Type system[KEPLER_SLOTS];
+        uint8_t prn[KEPLER_SLOTS];
+        bool healthy[KEPLER_SLOTS];
+        double toe[KEPLER_SLOTS];
+        double toc[KEPLER_SLOTS];
+        double a[KEPLER_SLOTS];
+        double n[KEPLER_SLOTS]; // corrected mean motion
+        double e[KEPLER_SLOTS];
+        double root_1_e2[KEPLER_SLOTS]; // sqrt(1 - e^2)
+        double m0[KEPLER_SLOTS];
+        double cos_omega[KEPLER_SLOTS]; // argument of perigee
+        double sin_omega[KEPLER_SLOTS];
+        double node0[KEPLER_SLOTS];     // omega0 - earth rate * toe
+        double node_rate[KEPLER_SLOTS]; // omega_dot - earth rate, omega_dot for BeiDou GEO
+        double i0[KEPLER_SLOTS];
+        double idot[KEPLER_SLOTS];
+        double cuc[KEPLER_SLOTS], cus[KEPLER_SLOTS];
+        double crc[KEPLER_SLOTS], crs[KEPLER_SLOTS];
+        double cic[KEPLER_SLOTS], cis[KEPLER_SLOTS];
+        double af0[KEPLER_SLOTS], af1[KEPLER_SLOTS], af2[KEPLER_SLOTS];
+        double relativity[KEPLER_SLOTS]; // F * sqrt(A) * e
+    } orbits_;
+    uint8_t geo_[KEPLER_SLOTS]; // packed indices of BeiDou GEO satellites
+    size_t geo_count_;
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "GNSSMSM.h"
+
+// All MSMs of one receiver epoch, decoded
+struct GNSSEpoch
+{
+    static constexpr size_t MAX_MESSAGES = 8;
+
+    enum Completion
+    {
+        FINAL_MESSAGE, // a message with the multiple message bit cleared arrived
+        NEW_EPOCH,     // a message of a later epoch (or another station) arrived first
+        TIMEOUT,       // nothing arrived for the timeout
+        FLUSHED        // flush() was called
+    };
+
+    uint16_t station_id;
+    uint32_t time; // GPS time of week, ms
+    Completion completion;
+    uint64_t first_received_ns; // receive times of the first and last message
+    uint64_t last_received_ns;
+
+    size_t count;
+    GNSSMSMObservations messages[MAX_MESSAGES];
+};
+
+// Groups the MSMs of a stream into receiver epochs. A receiver sends one MSM
+// per constellation for every epoch, with the multiple message bit set on all
+// but the last one; the assembler decodes each message in place into the
+// pending epoch and hands the epoch to the handler as soon as the last one is
+// in. Should that message be lost, the epoch is handed over when a later
+// epoch starts, or by poll() once the stream has been quiet for the timeout.
+//
+// Epoch times of the different systems are brought to GPS time before they
+// are compared: BeiDou runs 14 s behind, GLONASS on Moscow time (UTC + 3 h).
+//
+// Receive times are nanoseconds on the now() clock. latency() measures from
+// the receive time of an epoch's last message to the moment it is handed
+// over. One assembler serves one station; a caster with several should keep
+// one per station ID.
+class GNSSEpochAssembler
+{
+public:
+    struct Latency
+    {
+        uint64_t epochs;
+        uint64_t total_ns;
+        uint64_t max_ns;
+        uint64_t last_ns;
+
+        double mean_ns() const { return epochs ? static_cast<double>(total_ns) / epochs : 0; }
+    };
+
+    explicit GNSSEpochAssembler(uint32_t timeout_ms = 200, int leap_seconds = 18);
+
+    GNSSEpochAssembler(const GNSSEpochAssembler &) = delete;
+    GNSSEpochAssembler &operator=(const GNSSEpochAssembler &) = delete;
+
+    // Adds a framed message; anything but a decodable MSM is ignored and
+    // false returned. handler(const GNSSEpoch &) is called for every epoch
+    // completed by this message, at most two. The epoch is only valid during
+    // the call.
+    template <class Handler>
+    bool add(const GNSSParserBase::MessageView &view, uint64_t received_ns, Handler handler);
+
+    template <class Handler>
+    bool add(const GNSSParserBase::MessageView &view, Handler handler) { return add(view, now(), handler); }
+
+    // Hands over the pending epoch if nothing arrived for the timeout
+    template <class Handler>
+    void poll(Handler handler);
+
+    // Hands over the pending epoch, if any
+    template <class Handler>
+    void flush(Handler handler);
+
+    bool pending() const { return epoch_.count > 0; }
+    const Latency &latency() const { return latency_; }
+
+    // Messages dropped because the pending epoch already held MAX_MESSAGES
+    size_t overflows() const { return overflows_; }
+
+    // GPS time of week in ms of an MSM epoch time
+    uint32_t gpsTime(GNSSSystem::Type system, uint32_t epoch_time) const;
+
+    // Monotonic clock for receive times, in nanoseconds
+    static uint64_t now();
+
+private:
+    template <class Handler>
+    void emit(GNSSEpoch::Completion completion, Handler &handler);
+
+    bool sameEpoch(uint16_t station_id, uint32_t time) const;
+
+    uint32_t timeout_ms_;
+    int leap_seconds_;
+    GNSSEpoch epoch_;
+    Latency latency_ = {};
+    size_t overflows_ = 0;
+};
+
+template <class Handler>
+bool GNSSEpochAssembler::add(const GNSSParserBase::MessageView &view, uint64_t received_ns, Handler handler)
+{
+    if (view.type != GNSSParserBase::Message::Type::RTCM3)
+    {
+        return false;
+    }
+
+    GNSSRTCM3Header header(view);
+    if (header.msmType() < 4)
+    {
+        return false;
+    }
+
+    uint32_t time = gpsTime(header.system(), header.msmEpochTime());
+    if (epoch_.count > 0 && !sameEpoch(header.stationId(), time))
+    {
+        emit(GNSSEpoch::NEW_EPOCH, handler);
+    }
+
+    if (epoch_.count == GNSSEpoch::MAX_MESSAGES)
+    {
+        overflows_++;
+        return false;
+    }
+
+    // Decode straight into the next slot; it only counts once it decoded
+    if (!GNSSMSMDecoder::decode(view, epoch_.messages[epoch_.count]))
+    {
+        return false;
+    }
+
+    if (epoch_.count == 0)
+    {
+        epoch_.station_id = header.stationId();
+        epoch_.time = time;
+        epoch_.first_received_ns = received_ns;
+    }
+    epoch_.last_received_ns = received_ns;
+    epoch_.count++;
+
+    if (!header.msmMultipleMessage())
+    {
+        emit(GNSSEpoch::FINAL_MESSAGE, handler);
+    }
+
+    return true;
+}
+
+template <class Handler>
+void GNSSEpochAssembler::poll(Handler handler)
+{
+    if (epoch_.count > 0 && now() - epoch_.last_received_ns >= uint64_t(timeout_ms_) * 1000000)
+    {
+        emit(GNSSEpoch::TIMEOUT, handler);
+    }
+}
+
+template <class Handler>
+void GNSSEpochAssembler::flush(Handler handler)
+{
+    if (epoch_.count > 0)
+    {
+        emit(GNSSEpoch::FLUSHED, handler);
+    }
+}
+
+template <class Handler>
+void GNSSEpochAssembler::emit(GNSSEpoch::Completion completion, Handler &handler)
+{
+    epoch_.completion = completion;
+
+    uint64_t latency = now() - epoch_.last_received_ns;
+    latency_.epochs++;
+    latency_.total_ns += latency;
+    latency_.last_ns = latency;
+    if (latency > latency_.max_ns)
+        latency_.max_ns = latency;
+
+    const GNSSEpoch &epoch = epoch_;
+    handler(epoch);
+    epoch_.count = 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 8-bit Fletcher checksum as used by UBX, over class, ID, length and payload.
+// The sum is held as CK_A in the low byte and CK_B in the high byte, the
+// order they are sent in.
+//
+// The byte-at-a-time definition adds every byte into CK_A and CK_A into
+// CK_B, a dependency chain through every byte. The block engines instead
+// add a whole block into CK_B at once, as its bytes weighted by their
+// distance from the block's end plus the block length times CK_A. Wide sums
+// are only reduced at the end: the checksum is taken modulo 256, which
+// divides every integer word size, so no intermediate reduction is needed.
+//
+// update() uses SSE2 on x86 and NEON on aarch64, and the portable blocked
+// loop everywhere else. All engines produce identical results and can be
+// chained.
+class GNSSFletcher
+{
+public:
+    enum Engine
+    {
+        BYTEWISE,
+        BLOCKED,
+        SSE2,
+        NEON
+    };
+
+    static uint16_t update(uint16_t sum, const uint8_t *data, size_t length)
+    {
+        if (length < 16)
+            return updateBytewise(sum, data, length);
+
+        return updateBlock(sum, data, length);
+    }
+
+    static uint16_t update(uint16_t sum,
+                           const uint8_t *first, size_t first_length,
+                           const uint8_t *second, size_t second_length)
+    {
+        sum = update(sum, first, first_length);
+        return update(sum, second, second_length);
+    }
+
+    static uint16_t calculate(const uint8_t *data, size_t length)
+    {
+        return update(0, data, length);
+    }
+
+    static uint16_t update(uint16_t sum, uint8_t byte)
+    {
+        uint8_t a = static_cast<uint8_t>(sum + byte);
+        uint8_t b = static_cast<uint8_t>((sum >> 8) + a);
+        return static_cast<uint16_t>(a | (b << 8));
+    }
+
+    // Individual engines, exposed for testing and benchmarking. A SIMD engine
+    // not built for this target falls back to the blocked loop.
+    static uint16_t updateBytewise(uint16_t sum, const uint8_t *data, size_t length)
+    {
+        for (size_t i = 0; i < length; i++)
+            sum = update(sum, data[i]);
+        return sum;
+    }
+
+    static uint16_t updateBlocked(uint16_t sum, const uint8_t *data, size_t length);
+    static uint16_t updateSSE2(uint16_t sum, const uint8_t *data, size_t length);
+    static uint16_t updateNEON(uint16_t sum, const uint8_t *data, size_t length);
+
+    static Engine engine();
+
+private:
+    static uint16_t updateBlock(uint16_t sum, const uint8_t *data, size_t length);
+};
@@ -0,0 +1,451 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "GNSSCRC24Q.h"
+#include "GNSSFletcher.h"
+#include "GNSSMessageFilter.h"
+#include "GNSSParserBase.h"
+#include "GNSSSyncSearch.h"
+
+// A framer finds the frames of one protocol in a byte stream. BasicGNSSParser
+// takes a compile-time list of framers (GNSSFramers) and never names a
+// protocol itself, so a new protocol is a new framer in the list.
+//
+// A framer is a struct of static members:
+//
+//   PROTOCOL            its GNSSProtocol bit, enabled by the parser's Protocols
+//   TYPE                the Message::Type of its frames
+//   MAX_LENGTH          longest frame, the parser caps it at its ring size
+//   preamble(c)         constexpr, whether a frame can start with byte c
+//   scan(state, data, available, max_length, result)
+//                       examines the next bytes of the candidate, keeping its
+//                       progress in state, and returns how many it took;
+//                       result tells whether the candidate is complete and
+//                       valid. A complete candidate of length 0 is dropped.
+//   skip(...)           the same for a frame the filter rejected, unchecked
+//
+// and, with defaults in GNSSFramer:
+//
+//   SYNC_LENGTH         fixed leading bytes; a candidate failing within them
+//                       is noise rather than an invalid length
+//   FILTER_HEAD_LENGTH  bytes the filter decision is taken on, at most
+//                       GNSSParserBase::MAX_HEAD_LENGTH
+//   passes(filter, head, count, state)
+//   trusted(state)      whether a rejected frame's header is trusted to skip by
+//   LOG_INVALID         print frames failing their check
+//   FRAMES, FAILURES    Stats counters of its valid frames and failed checks
+struct GNSSFramer
+{
+    typedef GNSSParserBase::Message Message;
+    typedef GNSSParserBase::ParseResult ParseResult;
+    typedef GNSSParserBase::ScanState ScanState;
+    typedef GNSSParserBase::Stats Stats;
+
+    static constexpr size_t SYNC_LENGTH = 1;
+    static constexpr size_t FILTER_HEAD_LENGTH = 0;
+    static constexpr bool LOG_INVALID = false;
+    static constexpr uint64_t Stats::*FRAMES = &Stats::other_frames;
+    static constexpr uint64_t Stats::*FAILURES = &Stats::other_failures;
+
+    static bool passes(const GNSSMessageFilter &, const uint8_t *, size_t, const ScanState &)
+    {
+        return true;
+    }
+
+    static bool trusted(const ScanState &)
+    {
+        return true;
+    }
+};
+
+// scan() and skip() for the usual binary frame: fixed sync bytes, a header
+// holding the length and a check over the frame. Framer describes it:
+//
+//   SYNC, SYNC_LENGTH   sync bytes, the first one most significant
+//   HEAD_LENGTH         header bytes the length is read from
+//   frameLength(head)   whole frame length, below HEAD_LENGTH + CHECK_LENGTH
+//                       for a header that cannot be valid
+//   CHECK_BEGIN         first byte covered by the check, within the header
+//   CHECK_LENGTH        check bytes ending the frame, at most 4
+//   check(sum, data, length)
+//   valid(state)        compares state.sum with state.received, the check
+//                       bytes as read, the first one most significant
+//
+// The header is kept in state.head, so a check stored in the header works too.
+template <class Framer>
+struct GNSSLengthFramer : GNSSFramer
+{
+    static constexpr uint8_t syncByte(size_t offset)
+    {
+        return static_cast<uint8_t>(Framer::SYNC >> (8 * (Framer::SYNC_LENGTH - 1 - offset)));
+    }
+
+    static constexpr bool preamble(uint8_t c)
+    {
+        return c == syncByte(0);
+    }
+
+    static size_t scan(ScanState &state, const uint8_t *data, size_t available, size_t max_length, ParseResult &result);
+    static size_t skip(ScanState &state, const uint8_t *data, size_t available, size_t max_length, ParseResult &result);
+};
+
+template <class Framer>
+size_t GNSSLengthFramer<Framer>::scan(ScanState &state, const uint8_t *data, size_t available, size_t max_length,
+                                      ParseResult &result)
+{
+    static_assert(Framer::SYNC_LENGTH <= Framer::HEAD_LENGTH, "Sync bytes are part of the header");
+    static_assert(Framer::HEAD_LENGTH <= GNSSParserBase::MAX_HEAD_LENGTH, "Header too long to collect");
+    static_assert(Framer::CHECK_BEGIN <= Framer::HEAD_LENGTH, "Check must start within the header");
+    static_assert(Framer::CHECK_LENGTH <= 4, "Check bytes must fit in ScanState::received");
+
+    const size_t head_length = Framer::HEAD_LENGTH;
+    const size_t check_length = Framer::CHECK_LENGTH;
+    bool in_head = state.searched < head_length;
+    size_t consumed = 0;
+
+    while (state.searched + consumed < head_length && consumed < available)
+    {
+        size_t offset = state.searched + consumed;
+        uint8_t c = data[consumed++];
+
+        if (offset < Framer::SYNC_LENGTH && c != syncByte(offset))
+        {
+            result = {false, true, 0, "No sync"};
+            return consumed;
+        }
+        state.head[offset] = c;
+    }
+
+    if (state.searched + consumed < head_length)
+    {
+        result = {true, false, 0, "Message incomplete"};
+        return consumed;
+    }
+
+    if (in_head)
+    {
+        state.length = Framer::frameLength(state.head);
+        if (state.length < head_length + check_length || state.length > max_length)
+        {
+            // Could never be buffered whole, resynchronise instead of waiting
+            result = {false, true, 0, "Invalid length"};
+            return consumed;
+        }
+        state.sum = Framer::check(state.sum, state.head + Framer::CHECK_BEGIN, head_length - Framer::CHECK_BEGIN);
+    }
+
+    size_t offset = state.searched + consumed;
+    size_t check_end = state.length - check_length;
+    if (offset < check_end)
+    {
+        size_t count = available - consumed < check_end - offset ? available - consumed : check_end - offset;
+        state.sum = Framer::check(state.sum, data + consumed, count);
+        consumed += count;
+        offset += count;
+    }
+
+    while (offset < state.length && consumed < available)
+    {
+        state.received = (state.received << 8) | data[consumed];
+        consumed++;
+        offset++;
+    }
+
+    if (offset < state.length)
+    {
+        result = {true, false, state.length, "Message incomplete"};
+        return consumed;
+    }
+
+    bool is_valid = Framer::valid(state);
+    result = {is_valid, true, state.length, is_valid ? nullptr : "Check failed"};
+    return consumed;
+}
+
+// Reads the header to learn the length, then runs over the rest unchecked
+template <class Framer>
+size_t GNSSLengthFramer<Framer>::skip(ScanState &state, const uint8_t *data, size_t available, size_t max_length,
+                                      ParseResult &result)
+{
+    if (state.searched < Framer::HEAD_LENGTH)
+    {
+        size_t head_left = Framer::HEAD_LENGTH - state.searched;
+        return scan(state, data, available < head_left ? available : head_left, max_length, result);
+    }
+
+    size_t count = available < state.length - state.searched ? available : state.length - state.searched;
+    result = {false, state.searched + count == state.length, state.length, "Filtered"};
+    return count;
+}
+
+// '$' or '!', up to 128 characters ending in "*hh\r\n"
+struct GNSSNMEAFramer : GNSSFramer
+{
+    static constexpr uint32_t PROTOCOL = GNSSProtocol::NMEA;
+    static constexpr Message::Type TYPE = Message::NMEA;
+    static constexpr size_t MAX_LENGTH = GNSSParserBase::MAX_NMEA_LENGTH;
+    static constexpr size_t FILTER_HEAD_LENGTH = GNSSMessageFilter::NMEA_HEAD_LENGTH;
+    static constexpr bool LOG_INVALID = true;
+    static constexpr uint64_t Stats::*FRAMES = &Stats::nmea_frames;
+    static constexpr uint64_t Stats::*FAILURES = &Stats::checksum_failures;
+
+    static constexpr bool preamble(uint8_t c)
+    {
+        return c == '$' || c == '!';
+    }
+
+    static size_t scan(ScanState &state, const uint8_t *data, size_t available, size_t max_length, ParseResult &result);
+
+    // Runs up to the line end
+    static size_t skip(ScanState &state, const uint8_t *data, size_t available, size_t max_length, ParseResult &result);
+
+    static bool passes(const GNSSMessageFilter &filter, const uint8_t *head, size_t count, const ScanState &)
+    {
+        return filter.passesNMEA(head + 1, count - 1);
+    }
+};
+
+// 0xD3, 10-bit payload length, payload, CRC-24Q over all of it
+struct GNSSRTCM3Framer : GNSSLengthFramer<GNSSRTCM3Framer>
+{
+    static constexpr uint32_t PROTOCOL = GNSSProtocol::RTCM3;
+    static constexpr Message::Type TYPE = Message::RTCM3;
+    static constexpr size_t MAX_LENGTH = GNSSParserBase::MAX_RTCM3_LENGTH;
+    static constexpr uint32_t SYNC = 0xD3;
+    static constexpr size_t SYNC_LENGTH = 1;
+    static constexpr size_t HEAD_LENGTH = 3;
+    static constexpr size_t CHECK_BEGIN = 0;
+    static constexpr size_t CHECK_LENGTH = 3;
+    static constexpr size_t FILTER_HEAD_LENGTH = GNSSMessageFilter::RTCM3_HEAD_LENGTH;
+    static constexpr uint64_t Stats::*FRAMES = &Stats::rtcm3_frames;
+    static constexpr uint64_t Stats::*FAILURES = &Stats::crc_failures;
+
+    static size_t frameLength(const uint8_t *head)
+    {
+        return (((head[1] & 0x03) << 8) | head[2]) + 6; // header(3) + payload + crc(3)
+    }
+
+    static uint32_t check(uint32_t sum, const uint8_t *data, size_t length)
+    {
+        return GNSSCRC24Q::update(sum, data, length);
+    }
+
+    static bool valid(const ScanState &state)
+    {
+        return state.sum == state.received;
+    }
+
+    static bool passes(const GNSSMessageFilter &filter, const uint8_t *head, size_t, const ScanState &state)
+    {
+        // Payloads under two bytes hold no message number
+        uint16_t number = state.length >= 8 ? (head[3] << 4) | (head[4] >> 4) : 0;
+        return filter.passesRTCM3(number);
+    }
+
+    // Only a header with its 6 reserved bits clear is trusted to skip by
+    static bool trusted(const ScanState &state)
+    {
+        return !(state.head[1] & 0xFC);
+    }
+};
+
+// 0xB5 0x62, class, ID, 16-bit little-endian payload length, payload,
+// Fletcher checksum over all but the sync characters
+struct GNSSUBXFramer : GNSSLengthFramer<GNSSUBXFramer>
+{
+    static constexpr uint32_t PROTOCOL = GNSSProtocol::UBX;
+    static constexpr Message::Type TYPE = Message::UBX;
+    static constexpr size_t MAX_LENGTH = GNSSParserBase::MAX_UBX_LENGTH;
+    static constexpr uint32_t SYNC = 0xB562;
+    static constexpr size_t SYNC_LENGTH = 2;
+    static constexpr size_t HEAD_LENGTH = 6;
+    static constexpr size_t CHECK_BEGIN = 2;
+    static constexpr size_t CHECK_LENGTH = 2;
+    static constexpr size_t FILTER_HEAD_LENGTH = GNSSMessageFilter::UBX_HEAD_LENGTH;
+    static constexpr uint64_t Stats::*FRAMES = &Stats::ubx_frames;
+    static constexpr uint64_t Stats::*FAILURES = &Stats::fletcher_failures;
+
+    static size_t frameLength(const uint8_t *head)
+    {
+        return (head[4] | (head[5] << 8)) + 8; // header(6) + payload + checksum(2)
+    }
+
+    static uint32_t check(uint32_t sum, const uint8_t *data, size_t length)
+    {
+        return GNSSFletcher::update(static_cast<uint16_t>(sum), data, length);
+    }
+
+    // CK_A comes first, but is the low byte of the sum
+    static bool valid(const ScanState &state)
+    {
+        return state.sum == (((state.received & 0xFF) << 8) | (state.received >> 8));
+    }
+
+    static bool passes(const GNSSMessageFilter &filter, const uint8_t *head, size_t, const ScanState &)
+    {
+        return filter.passesUBX(head[2], head[3]);
+    }
+};
+
+// What the parser keeps of each framer, looked up by the framer's index
+struct GNSSFramerEntry
+{
+    typedef size_t (*Scan)(GNSSParserBase::ScanState &, const uint8_t *, size_t, size_t, GNSSParserBase::ParseResult &);
+    typedef bool (*Passes)(const GNSSMessageFilter &, const uint8_t *, size_t, const GNSSParserBase::ScanState &);
+    typedef bool (*Trusted)(const GNSSParserBase::ScanState &);
+
+    GNSSParserBase::Message::Type type;
+    size_t sync_length;
+    size_t filter_head_length;
+    bool log_invalid;
+    uint64_t GNSSParserBase::Stats::*frames;
+    uint64_t GNSSParserBase::Stats::*failures;
+    Scan scan;
+    Scan skip;
+    Passes passes;
+    Trusted trusted;
+
+    template <class Framer>
+    static constexpr GNSSFramerEntry of()
+    {
+        static_assert(Framer::FILTER_HEAD_LENGTH <= GNSSParserBase::MAX_HEAD_LENGTH, "Filter head too long");
+        return {Framer::TYPE, Framer::SYNC_LENGTH, Framer::FILTER_HEAD_LENGTH, Framer::LOG_INVALID,
+                Framer::FRAMES, Framer::FAILURES,
+                &Framer::scan, &Framer::skip, &Framer::passes, &Framer::trusted};
+    }
+};
+
+// Compile-time folds over a framer list, one bit per framer in list order
+template <class... Framers>
+struct GNSSFramerFold;
+
+template <>
+struct GNSSFramerFold<>
+{
+    static constexpr unsigned firstByte(unsigned, unsigned) { return 0; }
+    static constexpr unsigned enabled(uint32_t, unsigned) { return 0; }
+    static constexpr size_t maxLength(unsigned, unsigned) { return 0; }
+};
+
+template <class Framer, class... Rest>
+struct GNSSFramerFold<Framer, Rest...>
+{
+    static constexpr unsigned firstByte(unsigned c, unsigned bit)
+    {
+        return (Framer::preamble(static_cast<uint8_t>(c)) ? 1u << bit : 0u) |
+               GNSSFramerFold<Rest...>::firstByte(c, bit + 1);
+    }
+
+    static constexpr unsigned enabled(uint32_t protocols, unsigned bit)
+    {
+        return ((Framer::PROTOCOL & protocols) ? 1u << bit : 0u) | GNSSFramerFold<Rest...>::enabled(protocols, bit + 1);
+    }
+
+    static constexpr size_t maxLength(unsigned framers, unsigned bit)
+    {
+        return longer((framers & (1u << bit)) ? Framer::MAX_LENGTH : 0, GNSSFramerFold<Rest...>::maxLength(framers, bit + 1));
+    }
+
+    static constexpr size_t longer(size_t a, size_t b) { return a > b ? a : b; }
+};
+
+template <size_t... I>
+struct GNSSIndices
+{
+};
+
+template <size_t N, size_t... I>
+struct GNSSMakeIndices : GNSSMakeIndices<N - 1, N - 1, I...>
+{
+};
+
+template <size_t... I>
+struct GNSSMakeIndices<0, I...>
+{
+    typedef GNSSIndices<I...> type;
+};
+
+template <class Fold, class Indices>
+struct GNSSFirstByteTable;
+
+template <class Fold, size_t... I>
+struct GNSSFirstByteTable<Fold, GNSSIndices<I...>>
+{
+    static constexpr uint8_t TABLE[sizeof...(I)] = {static_cast<uint8_t>(Fold::firstByte(I, 0))...};
+};
+
+template <class Fold, size_t... I>
+constexpr uint8_t GNSSFirstByteTable<Fold, GNSSIndices<I...>>::TABLE[sizeof...(I)];
+
+// A compile-time list of up to 8 framers. FIRST_BYTE maps every byte value
+// to the framers whose frames can start with it, so the scanner finds its
+// candidates with one lookup instead of asking every framer in turn. Where
+// framers share a first byte, the earlier one in the list is tried first.
+template <class... Framers>
+struct GNSSFramers
+{
+    static_assert(sizeof...(Framers) > 0 && sizeof...(Framers) <= 8, "A framer list holds 1 to 8 framers");
+
+    typedef GNSSFramerFold<Framers...> Fold;
+
+    static constexpr size_t COUNT = sizeof...(Framers);
+    static constexpr const uint8_t *FIRST_BYTE = GNSSFirstByteTable<Fold, typename GNSSMakeIndices<256>::type>::TABLE;
+    static constexpr GNSSFramerEntry ENTRIES[COUNT] = {GNSSFramerEntry::of<Framers>()...};
+
+    // Framers of the given GNSSProtocol bits
+    static constexpr unsigned enabled(uint32_t protocols)
+    {
+        return Fold::enabled(protocols, 0);
+    }
+
+    static constexpr size_t maxLength(unsigned framers)
+    {
+        return Fold::maxLength(framers, 0);
+    }
+
+    // Every byte the given framers' frames can start with, for GNSSSyncSearch
+    static constexpr GNSSSyncSearch::Set firstBytes(unsigned framers)
+    {
+        return {static_cast<uint8_t>(countFirstBytes(framers, 0)),
+                {nthFirstByte(framers, 0, 0), nthFirstByte(framers, 1, 0), nthFirstByte(framers, 2, 0),
+                 nthFirstByte(framers, 3, 0), nthFirstByte(framers, 4, 0), nthFirstByte(framers, 5, 0),
+                 nthFirstByte(framers, 6, 0), nthFirstByte(framers, 7, 0)},
+                {firstByteMap(framers, 0, 0), firstByteMap(framers, 32, 0), firstByteMap(framers, 64, 0),
+                 firstByteMap(framers, 96, 0), firstByteMap(framers, 128, 0), firstByteMap(framers, 160, 0),
+                 firstByteMap(framers, 192, 0), firstByteMap(framers, 224, 0)}};
+    }
+
+    static constexpr size_t countFirstBytes(unsigned framers, unsigned c)
+    {
+        return c == 256 ? 0 : ((Fold::firstByte(c, 0) & framers) ? 1 : 0) + countFirstBytes(framers, c + 1);
+    }
+
+private:
+    static constexpr uint8_t nthFirstByte(unsigned framers, size_t n, unsigned c)
+    {
+        return c == 256                          ? 0
+               : !(Fold::firstByte(c, 0) & framers) ? nthFirstByte(framers, n, c + 1)
+               : n == 0                          ? static_cast<uint8_t>(c)
+                                                 : nthFirstByte(framers, n - 1, c + 1);
+    }
+
+    static constexpr uint32_t firstByteMap(unsigned framers, unsigned base, unsigned bit)
+    {
+        return bit == 32 ? 0
+                         : ((Fold::firstByte(base + bit, 0) & framers) ? 1u << bit : 0u) |
+                               firstByteMap(framers, base, bit + 1);
+    }
+};
+
+template <class... Framers>
+constexpr size_t GNSSFramers<Framers...>::COUNT;
+
+template <class... Framers>
+constexpr const uint8_t *GNSSFramers<Framers...>::FIRST_BYTE;
+
+template <class... Framers>
+constexpr GNSSFramerEntry GNSSFramers<Framers...>::ENTRIES[GNSSFramers<Framers...>::COUNT];
+
+typedef GNSSFramers<GNSSNMEAFramer, GNSSRTCM3Framer, GNSSUBXFramer> GNSSDefaultFramers;
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include "GNSSNMEA.h"
+
+// Satellites in view of every talker and signal, as of the last completed
+// GSV group. Satellites of one group are contiguous, groups in the order
+// they were first heard.
+struct GNSSSatellitesInView
+{
+    static constexpr size_t MAX_SATELLITES = 160;
+
+    uint32_t sequence; // groups completed up to this snapshot, 0 for none
+    size_t count;
+    GNSSSatelliteInView satellites[MAX_SATELLITES];
+};
+
+// Builds the satellites-in-view table from GSV sentences, one thread
+// producing and one consuming.
+//
+// Each talker and signal ID sends its satellites as a group of up to nine
+// sentences. Every group has a table slot holding two halves: the last
+// completed group, and the one being assembled. Each sentence is decoded
+// straight into the second half as it arrives; nothing is buffered or copied.
+// When the last sentence of a group is in, the halves swap and all completed
+// groups are laid out into a snapshot. A missing or out-of-order sentence
+// abandons the group being assembled, leaving the completed one in place.
+//
+// Snapshots are triple buffered: the producer fills a spare one and
+// publishes it with one atomic exchange, the consumer takes the newest
+// with another. A snapshot held by the consumer is never written, so it can
+// be read without locks or retries.
+//
+// About 13 kB with the default 16 groups.
+template <size_t MaxGroups = 16>
+class BasicGNSSGSVAssembler
+{
+public:
+    enum Update
+    {
+        IGNORED,  // not GSV, out of sequence, or no room for another group
+        ACCEPTED, // added to a group still incomplete
+        PUBLISHED // completed a group, a new snapshot is out
+    };
+
+    static constexpr size_t MAX_GROUPS = MaxGroups;
+    static constexpr size_t MAX_GROUP_SATELLITES = 9 * GNSSNMEAGSV::MAX_SATELLITES;
+
+    BasicGNSSGSVAssembler() { clear(); }
+
+    BasicGNSSGSVAssembler(const BasicGNSSGSVAssembler &) = delete;
+    BasicGNSSGSVAssembler &operator=(const BasicGNSSGSVAssembler &) = delete;
+
+    // Producer side
+    Update add(const GNSSNMEAFields &fields);
+
+    Update add(const GNSSParserBase::MessageView &view)
+    {
+        if (view.type != GNSSParserBase::Message::Type::NMEA)
+        {
+            return IGNORED;
+        }
+        GNSSNMEAFields fields(view);
+        return add(fields);
+    }
+
+    // Consumer side: the newest snapshot, left untouched until the next call
+    const GNSSSatellitesInView &snapshot()
+    {
+        if (middle_.load(std::memory_order_relaxed) & FRESH)
+        {
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+        }
+        return buffers_[front_];
+    }
+
+    // A snapshot newer than the consumer's is waiting
+    bool fresh() const { return (middle_.load(std::memory_order_acquire) & FRESH) != 0; }
+
+    // Producer side counters: groups turned away for lack of a slot or
+    // satellites past the snapshot's capacity, and groups abandoned on a
+    // missing or out-of-order sentence
+    size_t overflows() const { return overflows_; }
+    size_t incomplete() const { return incomplete_; }
+
+    // Not thread safe
+    void clear()
+    {
+        group_count_ = 0;
+        sequence_ = 0;
+        overflows_ = 0;
+        incomplete_ = 0;
+        for (size_t i = 0; i < 3; i++)
+        {
+            buffers_[i].sequence = 0;
+            buffers_[i].count = 0;
+        }
+        back_ = 0;
+        middle_.store(1, std::memory_order_relaxed);
+        front_ = 2;
+    }
+
+private:
+    static constexpr uint8_t INDEX = 0x03;
+    static constexpr uint8_t FRESH = 0x04;
+
+    struct Group
+    {
+        GNSSSystem::Type system;
+        uint8_t signal_id;
+        uint8_t current;   // half holding the completed group
+        uint8_t sentences; // of the group being assembled, 0 when none
+        uint8_t next;      // sentence expected next
+        uint8_t counts[2];
+        GNSSSatelliteInView satellites[2][MAX_GROUP_SATELLITES];
+    };
+
+    Group *find(GNSSSystem::Type system, uint8_t signal_id)
+    {
+        for (size_t i = 0; i < group_count_; i++)
+        {
+            if (groups_[i].system == system && groups_[i].signal_id == signal_id)
+                return &groups_[i];
+        }
+        return nullptr;
+    }
+
+    void publish();
+
+    Group groups_[MaxGroups];
+    size_t group_count_;
+    uint32_t sequence_;
+    size_t overflows_;
+    size_t incomplete_;
+
+    GNSSSatellitesInView buffers_[3];
+    uint8_t back_;                 // producer's
+    std::atomic<uint8_t> middle_;  // last published, FRESH until taken
+    uint8_t front_;                // consumer's
+};
+
+template <size_t MaxGroups>
+constexpr size_t BasicGNSSGSVAssembler<MaxGroups>::MAX_GROUPS;
+
+template <size_t MaxGroups>
+constexpr size_t BasicGNSSGSVAssembler<MaxGroups>::MAX_GROUP_SATELLITES;
+
+template <size_t MaxGroups>
+constexpr uint8_t BasicGNSSGSVAssembler<MaxGroups>::INDEX;
+
+template <size_t MaxGroups>
+constexpr uint8_t BasicGNSSGSVAssembler<MaxGroups>::FRESH;
+
+template <size_t MaxGroups>
+typename BasicGNSSGSVAssembler<MaxGroups>::Update
+BasicGNSSGSVAssembler<MaxGroups>::add(const GNSSNMEAFields &fields)
+{
+    GNSSNMEAGSV gsv;
+    if (!GNSSNMEADecoder::decode(fields, gsv))
+    {
+        return IGNORED;
+    }
+
+    GNSSSystem::Type system = fields.system();
+    Group *group = find(system, gsv.signal_id);
+    if (!group)
+    {
+        if (gsv.sentence != 1)
+        {
+            incomplete_++;
+            return IGNORED;
+        }
+        if (group_count_ == MaxGroups)
+        {
+            overflows_++;
+            return IGNORED;
+        }
+
+        group = &groups_[group_count_++];
+        group->system = system;
+        group->signal_id = gsv.signal_id;
+        group->current = 0;
+        group->sentences = 0;
+        group->counts[0] = 0;
+    }
+
+    uint8_t pending = group->current ^ 1;
+    if (gsv.sentence == 1)
+    {
+        if (group->sentences)
+            incomplete_++;
+        group->sentences = gsv.sentences;
+        group->next = 1;
+        group->counts[pending] = 0;
+    }
+    else if (gsv.sentence != group->next || gsv.sentences != group->sentences)
+    {
+        if (group->sentences)
+            incomplete_++;
+        group->sentences = 0;
+        return IGNORED;
+    }
+
+    for (size_t i = 0; i < gsv.count && group->counts[pending] < MAX_GROUP_SATELLITES; i++)
+        group->satellites[pending][group->counts[pending]++] = gsv.satellites[i];
+    group->next++;
+
+    if (gsv.sentence < gsv.sentences)
+    {
+        return ACCEPTED;
+    }
+
+    group->current = pending;
+    group->sentences = 0;
+    publish();
+    return PUBLISHED;
+}
+
+template <size_t MaxGroups>
+void BasicGNSSGSVAssembler<MaxGroups>::publish()
+{
+    GNSSSatellitesInView &snapshot = buffers_[back_];
+    size_t count = 0;
+    for (size_t i = 0; i < group_count_; i++)
+    {
+        const Group &group = groups_[i];
+        size_t n = group.counts[group.current];
+        if (count + n > GNSSSatellitesInView::MAX_SATELLITES)
+        {
+            n = GNSSSatellitesInView::MAX_SATELLITES - count;
+            overflows_++;
+        }
+        memcpy(snapshot.satellites + count, group.satellites[group.current], n * sizeof(GNSSSatelliteInView));
+        count += n;
+    }
+    snapshot.count = count;
+    snapshot.sequence = ++sequence_;
+
+    back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX;
+}
+
+typedef BasicGNSSGSVAssembler<> GNSSGSVAssembler;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "GNSSParser.h"
+#include "GNSSRTCM3.h"
+
+// Observations of one MSM4, MSM5, MSM6 or MSM7 message, one entry per cell
+// (satellite / signal pair), laid out as structure of arrays so a pass over
+// one quantity walks one contiguous array. Capacity is fixed by the format:
+// at most 64 satellites and 64 cells, so nothing is allocated.
+//
+// Quantities a message does not carry, or marks invalid, are NaN.
+struct GNSSMSMObservations
+{
+    static constexpr size_t MAX_SATELLITES = 64;
+    static constexpr size_t MAX_CELLS = 64;
+
+    // Header
+    uint16_t message_number;
+    uint16_t station_id;
+    GNSSSystem::Type system;
+    uint8_t msm_type;           // 4 to 7
+    uint32_t epoch_time;        // see GNSSRTCM3Header::msmEpochTime()
+    bool multiple_message;      // DF393
+    uint8_t iods;               // DF409
+    uint8_t clock_steering;     // DF411
+    uint8_t external_clock;     // DF412
+    bool smoothing;             // DF417
+    uint8_t smoothing_interval; // DF418
+
+    // Satellites, in mask order
+    size_t satellite_count;
+    uint8_t satellite_id[MAX_SATELLITES];   // 1 to 64, PRN or slot number
+    uint8_t satellite_info[MAX_SATELLITES]; // extended info (MSM5/7), GLONASS frequency channel + 7
+
+    // Cells, satellite by satellite, signals in mask order
+    size_t cell_count;
+    uint8_t cell_satellite[MAX_CELLS]; // index into the satellite arrays
+    uint8_t signal_id[MAX_CELLS];      // 1 to 32, meaning depends on the system
+    double pseudorange[MAX_CELLS];     // m
+    double phaserange[MAX_CELLS];      // m, carrier phase times wavelength
+    double phaserange_rate[MAX_CELLS]; // m/s (MSM5/7), the Doppler is -rate / wavelength
+    float cnr[MAX_CELLS];              // dB-Hz, 0 when not measured
+    uint16_t lock_time[MAX_CELLS];     // indicator, DF402 (MSM4/5) or DF407 (MSM6/7)
+    bool half_cycle[MAX_CELLS];        // DF420, half-cycle ambiguity unresolved
+};
+
+class GNSSMSMDecoder
+{
+public:
+    // Speed of light, m/s, as used for the range fields
+    static constexpr double SPEED_OF_LIGHT = 299792458.0;
+
+    // Decodes a whole frame, from its 0xD3 preamble. Returns false for a
+    // message other than MSM4-7 or a payload too short for its masks.
+    static bool decode(const uint8_t *frame, size_t length, GNSSMSMObservations &observations);
+
+    // A wrapped view is first copied to the stack
+    static bool decode(const GNSSParserBase::MessageView &view, GNSSMSMObservations &observations);
+
+    // Carrier frequency in Hz of an MSM signal ID, 0 when unknown. GLONASS
+    // FDMA signals need the frequency channel (-7 to 6), which MSM5/7 carry as
+    // satellite_info - 7.
+    static double carrierFrequency(GNSSSystem::Type system, uint8_t signal_id, int glonass_channel = 0);
+};
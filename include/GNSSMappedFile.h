@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Read-only view of a whole capture file. On POSIX hosts the file is memory
+// mapped, so parsing reads straight from the page cache; elsewhere it is read
+// into a heap buffer. valid() is false when the file cannot be opened.
+class GNSSMappedFile
+{
+public:
+    explicit GNSSMappedFile(const char *path);
+    ~GNSSMappedFile();
+
+    GNSSMappedFile(const GNSSMappedFile &) = delete;
+    GNSSMappedFile &operator=(const GNSSMappedFile &) = delete;
+
+    bool valid() const { return valid_; }
+    bool mapped() const { return mapped_; }
+    const uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    bool valid_ = false;
+    bool mapped_ = false;
+};
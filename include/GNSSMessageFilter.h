@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Which messages a parser passes on, decided from the first bytes of a frame
+// before any CRC or checksum work: RTCM3 by message number, over a bit set of
+// all 4096, NMEA by address, either a sentence formatter of any talker
+// ("GGA") or a whole address ("GPGSV", "PUBX"), and UBX by class or by class
+// and ID.
+//
+// Each protocol passes everything until its first allow call, and from then
+// on only what was allowed; a block call passes none of it.
+//
+// A rejected frame is still checked by default, so a false preamble is
+// resolved as before and only a valid frame is jumped over whole. With
+// setSkipRejected(true) it is skipped by its length unchecked, saving the CRC
+// or checksum, at the price of also skipping whatever a corrupted header
+// claims to cover.
+class GNSSMessageFilter
+{
+public:
+    static constexpr size_t MAX_NMEA_ADDRESSES = 16;
+    static constexpr size_t MAX_ADDRESS_LENGTH = 5;
+    static constexpr size_t MAX_UBX_MESSAGES = 16;
+
+    // Frame bytes the decision is taken on: preamble, length and message
+    // number, '$', address and the ',' after it, or sync, class, ID and
+    // length
+    static constexpr size_t RTCM3_HEAD_LENGTH = 5;
+    static constexpr size_t NMEA_HEAD_LENGTH = 1 + MAX_ADDRESS_LENGTH + 1;
+    static constexpr size_t UBX_HEAD_LENGTH = 6;
+
+    GNSSMessageFilter() { clear(); }
+
+    // Passes everything, checked
+    void clear();
+
+    void allowRTCM3(uint16_t number) { allowRTCM3(number, number); }
+    void allowRTCM3(uint16_t first, uint16_t last);
+    void blockRTCM3();
+
+    // False for an address of more than MAX_ADDRESS_LENGTH characters or a
+    // full table
+    bool allowNMEA(const char *address);
+    void blockNMEA();
+
+    // A whole class, or one message of it; false for a full table
+    void allowUBX(uint8_t message_class);
+    bool allowUBX(uint8_t message_class, uint8_t id);
+    void blockUBX();
+
+    void setSkipRejected(bool skip) { skip_rejected_ = skip; }
+    bool skipRejected() const { return skip_rejected_; }
+
+    // Message number 0 stands for frames too short to hold one
+    bool passesRTCM3(uint16_t number) const
+    {
+        return !rtcm3_filtered_ || (number < 4096 && ((rtcm3_[number >> 5] >> (number & 31)) & 1));
+    }
+
+    // address holds the bytes after the '$' or '!', at most length of them
+    bool passesNMEA(const uint8_t *address, size_t length) const;
+
+    bool passesUBX(uint8_t message_class, uint8_t id) const;
+
+private:
+    bool rtcm3_filtered_;
+    bool nmea_filtered_;
+    bool ubx_filtered_;
+    bool skip_rejected_;
+    uint8_t nmea_count_;
+    uint8_t nmea_lengths_[MAX_NMEA_ADDRESSES];
+    char nmea_[MAX_NMEA_ADDRESSES][MAX_ADDRESS_LENGTH];
+    uint8_t ubx_count_;
+    uint16_t ubx_[MAX_UBX_MESSAGES]; // class << 8 | ID
+    uint32_t ubx_classes_[256 / 32];
+    uint32_t rtcm3_[4096 / 32];
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stddef.h>
+#include <array>
+
+// Fixed-capacity FIFO stored inline, without any heap allocation. Used for the
+// descriptors of framed messages waiting in the parser's ring buffer.
+//
+// BasicGNSSParser only needs push(), peek(), at(), size(), empty(), pop(count)
+// and clear(); GNSSSPSCQueue provides the same for two threads.
+template <class T, size_t Capacity>
+class GNSSMessageQueue
+{
+public:
+    static_assert(Capacity > 0, "Queue must hold at least one element");
+
+    static constexpr size_t CAPACITY = Capacity;
+
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == Capacity; }
+    size_t size() const { return size_; }
+
+    // Returns false, leaving the queue untouched, when it is full
+    bool push(const T &value)
+    {
+        if (full())
+            return false;
+
+        items_[wrap(head_ + size_)] = value;
+        size_++;
+        return true;
+    }
+
+    const T &front() const { return items_[head_]; }
+
+    // Front element, or nullptr when the queue is empty
+    const T *peek() const { return empty() ? nullptr : &items_[head_]; }
+
+    // i-th element from the front, i < size()
+    const T &at(size_t i) const { return items_[wrap(head_ + i)]; }
+
+    void pop() { pop(1); }
+
+    void pop(size_t count)
+    {
+        if (count > size_)
+            count = size_;
+
+        head_ = wrap(head_ + count);
+        size_ -= count;
+    }
+
+    void clear()
+    {
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    static size_t wrap(size_t index)
+    {
+        return (Capacity & (Capacity - 1)) == 0 ? index & (Capacity - 1) : index % Capacity;
+    }
+
+    std::array<T, Capacity> items_{};
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+template <class T, size_t Capacity>
+constexpr size_t GNSSMessageQueue<T, Capacity>::CAPACITY;
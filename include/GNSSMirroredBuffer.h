@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Memory mapped twice back to back: data()[i] and data()[i + size()] are the
+// same byte, so any run of up to size() bytes starting anywhere in the first
+// mapping is contiguous. Linux only (memfd); elsewhere, or when size() is not
+// a multiple of the page size, valid() is false.
+class GNSSMirroredBuffer
+{
+public:
+    explicit GNSSMirroredBuffer(size_t size);
+    ~GNSSMirroredBuffer();
+
+    GNSSMirroredBuffer(const GNSSMirroredBuffer &) = delete;
+    GNSSMirroredBuffer &operator=(const GNSSMirroredBuffer &) = delete;
+
+    bool valid() const { return data_ != nullptr; }
+    uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+};
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "GNSSParser.h"
+#include "GNSSRTCM3.h"
+
+// One field of a sentence, pointing into the sentence itself
+struct GNSSNMEAField
+{
+    const char *data;
+    size_t length;
+
+    bool empty() const { return length == 0; }
+};
+
+// Splits an NMEA sentence into fields in a single pass, recording where
+// each one starts; nothing is copied or terminated. Field 0 is the address
+// ("GPGGA"), the checksum is not a field. Empty fields are kept, so field
+// numbers match the sentence definitions.
+//
+// The accessors parse with the locale-independent readers below; missing
+// or malformed numbers come out as NaN.
+class GNSSNMEAFields
+{
+public:
+    // Fields past this are dropped
+    static constexpr size_t MAX_FIELDS = 64;
+
+    // sentence starts at its '$' or '!'; the checksum and line end may be
+    // left out
+    GNSSNMEAFields(const char *sentence, size_t length) { split(sentence, length); }
+
+    explicit GNSSNMEAFields(const GNSSParserBase::Message &message)
+    {
+        split(reinterpret_cast<const char *>(message.data), message.length);
+    }
+
+    // A wrapped view is first copied into the object
+    explicit GNSSNMEAFields(const GNSSParserBase::MessageView &view);
+
+    // Fields point into the sentence, or into the object for a wrapped view
+    GNSSNMEAFields(const GNSSNMEAFields &) = delete;
+    GNSSNMEAFields &operator=(const GNSSNMEAFields &) = delete;
+
+    size_t count() const { return count_; }
+
+    // An empty field past the last one
+    GNSSNMEAField field(size_t index) const
+    {
+        if (index >= count_)
+            return GNSSNMEAField{data_, 0};
+        return GNSSNMEAField{data_ + begin_[index], static_cast<size_t>(begin_[index + 1] - begin_[index] - 1)};
+    }
+
+    // Sentence formatter ("GGA") of the address, whatever the talker
+    bool is(const char *formatter) const;
+
+    // System of the talker: GP, GL, GA, GB / BD, GQ / QZ, GI. NONE for GN and
+    // anything else.
+    GNSSSystem::Type system() const;
+
+    // First character of the field, '\0' when empty
+    char character(size_t index) const
+    {
+        GNSSNMEAField f = field(index);
+        return f.length ? f.data[0] : '\0';
+    }
+
+    double number(size_t index) const;
+    uint32_t integer(size_t index, uint32_t missing = 0) const;
+
+    // ddmm.mmmm / dddmm.mmmm followed by its N/S/E/W field, in degrees,
+    // negative south and west
+    double coordinate(size_t index) const;
+
+    // hhmmss.ss in seconds of the UTC day
+    double time(size_t index) const;
+
+    // Readers for a field's characters: false, with value untouched, for an
+    // empty field or anything but the expected digits. Decimals take an
+    // optional sign and fraction, no exponent. Up to 15 significant digits
+    // they are rounded once and match strtod(). Up to 19 digits are kept, but
+    // a mantissa above 2^53 is rounded before the scaling rounds it again.
+    static bool parseNumber(const char *data, size_t length, double &value);
+    static bool parseInteger(const char *data, size_t length, uint32_t &value);
+    static bool parseCoordinate(const char *data, size_t length, char hemisphere, double &degrees);
+    static bool parseTime(const char *data, size_t length, double &seconds);
+
+private:
+    void split(const char *sentence, size_t length);
+
+    const char *data_;
+    size_t count_;
+    uint16_t begin_[MAX_FIELDS + 1]; // field i spans begin_[i] to begin_[i + 1] - 1
+    char copy_[GNSSParserBase::MAX_NMEA_LENGTH];
+};
+
+// Fix data
+struct GNSSNMEAGGA
+{
+    double time;      // s of the UTC day
+    double latitude;  // degrees
+    double longitude; // degrees
+    uint8_t quality;  // 0 no fix, 1 GPS, 2 DGPS, 4 RTK fixed, 5 RTK float, ...
+    uint8_t satellites;
+    double hdop;
+    double altitude;         // m above mean sea level
+    double geoid_separation; // m
+    double correction_age;   // s, NaN without differential corrections
+    uint16_t reference_station;
+};
+
+// Recommended minimum data
+struct GNSSNMEARMC
+{
+    double time; // s of the UTC day
+    bool valid;  // status A
+    double latitude;
+    double longitude;
+    double speed;  // knots
+    double course; // degrees true
+    uint8_t day, month;
+    uint16_t year; // 1980 to 2079
+    double magnetic_variation; // degrees, negative west
+    char mode;       // A, D, E, F, M, N, R, S; '\0' before NMEA 2.3
+    char nav_status; // NMEA 4.1, '\0' when absent
+};
+
+// DOP and active satellites
+struct GNSSNMEAGSA
+{
+    static constexpr size_t MAX_SATELLITES = 12;
+
+    char selection; // M manual, A automatic
+    uint8_t fix;    // 1 none, 2 2D, 3 3D
+    uint8_t satellite_count;
+    uint16_t satellites[MAX_SATELLITES]; // IDs of the satellites used
+    double pdop, hdop, vdop;
+    uint8_t system_id; // NMEA 4.1 GNSS system ID, 0 when absent
+};
+
+// Course and speed over ground
+struct GNSSNMEAVTG
+{
+    double course;          // degrees true
+    double magnetic_course; // degrees magnetic
+    double speed_knots;
+    double speed_kmh;
+    char mode;
+};
+
+// Pseudorange error statistics
+struct GNSSNMEAGST
+{
+    double time; // s of the UTC day
+    double rms;  // of the pseudorange residuals, m
+    double semi_major, semi_minor; // error ellipse, 1 sigma, m
+    double orientation;            // of the semi-major axis, degrees from true north
+    double latitude_sigma, longitude_sigma, altitude_sigma; // m
+};
+
+// One satellite of a GSV sentence, 8 bytes
+struct GNSSSatelliteInView
+{
+    static constexpr int8_t UNKNOWN_ELEVATION = -128;
+    static constexpr uint16_t UNKNOWN_AZIMUTH = 0xFFFF;
+
+    uint16_t id;      // satellite ID as numbered by the talker
+    uint16_t azimuth; // degrees true
+    int8_t elevation; // degrees
+    uint8_t snr;      // C/N0, dB-Hz, 0 when not tracked
+    GNSSSystem::Type system;
+    uint8_t signal_id; // NMEA 4.1 signal ID, 0 when absent
+};
+
+// Satellites in view, one sentence of a group
+struct GNSSNMEAGSV
+{
+    static constexpr size_t MAX_SATELLITES = 4;
+
+    uint8_t sentences; // in the group, 1 to 9
+    uint8_t sentence;  // 1 to sentences
+    uint8_t in_view;   // satellites in the whole group
+    uint8_t signal_id;
+    uint8_t count;     // satellites in this sentence
+    GNSSSatelliteInView satellites[MAX_SATELLITES];
+};
+
+// Typed decoders over split fields. Each returns false for another sentence
+// and leaves the output untouched; fields left empty decode as NaN or 0.
+class GNSSNMEADecoder
+{
+public:
+    static bool decode(const GNSSNMEAFields &fields, GNSSNMEAGGA &gga);
+    static bool decode(const GNSSNMEAFields &fields, GNSSNMEARMC &rmc);
+    static bool decode(const GNSSNMEAFields &fields, GNSSNMEAGSA &gsa);
+    static bool decode(const GNSSNMEAFields &fields, GNSSNMEAVTG &vtg);
+    static bool decode(const GNSSNMEAFields &fields, GNSSNMEAGST &gst);
+
+    // Also false for a malformed sequence number or satellite count
+    static bool decode(const GNSSNMEAFields &fields, GNSSNMEAGSV &gsv);
+};
@@ -3,8 +3,9 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stddef.h>
-#include <queue>
+#include <string.h>
 #include <array>
+#include <algorithm>
 
 #if defined(ARDUINO)
 #include <Arduino.h>
@@ -13,72 +14,784 @@ typedef uint8_t byte;
 #define PROGMEM
 #endif
 
-class GNSSParser
+// Print NMEA sentences rejected by the checksum check
+#ifndef GNSS_PARSER_LOG_INVALID
+#define GNSS_PARSER_LOG_INVALID 1
+#endif
+
+// Allow the ring buffer to live in a mirrored memfd mapping (Linux hosts)
+#if !defined(GNSS_PARSER_MIRRORED_RING)
+#if defined(__linux__) && !defined(ARDUINO)
+#define GNSS_PARSER_MIRRORED_RING 1
+#else
+#define GNSS_PARSER_MIRRORED_RING 0
+#endif
+#endif
+
+// Keep the counters returned by stats(). Off by default, in which case they
+// are not compiled in at all. Define it for the whole build, as the library
+// instantiates GNSSParser itself.
+#ifndef GNSS_PARSER_STATS
+#define GNSS_PARSER_STATS 0
+#endif
+
+// The parser's layout depends on GNSS_PARSER_STATS and
+// GNSS_PARSER_MIRRORED_RING. Its types live in an inline namespace named after
+// them, so a file built with other settings than the library fails to link
+// instead of sharing a GNSSParser of another layout.
+#if GNSS_PARSER_STATS && GNSS_PARSER_MIRRORED_RING
+#define GNSS_PARSER_LAYOUT gnss_parser_stats_mirrored
+#elif GNSS_PARSER_STATS
+#define GNSS_PARSER_LAYOUT gnss_parser_stats
+#elif GNSS_PARSER_MIRRORED_RING
+#define GNSS_PARSER_LAYOUT gnss_parser_mirrored
+#else
+#define GNSS_PARSER_LAYOUT gnss_parser_plain
+#endif
+
+#if GNSS_PARSER_STATS
+#define GNSS_PARSER_COUNT(counter, n) (stats_.counter += (n))
+#define GNSS_PARSER_COUNT_AT(member, n) (stats_.*(member) += (n))
+#else
+#define GNSS_PARSER_COUNT(counter, n) ((void)0)
+#define GNSS_PARSER_COUNT_AT(member, n) ((void)0)
+#endif
+
+#if GNSS_PARSER_MIRRORED_RING
+#include <memory>
+#include "GNSSMirroredBuffer.h"
+#endif
+
+#include "GNSSFramer.h"
+#include "GNSSMessageFilter.h"
+#include "GNSSMessageQueue.h"
+#include "GNSSParserBase.h"
+#include "GNSSSyncSearch.h"
+
+// Parser for a stream mixing NMEA sentences, RTCM3 frames and UBX frames.
+//
+// BufferSize is the ring buffer size; a power of two turns every wrap into a
+// mask. MaxMessages bounds the queue of framed messages and Protocols selects
+// what is framed (GNSSProtocol bits). Queue holds the descriptors of framed
+// messages (see GNSSMessageQueue). Framers lists the protocols the parser
+// knows (see GNSSFramer.h). GNSSParser is the default 4 KiB / 128 message
+// configuration.
+inline namespace GNSS_PARSER_LAYOUT
+{
+
+template <size_t BufferSize = 4096, size_t MaxMessages = 128, uint32_t Protocols = GNSSProtocol::ALL,
+          template <class, size_t> class Queue = GNSSMessageQueue, class Framers = GNSSDefaultFramers>
+class BasicGNSSParser : public GNSSParserBase
 {
 public:
-    static constexpr size_t BUFFER_SIZE = 4096;
-    static constexpr size_t MAX_MESSAGES = 128;
+    static_assert(BufferSize >= MAX_NMEA_LENGTH, "Buffer must hold a full NMEA sentence");
+    static_assert(MaxMessages > 0, "Queue must hold at least one message");
 
-    struct Message
-    {
-        enum Type
-        {
-            UNKNOWN,
-            NMEA,
-            RTCM3,
-            INVALID
-        };
-
-        Type type;
-        const uint8_t *data;
-        size_t length;
-    };
+    typedef Framers FramerList;
 
-    struct ParseResult
-    {
-        bool valid;
-        bool complete;
-        size_t length;
-        const char *error;
-    };
+    static constexpr size_t BUFFER_SIZE = BufferSize;
+    static constexpr size_t MAX_MESSAGES = MaxMessages;
+    static constexpr uint32_t PROTOCOLS = Protocols;
+    static constexpr unsigned ENABLED_FRAMERS = Framers::enabled(Protocols);
+    // UBX frames may be up to the whole ring
+    static constexpr size_t MAX_MESSAGE_LENGTH = BufferSize < Framers::maxLength(ENABLED_FRAMERS)
+                                                     ? BufferSize
+                                                     : Framers::maxLength(ENABLED_FRAMERS);
+
+    static_assert(Framers::countFirstBytes(ENABLED_FRAMERS, 0) <= GNSSSyncSearch::MAX_SET_SIZE,
+                  "Framers start with too many different bytes to search for");
+    static constexpr GNSSSyncSearch::Set FRAME_STARTS = Framers::firstBytes(ENABLED_FRAMERS);
 
-    GNSSParser();
-    ~GNSSParser() = default;
+    BasicGNSSParser() = default;
+    explicit BasicGNSSParser(Storage storage);
+    ~BasicGNSSParser() = default;
+
+    // A copy holds the same bytes and messages in a ring of its own, mirrored
+    // when the original's is and a mapping can be made
+    BasicGNSSParser(const BasicGNSSParser &other);
+    BasicGNSSParser &operator=(const BasicGNSSParser &other);
+    BasicGNSSParser(BasicGNSSParser &&) = default;
+    BasicGNSSParser &operator=(BasicGNSSParser &&) = default;
 
     bool encode(uint8_t byte);
     bool encode(const uint8_t *buffer, size_t length);
+
+    // Consumes as much of the input as fits, scanning as it goes, and returns
+    // the number of bytes consumed. Stops early only when queued messages
+    // leave no room in the ring.
+    size_t encode_stream(const uint8_t *buffer, size_t length);
+
+    // Consumes the whole input, handing framed messages to handler(view)
+    // whenever the ring fills up and once more at the end. Views are only
+    // valid during the call.
+    template <class Handler>
+    size_t encode_stream(const uint8_t *buffer, size_t length, Handler handler);
+
+    // Push mode: every complete frame goes to sink(view, valid) the moment it
+    // is checked, in place and without being queued. Frames failing their
+    // checksum or CRC are passed with valid == false. Returns the number of
+    // bytes consumed, which is all of them unless queued messages fill the ring.
+    template <class Sink>
+    size_t encode_to(const uint8_t *buffer, size_t length, Sink sink);
+
+    typedef void (*Callback)(void *user, const MessageView *view, bool valid);
+    size_t encode_to(const uint8_t *buffer, size_t length, Callback callback, void *user);
+
     bool available() const;
     size_t available_write_space() const;
+
+    // Copies the front message out and releases it. The copy buffer holds
+    // MAX_MESSAGE_LENGTH bytes, the whole ring when UBX is framed.
     Message getMessage();
     void clear();
 
+    // Zero-copy access: the front message stays valid until release() is called
+    MessageView peekMessage() const;
+    void release();
+
+    // Batch draining: views of up to max_views queued messages, oldest first,
+    // all valid until released together with release(count)
+    size_t peekMessages(MessageView *views, size_t max_views) const;
+    void release(size_t count);
+
+    // Messages framed while the queue was full, and therefore lost
+    size_t dropped() const;
+
+    // True when the mirrored storage was requested and could be mapped
+    bool mirrored() const;
+
+    // Snapshot of the counters, see GNSS_PARSER_STATS
+    Stats stats() const;
+    void resetStats();
+
 private:
-    static uint32_t CRC24Q_TABLE[256];
+    static constexpr bool POWER_OF_TWO = (BufferSize & (BufferSize - 1)) == 0;
 
-    static void generateCRC24QTable(uint32_t table[256]);
-    static uint32_t calculateRTCM3CRC(const uint8_t *data, size_t length);
+    // Positions below run freely modulo PERIOD, a multiple of BufferSize, so
+    // the ring index stays continuous when they roll over. A power of two
+    // divides the size_t range, which then rolls over by itself.
+    static constexpr size_t PERIOD = POWER_OF_TWO ? 0 : SIZE_MAX / 2 / BufferSize * BufferSize;
 
-    struct StoredMessage
+    static size_t advance(size_t pos, size_t count)
     {
-        Message::Type type;
-        size_t start;
-        size_t length;
-        bool valid;
-        const char *error;
-    };
+        pos += count;
+        return POWER_OF_TWO || pos < PERIOD ? pos : pos - PERIOD;
+    }
 
-    std::array<uint8_t, BUFFER_SIZE> buffer_{};
+    static size_t distance(size_t from, size_t to)
+    {
+        return POWER_OF_TWO || to >= from ? to - from : to + PERIOD - from;
+    }
+
+    // Maps a position to an index in the ring
+    static size_t wrap(size_t pos)
+    {
+        return POWER_OF_TWO ? pos & (BufferSize - 1) : pos % BufferSize;
+    }
+
+    std::array<uint8_t, BufferSize> buffer_{};
+#if GNSS_PARSER_MIRRORED_RING
+    std::unique_ptr<GNSSMirroredBuffer> mirror_;
+#endif
+    std::array<uint8_t, MAX_MESSAGE_LENGTH> message_buffer_{};
     size_t write_pos_ = 0;
     size_t read_pos_ = 0;
-    size_t bytes_available_ = 0;
-    std::queue<StoredMessage> message_queue_;
-    size_t earliest_queued_pos_ = 0;
+    Queue<StoredMessage, MaxMessages> message_queue_;
+    size_t dropped_ = 0;
+#if GNSS_PARSER_STATS
+    Stats stats_{};
+#endif
+
+    uint8_t *ring();
+    const uint8_t *ring() const;
+    void copyRing(const BasicGNSSParser &other);
+    size_t contiguous(size_t pos, size_t length) const;
+    MessageView view(const StoredMessage &msg) const;
+    void write(const uint8_t *buffer, size_t length);
+
+    // Sink queueing valid messages for available() / getMessage()
+    struct QueueSink
+    {
+    };
+
+    struct CallbackSink
+    {
+        Callback callback;
+        void *user;
+
+        void operator()(const MessageView &view, bool valid) const { callback(user, &view, valid); }
+    };
 
     void addMessageToQueue(Message::Type type, size_t start, size_t length);
+    void deliver(QueueSink &sink, Message::Type type, size_t start, size_t length, bool valid);
+    template <class Sink>
+    void deliver(Sink &sink, Message::Type type, size_t start, size_t length, bool valid);
+    template <class Sink>
+    size_t fill(const uint8_t *buffer, size_t length, Sink &sink);
     void scanBuffer();
-    bool validateRTCM3Message(size_t start, size_t length);
-    uint8_t calculateNMEAChecksum(size_t start, size_t length);
-    bool validateNMEAMessage(size_t start, size_t length);
-    bool tryParseRTCM3(size_t start_pos, size_t available_bytes, ParseResult &result);
-    bool tryParseNMEA(size_t start_pos, size_t available_bytes, ParseResult &result);
-};
\ No newline at end of file
+    template <class Sink>
+    void scanBuffer(Sink &sink);
+    void startCandidate(unsigned framers);
+    bool passesFilter(const uint8_t *ring, const GNSSFramerEntry &framer) const;
+    void logInvalidMessage(size_t start, size_t length);
+};
+
+typedef BasicGNSSParser<> GNSSParser;
+
+} // inline namespace GNSS_PARSER_LAYOUT
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+constexpr size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::BUFFER_SIZE;
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+constexpr size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::MAX_MESSAGES;
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+constexpr uint32_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::PROTOCOLS;
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+constexpr unsigned BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::ENABLED_FRAMERS;
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+constexpr size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::MAX_MESSAGE_LENGTH;
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+constexpr GNSSSyncSearch::Set BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::FRAME_STARTS;
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::BasicGNSSParser(Storage storage)
+{
+#if GNSS_PARSER_MIRRORED_RING
+    if (storage == MIRRORED_STORAGE)
+    {
+        mirror_.reset(new GNSSMirroredBuffer(BufferSize));
+        if (!mirror_->valid())
+            mirror_.reset();
+    }
+#else
+    (void)storage;
+#endif
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::BasicGNSSParser(const BasicGNSSParser &other)
+    : GNSSParserBase(other),
+      write_pos_(other.write_pos_),
+      read_pos_(other.read_pos_),
+      message_queue_(other.message_queue_),
+      dropped_(other.dropped_)
+#if GNSS_PARSER_STATS
+      ,
+      stats_(other.stats_)
+#endif
+{
+    copyRing(other);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers> &
+BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::operator=(const BasicGNSSParser &other)
+{
+    if (this != &other)
+    {
+        GNSSParserBase::operator=(other);
+        write_pos_ = other.write_pos_;
+        read_pos_ = other.read_pos_;
+        message_queue_ = other.message_queue_;
+        dropped_ = other.dropped_;
+#if GNSS_PARSER_STATS
+        stats_ = other.stats_;
+#endif
+        copyRing(other);
+    }
+    return *this;
+}
+
+// Maps a mirror of its own for a copy of a mirrored parser, falling back to
+// the inline buffer, then takes over the bytes. Messages are positions in the
+// ring, so the queue copies as it is.
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::copyRing(const BasicGNSSParser &other)
+{
+#if GNSS_PARSER_MIRRORED_RING
+    if (!other.mirror_)
+    {
+        mirror_.reset();
+    }
+    else if (!mirror_)
+    {
+        mirror_.reset(new GNSSMirroredBuffer(BufferSize));
+        if (!mirror_->valid())
+            mirror_.reset();
+    }
+#endif
+    memcpy(ring(), other.ring(), BufferSize);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+bool BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::mirrored() const
+{
+#if GNSS_PARSER_MIRRORED_RING
+    return mirror_ != nullptr;
+#else
+    return false;
+#endif
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+uint8_t *BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::ring()
+{
+#if GNSS_PARSER_MIRRORED_RING
+    if (mirror_)
+        return mirror_->data();
+#endif
+    return buffer_.data();
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+const uint8_t *BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::ring() const
+{
+    return const_cast<BasicGNSSParser *>(this)->ring();
+}
+
+// Number of bytes from pos that can be read or written as one run, at most length
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::contiguous(size_t pos, size_t length) const
+{
+#if GNSS_PARSER_MIRRORED_RING
+    if (mirror_)
+        return length;
+#endif
+    return std::min(length, BufferSize - wrap(pos));
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::addMessageToQueue(Message::Type type, size_t start, size_t length)
+{
+    if (!message_queue_.push({type, start, length}))
+    {
+        dropped_++;
+        GNSS_PARSER_COUNT(queue_drops, 1);
+    }
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::logInvalidMessage(size_t start, size_t length)
+{
+    uint8_t log_buffer[256];
+    auto len = std::min(length - 1, sizeof(log_buffer) - 1);
+    size_t first = contiguous(start, len);
+    memcpy(log_buffer, ring() + wrap(start), first);
+    memcpy(log_buffer + first, ring(), len - first);
+
+    log_buffer[len] = 0;
+    printf("Invalid message: %s\n", log_buffer);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::deliver(QueueSink &, Message::Type type, size_t start, size_t length, bool valid)
+{
+    if (valid)
+    {
+        addMessageToQueue(type, start, length);
+    }
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+template <class Sink>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::deliver(Sink &sink, Message::Type type, size_t start, size_t length, bool valid)
+{
+    StoredMessage msg = {type, start, length};
+    sink(view(msg), valid);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::scanBuffer()
+{
+    QueueSink sink;
+    scanBuffer(sink);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+template <class Sink>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::scanBuffer(Sink &sink)
+{
+    uint8_t *ring = this->ring();
+
+    while (distance(read_pos_, write_pos_) != scan_.searched)
+    {
+        if (scan_.candidate == Message::Type::UNKNOWN)
+        {
+            // One lookup gives every enabled framer a frame can start with this byte
+            unsigned framers = Framers::FIRST_BYTE[ring[wrap(read_pos_)]] & ENABLED_FRAMERS;
+            if (!framers)
+            {
+                // Jump straight to the next possible preamble
+                size_t span = contiguous(read_pos_, distance(read_pos_, write_pos_));
+                size_t skipped = 1 + GNSSSyncSearch::find(ring + wrap(read_pos_) + 1, span - 1, FRAME_STARTS);
+                read_pos_ = advance(read_pos_, skipped);
+                GNSS_PARSER_COUNT(bytes_skipped, skipped);
+                continue;
+            }
+            startCandidate(framers);
+        }
+
+        // Feed the candidate the next contiguous run of unexamined bytes
+        const GNSSFramerEntry &framer = Framers::ENTRIES[scan_.framer];
+        size_t pos = advance(read_pos_, scan_.searched);
+        size_t span = contiguous(pos, distance(pos, write_pos_));
+        ParseResult result;
+
+        if (filter_ && scan_.filter == FILTER_UNDECIDED)
+        {
+            // Stop at the end of the header and decide before the rest is checked
+            if (scan_.searched >= framer.filter_head_length)
+                scan_.filter = passesFilter(ring, framer) ? FILTER_PASSED : FILTER_REJECTED;
+            else
+                span = std::min(span, framer.filter_head_length - scan_.searched);
+        }
+
+        bool skipping = filter_ && scan_.filter == FILTER_REJECTED && filter_->skipRejected() && framer.trusted(scan_);
+        if (skipping)
+            scan_.searched += framer.skip(scan_, ring + wrap(pos), span, BufferSize, result);
+        else
+            scan_.searched += framer.scan(scan_, ring + wrap(pos), span, BufferSize, result);
+
+        if (!result.complete)
+        {
+            // Wait for more bytes
+            continue;
+        }
+
+        // A sentence shorter than the header is decided once complete
+        if (filter_ && scan_.filter == FILTER_UNDECIDED && result.valid)
+            scan_.filter = passesFilter(ring, framer) ? FILTER_PASSED : FILTER_REJECTED;
+
+        if (filter_ && scan_.filter == FILTER_REJECTED && result.length > 0 && (result.valid || skipping))
+        {
+            GNSS_PARSER_COUNT(filtered_frames, 1);
+            GNSS_PARSER_COUNT(bytes_filtered, result.length);
+            if (skipping)
+                GNSS_PARSER_COUNT(bytes_unchecked, result.length);
+
+            read_pos_ = advance(read_pos_, result.length);
+            scan_ = ScanState();
+            continue;
+        }
+
+        size_t next = 1;
+        if (result.valid)
+        {
+            GNSS_PARSER_COUNT_AT(framer.frames, 1);
+            deliver(sink, scan_.candidate, read_pos_, result.length, true);
+            next = result.length;
+        }
+        else
+        {
+            if (result.length > 0 && filter_ && scan_.filter == FILTER_REJECTED)
+            {
+                // Rejected before its check failed: filtered, never handed to
+                // a sink. Its length is not trusted, so the scan resumes one
+                // byte on as for any other failed frame
+                GNSS_PARSER_COUNT(filtered_frames, 1);
+            }
+            else if (result.length > 0)
+            {
+                GNSS_PARSER_COUNT_AT(framer.failures, 1);
+#if GNSS_PARSER_LOG_INVALID
+                if (framer.log_invalid)
+                    logInvalidMessage(read_pos_, result.length);
+#endif
+                deliver(sink, scan_.candidate, read_pos_, result.length, false);
+            }
+            else if (scan_.searched > framer.sync_length)
+            {
+                // A candidate failing within its sync bytes is noise
+                GNSS_PARSER_COUNT(invalid_lengths, 1);
+            }
+
+            // Framers later in the list may start with the same byte
+            unsigned others = Framers::FIRST_BYTE[ring[wrap(read_pos_)]] & ENABLED_FRAMERS & ~((2u << scan_.framer) - 1);
+            if (others)
+            {
+                scan_ = ScanState();
+                startCandidate(others);
+                continue;
+            }
+            GNSS_PARSER_COUNT(bytes_skipped, 1);
+        }
+
+        // Resume right after a valid message, or one byte after a rejected
+        // preamble so messages nested in the rejected bytes are still found
+        read_pos_ = advance(read_pos_, next);
+        scan_ = ScanState();
+    }
+}
+
+// Makes the first of the given framers the candidate's
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::startCandidate(unsigned framers)
+{
+    uint8_t index = 0;
+    while (!(framers & (1u << index)))
+        index++;
+
+    scan_.framer = index;
+    scan_.candidate = Framers::ENTRIES[index].type;
+}
+
+// Filter decision on the candidate's first bytes, which may wrap the ring
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+bool BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::passesFilter(const uint8_t *ring, const GNSSFramerEntry &framer) const
+{
+    uint8_t head[MAX_HEAD_LENGTH];
+    size_t count = std::min(scan_.searched, framer.filter_head_length);
+    for (size_t i = 0; i < count; i++)
+        head[i] = ring[wrap(read_pos_ + i)];
+
+    return framer.passes(*filter_, head, count, scan_);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+bool BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::encode(uint8_t byte)
+{
+    // First, calculate available space
+    size_t available = available_write_space();
+    if (available == 0)
+    {
+        GNSS_PARSER_COUNT(write_rejections, 1);
+        return false; // No space available without overwriting queued data
+    }
+
+    ring()[wrap(write_pos_)] = byte;
+    write_pos_ = advance(write_pos_, 1);
+    GNSS_PARSER_COUNT(bytes_scanned, 1);
+
+    scanBuffer();
+    return !message_queue_.empty();
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+bool BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::encode(const uint8_t *buffer, size_t length)
+{
+    if (length > BufferSize)
+    {
+        GNSS_PARSER_COUNT(write_rejections, 1);
+        return false; // Buffer too large to process
+    }
+
+    size_t available = available_write_space();
+    if (length > available)
+    {
+        GNSS_PARSER_COUNT(write_rejections, 1);
+        return false; // Not enough space without overwriting queued data
+    }
+
+    write(buffer, length);
+    scanBuffer();
+    return true;
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::encode_stream(const uint8_t *buffer, size_t length)
+{
+    QueueSink sink;
+    return fill(buffer, length, sink);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+template <class Handler>
+size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::encode_stream(const uint8_t *buffer, size_t length, Handler handler)
+{
+    MessageView views[16];
+    size_t consumed = 0;
+
+    do
+    {
+        consumed += encode_stream(buffer + consumed, length - consumed);
+
+        size_t count;
+        while ((count = peekMessages(views, 16)) > 0)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                handler(views[i]);
+            }
+            release(count);
+        }
+    } while (consumed < length);
+
+    return consumed;
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+template <class Sink>
+size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::encode_to(const uint8_t *buffer, size_t length, Sink sink)
+{
+    return fill(buffer, length, sink);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::encode_to(const uint8_t *buffer, size_t length, Callback callback, void *user)
+{
+    CallbackSink sink = {callback, user};
+    return fill(buffer, length, sink);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+template <class Sink>
+size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::fill(const uint8_t *buffer, size_t length, Sink &sink)
+{
+    size_t consumed = 0;
+
+    // Scanning frees the space of skipped and delivered bytes, so keep
+    // filling until only queued messages are left in the ring
+    while (consumed < length)
+    {
+        size_t count = std::min(length - consumed, available_write_space());
+        if (count == 0)
+        {
+            break;
+        }
+
+        write(buffer + consumed, count);
+        scanBuffer(sink);
+        consumed += count;
+    }
+
+    return consumed;
+}
+
+// Copies into the circular buffer, in two runs if it wraps
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::write(const uint8_t *buffer, size_t length)
+{
+    size_t first = contiguous(write_pos_, length);
+    memcpy(ring() + wrap(write_pos_), buffer, first);
+    memcpy(ring(), buffer + first, length - first);
+    write_pos_ = advance(write_pos_, length);
+    GNSS_PARSER_COUNT(bytes_scanned, length);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+bool BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::available() const
+{
+    return !message_queue_.empty();
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+typename BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::Message
+BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::getMessage()
+{
+    MessageView view = peekMessage();
+    if (view.type == Message::Type::UNKNOWN)
+    {
+        return {Message::Type::UNKNOWN, nullptr, 0};
+    }
+
+    size_t length = view.copyTo(message_buffer_.data());
+    release();
+
+    return {view.type, message_buffer_.data(), length};
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+typename BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::MessageView
+BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::peekMessage() const
+{
+    const StoredMessage *front = message_queue_.peek();
+    if (!front)
+    {
+        return {Message::Type::UNKNOWN, nullptr, 0, nullptr, 0};
+    }
+
+    return view(*front);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::peekMessages(MessageView *views, size_t max_views) const
+{
+    size_t count = std::min(max_views, message_queue_.size());
+    for (size_t i = 0; i < count; i++)
+    {
+        views[i] = view(message_queue_.at(i));
+    }
+
+    return count;
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+typename BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::MessageView
+BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::view(const StoredMessage &msg) const
+{
+    size_t first_length = contiguous(msg.start, msg.length);
+    size_t second_length = msg.length - first_length;
+
+    return {msg.type,
+            ring() + wrap(msg.start), first_length,
+            second_length ? ring() : nullptr, second_length};
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::release()
+{
+    message_queue_.pop();
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::release(size_t count)
+{
+    message_queue_.pop(count);
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::dropped() const
+{
+    return dropped_;
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+typename BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::Stats
+BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::stats() const
+{
+#if GNSS_PARSER_STATS
+    return stats_;
+#else
+    return Stats();
+#endif
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::resetStats()
+{
+#if GNSS_PARSER_STATS
+    stats_ = Stats();
+#endif
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+size_t BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::available_write_space() const
+{
+    // The oldest queued message pins the ring, otherwise the scan position
+    const StoredMessage *front = message_queue_.peek();
+    if (!front)
+    {
+        return BufferSize - distance(read_pos_, write_pos_);
+    }
+    else
+    {
+        return BufferSize - distance(front->start, write_pos_);
+    }
+}
+
+template <size_t BufferSize, size_t MaxMessages, uint32_t Protocols, template <class, size_t> class Queue, class Framers>
+void BasicGNSSParser<BufferSize, MaxMessages, Protocols, Queue, Framers>::clear()
+{
+    message_queue_.clear();
+    dropped_ = 0;
+    write_pos_ = 0;
+    read_pos_ = 0;
+    scan_ = ScanState();
+}
+
+extern template class BasicGNSSParser<>;
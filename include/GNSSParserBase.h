@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "GNSSMessageFilter.h"
+
+// Protocols a parser frames, combined as a bit mask. Bits from USER up are
+// free for framers defined outside the library (see GNSSFramer.h).
+struct GNSSProtocol
+{
+    enum : uint32_t
+    {
+        NMEA = 1 << 0,
+        RTCM3 = 1 << 1,
+        UBX = 1 << 2,
+        USER = 1 << 8,
+        ALL = 0xFFFFFFFF
+    };
+};
+
+// Types and framing state shared by every BasicGNSSParser configuration and
+// by the framers
+class GNSSParserBase
+{
+public:
+    // Spec says it should be 82, but I see valid NMEA sentences which are longer.
+    static constexpr size_t MAX_NMEA_LENGTH = 128;
+    static constexpr size_t MAX_RTCM3_LENGTH = 1029; // header(3) + payload(1023) + crc(3)
+    static constexpr size_t MAX_UBX_LENGTH = 65543;  // header(6) + payload(65535) + checksum(2)
+
+    // Header bytes a framer may collect before it knows the frame length
+    static constexpr size_t MAX_HEAD_LENGTH = 16;
+
+    struct Message
+    {
+        // Values from USER up are free for framers defined outside the library
+        enum Type
+        {
+            UNKNOWN,
+            NMEA,
+            RTCM3,
+            INVALID,
+            UBX,
+            USER = 64
+        };
+
+        Type type;
+        const uint8_t *data;
+        size_t length;
+    };
+
+    // A queued message left in place in the ring buffer. A message that wraps
+    // around the end of the ring comes in two segments, ready for writev().
+    struct MessageView
+    {
+        Message::Type type;
+        const uint8_t *first;
+        size_t first_length;
+        const uint8_t *second; // nullptr unless the message wraps
+        size_t second_length;
+
+        size_t length() const { return first_length + second_length; }
+        size_t copyTo(uint8_t *destination) const;
+    };
+
+    struct ParseResult
+    {
+        bool valid;
+        bool complete;
+        size_t length;
+        const char *error;
+    };
+
+    // Running totals since construction or resetStats(), all zero unless
+    // GNSS_PARSER_STATS is enabled
+    struct Stats
+    {
+        uint64_t bytes_scanned;     // bytes taken into the ring
+        uint64_t bytes_skipped;     // bytes not part of any valid frame
+        uint64_t crc_failures;      // RTCM3 frames failing the CRC-24Q check
+        uint64_t checksum_failures; // NMEA sentences failing the checksum check
+        uint64_t fletcher_failures; // UBX frames failing the Fletcher checksum
+        uint64_t other_failures;    // frames of framers without counters of their own failing their check
+        uint64_t invalid_lengths;   // lengths too long to buffer, NMEA sentences with no end
+        uint64_t queue_drops;       // valid messages lost to a full queue
+        uint64_t write_rejections;  // encode() calls refused for lack of ring space
+        uint64_t nmea_frames;       // valid frames passed on, by type
+        uint64_t rtcm3_frames;
+        uint64_t ubx_frames;
+        uint64_t other_frames;
+        uint64_t filtered_frames;   // frames rejected by the filter, neither queued nor delivered
+        uint64_t bytes_filtered;    // bytes of those frames, bar those failing their check, which count as skipped
+        uint64_t bytes_unchecked;   // of those, bytes skipped without CRC or checksum
+    };
+
+    enum Storage
+    {
+        INLINE_STORAGE,  // std::array member, messages may wrap around its end
+        MIRRORED_STORAGE // memfd mapped twice, every message is contiguous
+    };
+
+    enum FilterDecision : uint8_t
+    {
+        FILTER_UNDECIDED,
+        FILTER_PASSED,
+        FILTER_REJECTED
+    };
+
+    // Framing state of the candidate starting at the scan position, kept
+    // between calls so every received byte is examined only once. The
+    // candidate's framer owns everything but candidate, framer and filter.
+    struct ScanState
+    {
+        Message::Type candidate; // UNKNOWN while looking for a preamble
+        uint8_t framer;          // index of the candidate's framer in the framer list
+        size_t searched;         // bytes of the candidate already examined
+        size_t length;           // frame length once the header is in
+        uint32_t sum;            // running CRC or checksum
+        uint32_t received;       // check bytes read from the frame
+        uint8_t checksum;        // running NMEA XOR
+        bool checksum_ended;
+        uint32_t history; // last NMEA bytes, holds the checksum digits
+        FilterDecision filter;
+        uint8_t head[MAX_HEAD_LENGTH];
+    };
+
+    // Frames the filter rejects are neither queued nor delivered. The filter
+    // is not copied and must outlive its use; nullptr passes everything.
+    void setFilter(const GNSSMessageFilter *filter) { filter_ = filter; }
+    const GNSSMessageFilter *filter() const { return filter_; }
+
+protected:
+    struct StoredMessage
+    {
+        Message::Type type;
+        size_t start;
+        size_t length;
+    };
+
+    ScanState scan_{};
+    const GNSSMessageFilter *filter_ = nullptr;
+};
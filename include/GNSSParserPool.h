@@ -0,0 +1,270 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GNSSParser.h"
+
+// Parses many independent streams (one parser each) on a pool of worker
+// threads. submit() appends bytes to a stream; a stream with pending bytes is
+// queued on one worker and processed by a single worker at a time, so its
+// messages come out in order. Workers that run out of streams steal queued
+// ones from the others.
+//
+// Every frame goes to sink(stream_id, view, valid) on a worker thread, as with
+// BasicGNSSParser::encode_to(). Calls for one stream never overlap; calls for
+// different streams may run concurrently.
+template <class Sink, class Parser = GNSSParser>
+class GNSSParserPool
+{
+public:
+    // Workers defaults to the number of hardware threads
+    GNSSParserPool(size_t streams, Sink sink, size_t workers = 0);
+    ~GNSSParserPool();
+
+    GNSSParserPool(const GNSSParserPool &) = delete;
+    GNSSParserPool &operator=(const GNSSParserPool &) = delete;
+
+    // Thread safe. The bytes are copied.
+    void submit(size_t stream_id, const uint8_t *data, size_t length);
+
+    // Blocks until every byte submitted so far has been parsed
+    void wait();
+
+    size_t streams() const { return streams_.size(); }
+    size_t workers() const { return workers_.size(); }
+
+private:
+    struct Stream
+    {
+        size_t id;
+        Parser parser;
+        std::mutex mutex;
+        std::vector<uint8_t> pending; // guarded by mutex
+        bool scheduled = false;       // guarded by mutex, queued or being parsed
+    };
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Stream *> queue;
+        std::thread thread;
+    };
+
+    // Bytes parsed from one stream before it goes back to the queue, so a
+    // busy stream cannot hold a worker forever
+    static const size_t SLICE = 64 * 1024;
+
+    void schedule(Stream *stream);
+    Stream *take(size_t worker);
+    void run(size_t worker);
+    void parse(Stream *stream, std::vector<uint8_t> &working);
+
+    Sink sink_;
+    std::vector<std::unique_ptr<Stream>> streams_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::mutex idle_mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable all_done_;
+    size_t queued_ = 0;    // guarded by idle_mutex_, streams sitting in worker queues
+    size_t scheduled_ = 0; // guarded by idle_mutex_, streams queued or being parsed
+    bool stop_ = false;
+};
+
+template <class Sink, class Parser>
+GNSSParserPool<Sink, Parser>::GNSSParserPool(size_t streams, Sink sink, size_t workers)
+    : sink_(sink)
+{
+    if (workers == 0)
+    {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < streams; i++)
+    {
+        streams_.push_back(std::unique_ptr<Stream>(new Stream()));
+        streams_.back()->id = i;
+    }
+
+    for (size_t i = 0; i < workers; i++)
+    {
+        workers_.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+
+    for (size_t i = 0; i < workers; i++)
+    {
+        workers_[i]->thread = std::thread(&GNSSParserPool::run, this, i);
+    }
+}
+
+template <class Sink, class Parser>
+GNSSParserPool<Sink, Parser>::~GNSSParserPool()
+{
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        stop_ = true;
+    }
+    work_ready_.notify_all();
+
+    for (auto &worker : workers_)
+    {
+        worker->thread.join();
+    }
+}
+
+template <class Sink, class Parser>
+void GNSSParserPool<Sink, Parser>::submit(size_t stream_id, const uint8_t *data, size_t length)
+{
+    Stream *stream = streams_[stream_id].get();
+    bool idle;
+
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        stream->pending.insert(stream->pending.end(), data, data + length);
+        idle = !stream->scheduled;
+        stream->scheduled = true;
+    }
+
+    if (idle)
+    {
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            scheduled_++;
+        }
+        schedule(stream);
+    }
+}
+
+template <class Sink, class Parser>
+void GNSSParserPool<Sink, Parser>::wait()
+{
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    all_done_.wait(lock, [this]
+                   { return scheduled_ == 0; });
+}
+
+// Queues the stream on its home worker; anyone idle may steal it from there
+template <class Sink, class Parser>
+void GNSSParserPool<Sink, Parser>::schedule(Stream *stream)
+{
+    Worker &home = *workers_[stream->id % workers_.size()];
+    {
+        std::lock_guard<std::mutex> lock(home.mutex);
+        home.queue.push_back(stream);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        queued_++;
+    }
+    work_ready_.notify_one();
+}
+
+// Own queue first, oldest stream first; otherwise steal the newest stream of
+// another worker
+template <class Sink, class Parser>
+typename GNSSParserPool<Sink, Parser>::Stream *GNSSParserPool<Sink, Parser>::take(size_t worker)
+{
+    for (size_t i = 0; i < workers_.size(); i++)
+    {
+        Worker &victim = *workers_[(worker + i) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.queue.empty())
+        {
+            continue;
+        }
+
+        Stream *stream;
+        if (i == 0)
+        {
+            stream = victim.queue.front();
+            victim.queue.pop_front();
+        }
+        else
+        {
+            stream = victim.queue.back();
+            victim.queue.pop_back();
+        }
+        return stream;
+    }
+
+    return nullptr;
+}
+
+template <class Sink, class Parser>
+void GNSSParserPool<Sink, Parser>::run(size_t worker)
+{
+    std::vector<uint8_t> working;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(idle_mutex_);
+            work_ready_.wait(lock, [this]
+                             { return queued_ > 0 || stop_; });
+            if (queued_ == 0)
+            {
+                return;
+            }
+            queued_--;
+        }
+
+        // queued_ counted one stream for us, so some queue holds it
+        Stream *stream = nullptr;
+        while (!stream)
+        {
+            stream = take(worker);
+        }
+
+        parse(stream, working);
+    }
+}
+
+template <class Sink, class Parser>
+void GNSSParserPool<Sink, Parser>::parse(Stream *stream, std::vector<uint8_t> &working)
+{
+    size_t parsed = 0;
+
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            if (stream->pending.empty())
+            {
+                stream->scheduled = false;
+                break;
+            }
+
+            if (parsed >= SLICE)
+            {
+                // Still busy, let the other streams have a turn
+                schedule(stream);
+                return;
+            }
+
+            working.swap(stream->pending);
+        }
+
+        size_t id = stream->id;
+        Sink &sink = sink_;
+        stream->parser.encode_to(working.data(), working.size(), [&](const GNSSParserBase::MessageView &view, bool valid)
+                                 { sink(id, view, valid); });
+        parsed += working.size();
+        working.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    if (--scheduled_ == 0)
+    {
+        all_done_.notify_all();
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "GNSSBitReader.h"
+#include "GNSSParser.h"
+
+// Satellite systems, as told apart by RTCM3 message numbers
+struct GNSSSystem
+{
+    enum Type : uint8_t
+    {
+        NONE,
+        GPS,
+        GLONASS,
+        GALILEO,
+        SBAS,
+        QZSS,
+        BEIDOU,
+        NAVIC
+    };
+};
+
+// Header fields of an RTCM3 frame, decoded on demand from the first payload
+// bytes. Only those bytes are copied in, so a frame can be routed or filtered
+// by type and station without touching the rest of its payload, and a
+// MessageView split by the end of the ring needs no reassembly.
+class GNSSRTCM3Header
+{
+public:
+    // Frame header plus the first 8 payload bytes: message number, station
+    // ID and the MSM epoch time / multiple message bit take 55 bits
+    static constexpr size_t HEAD_LENGTH = 3 + 8;
+
+    // frame points at the 0xD3 preamble of a whole frame
+    GNSSRTCM3Header(const uint8_t *frame, size_t length)
+    {
+        size_t count = length < HEAD_LENGTH ? length : HEAD_LENGTH;
+        memcpy(head_, frame, count);
+        memset(head_ + count, 0, HEAD_LENGTH - count);
+    }
+
+    explicit GNSSRTCM3Header(const GNSSParserBase::Message &message)
+        : GNSSRTCM3Header(message.data, message.length)
+    {
+    }
+
+    explicit GNSSRTCM3Header(const GNSSParserBase::MessageView &view)
+    {
+        size_t first = view.first_length < HEAD_LENGTH ? view.first_length : HEAD_LENGTH;
+        size_t second = view.second_length < HEAD_LENGTH - first ? view.second_length : HEAD_LENGTH - first;
+        memcpy(head_, view.first, first);
+        if (second)
+            memcpy(head_ + first, view.second, second);
+        memset(head_ + first + second, 0, HEAD_LENGTH - first - second);
+    }
+
+    size_t payloadLength() const { return ((head_[1] & 0x03) << 8) | head_[2]; }
+
+    // DF002, 0 when the payload is too short to hold it
+    uint16_t messageNumber() const
+    {
+        return payloadLength() >= 2 ? field(0, 12) : 0;
+    }
+
+    // DF003, for the messages that carry it right after the message number
+    // (see hasStationId()), otherwise 0
+    uint16_t stationId() const
+    {
+        return hasStationId() && payloadLength() >= 3 ? field(12, 12) : 0;
+    }
+
+    bool hasStationId() const { return hasStationId(messageNumber()); }
+
+    // Multiple Signal Messages: 1071-1077 (GPS) up to 1131-1137 (NavIC)
+    bool isMSM() const { return isMSM(messageNumber()); }
+
+    // 1 to 7, 0 for other messages
+    unsigned msmType() const { return isMSM() ? messageNumber() % 10 : 0; }
+
+    GNSSSystem::Type system() const { return system(messageNumber()); }
+
+    // DF004 and friends: GPS, Galileo, SBAS, QZSS and NavIC time of week in
+    // ms, BeiDou time of week in ms of BDT. For GLONASS the top 3 bits are
+    // the day of week (DF416) and the low 27 bits the time of day in ms
+    // (DF034). 0 for non-MSM messages.
+    uint32_t msmEpochTime() const
+    {
+        return isMSM() && payloadLength() >= 7 ? field(24, 30) : 0;
+    }
+
+    // DF393: more MSMs for the same epoch and station follow
+    bool msmMultipleMessage() const
+    {
+        return isMSM() && payloadLength() >= 7 && field(54, 1) != 0;
+    }
+
+    static bool isMSM(uint16_t number)
+    {
+        return number >= 1071 && number <= 1137 && number % 10 >= 1 && number % 10 <= 7;
+    }
+
+    static bool hasStationId(uint16_t number)
+    {
+        return (number >= 1001 && number <= 1013) || number == 1029 || number == 1033 || number == 1230 ||
+               isMSM(number);
+    }
+
+    static GNSSSystem::Type system(uint16_t number)
+    {
+        switch (number)
+        {
+        case 1001: case 1002: case 1003: case 1004: case 1019:
+            return GNSSSystem::GPS;
+        case 1009: case 1010: case 1011: case 1012: case 1020: case 1230:
+            return GNSSSystem::GLONASS;
+        case 1042:
+            return GNSSSystem::BEIDOU;
+        case 1044:
+            return GNSSSystem::QZSS;
+        case 1045: case 1046:
+            return GNSSSystem::GALILEO;
+        }
+
+        if (!isMSM(number))
+            return GNSSSystem::NONE;
+
+        static const GNSSSystem::Type msm[] = {GNSSSystem::GPS, GNSSSystem::GLONASS, GNSSSystem::GALILEO,
+                                               GNSSSystem::SBAS, GNSSSystem::QZSS, GNSSSystem::BEIDOU,
+                                               GNSSSystem::NAVIC};
+        return msm[(number - 1071) / 10];
+    }
+
+private:
+    // Field of the payload, bit offsets counted from its first bit
+    uint32_t field(size_t bit, unsigned count) const
+    {
+        return static_cast<uint32_t>(GNSSBitReader::get(head_ + 3, HEAD_LENGTH - 3, bit, count));
+    }
+
+    uint8_t head_[HEAD_LENGTH];
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+#include <array>
+
+// GNSSMessageQueue for exactly one producer thread, which calls push(), and
+// one consumer thread, which calls at() and pop(). peek(), size() and empty()
+// are safe from either side. Free-running head and tail indices are published
+// with release stores, so an element is fully written before the consumer
+// sees it and fully read before the producer reuses its slot.
+//
+// clear() is not thread safe.
+template <class T, size_t Capacity>
+class GNSSSPSCQueue
+{
+public:
+    static_assert(Capacity > 0, "Queue must hold at least one element");
+
+    static constexpr size_t CAPACITY = Capacity;
+
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() == Capacity; }
+
+    size_t size() const
+    {
+        // Tail first: head only grows, so the difference cannot underflow
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_acquire) - tail;
+    }
+
+    bool push(const T &value)
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        items_[wrap(head)] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Front element, or nullptr when the queue is empty. Seen from the
+    // producer, the element may be released concurrently but its slot is not
+    // reused before the producer's next push().
+    const T *peek() const
+    {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        if (head_.load(std::memory_order_acquire) == tail)
+            return nullptr;
+        return &items_[wrap(tail)];
+    }
+
+    const T &front() const { return items_[wrap(tail_.load(std::memory_order_relaxed))]; }
+
+    // i-th element from the front, i < size()
+    const T &at(size_t i) const { return items_[wrap(tail_.load(std::memory_order_relaxed) + i)]; }
+
+    void pop() { pop(1); }
+
+    void pop(size_t count)
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t available = head_.load(std::memory_order_acquire) - tail;
+        if (count > available)
+            count = available;
+
+        tail_.store(tail + count, std::memory_order_release);
+    }
+
+    void clear()
+    {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static size_t wrap(size_t index)
+    {
+        return (Capacity & (Capacity - 1)) == 0 ? index & (Capacity - 1) : index % Capacity;
+    }
+
+    // Head and tail on separate cache lines so the two threads do not share one
+    std::atomic<size_t> head_{0};
+    char head_padding_[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> tail_{0};
+    char tail_padding_[64 - sizeof(std::atomic<size_t>)];
+    std::array<T, Capacity> items_{};
+};
+
+template <class T, size_t Capacity>
+constexpr size_t GNSSSPSCQueue<T, Capacity>::CAPACITY;
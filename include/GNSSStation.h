@@ -0,0 +1,267 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <type_traits>
+#include "GNSSParser.h"
+#include "GNSSRTCM3.h"
+
+// What a reference station tells about itself: antenna reference point
+// (1005, 1006), antenna and receiver descriptors (1007, 1008, 1033) and
+// GLONASS code-phase biases (1230). Fields of messages not yet received are
+// zero, empty or NaN; `messages` says which arrived.
+struct GNSSStationInfo
+{
+    // Bits of `messages`, one per message number
+    enum Message : uint8_t
+    {
+        MESSAGE_1005 = 0x01,
+        MESSAGE_1006 = 0x02,
+        MESSAGE_1007 = 0x04,
+        MESSAGE_1008 = 0x08,
+        MESSAGE_1033 = 0x10,
+        MESSAGE_1230 = 0x20
+    };
+
+    // String fields hold up to 31 characters, as the format allows
+    static constexpr size_t MAX_STRING = 31;
+
+    uint16_t station_id;
+    uint8_t messages;
+
+    // Antenna reference point, 1005 / 1006
+    double x, y, z;        // ECEF, m
+    double antenna_height; // m above the marker, 1006 only
+    uint8_t itrf_year;     // DF021
+    bool gps, glonass, galileo; // systems served
+    bool reference_station;     // DF141, physical station rather than virtual
+    bool single_oscillator;     // DF142
+    uint8_t quarter_cycle;      // DF364
+
+    // Descriptors, 1007 / 1008 / 1033
+    uint8_t antenna_setup_id;
+    char antenna_descriptor[MAX_STRING + 1];
+    char antenna_serial[MAX_STRING + 1];
+    char receiver_type[MAX_STRING + 1];
+    char receiver_firmware[MAX_STRING + 1];
+    char receiver_serial[MAX_STRING + 1];
+
+    // GLONASS code-phase biases, 1230
+    bool biases_aligned; // DF421
+    double l1_ca_bias, l1_p_bias, l2_ca_bias, l2_p_bias; // m, NaN when not sent
+};
+
+class GNSSStationDecoder
+{
+public:
+    // GNSSStationInfo::Message bit of a message number, 0 for messages that
+    // carry no station metadata
+    static uint8_t messageBit(uint16_t message_number);
+
+    // Decodes a whole frame, from its 0xD3 preamble, into info, leaving the
+    // fields of other messages as they are. Returns false for other messages
+    // or a short payload.
+    static bool decode(const uint8_t *frame, size_t length, GNSSStationInfo &info);
+
+    // A wrapped view is first copied to the stack
+    static bool decode(const GNSSParserBase::MessageView &view, GNSSStationInfo &info);
+
+    // Bits of the other messages writing fields the given one writes too:
+    // 1005 and 1006 the reference point, 1007, 1008 and 1033 the antenna
+    // descriptor
+    static uint8_t overlappingBits(uint8_t bit);
+
+    // Whether a and b agree on the fields of the given message's group
+    static bool sameSharedFields(uint8_t bit, const GNSSStationInfo &a, const GNSSStationInfo &b);
+
+    // CRC-24Q at the end of a framed message
+    static uint32_t frameCRC(const GNSSParserBase::MessageView &view);
+
+    // Clears info for a station that sent nothing yet
+    static void reset(GNSSStationInfo &info, uint16_t station_id);
+};
+
+// Metadata of up to MaxStations reference stations, fed with framed messages.
+//
+// Stations repeat their metadata every few seconds, almost never changed. A
+// repeat is recognised from the frame's header and its CRC-24Q, which the
+// parser has already checked: when message number, station, length and CRC
+// all match the last frame of that message from that station, nothing is
+// decoded. Only a changed frame is decoded into the station's entry and
+// handed to the handler. Messages sharing fields, 1005 and 1006 say, count
+// as changed again once another of them wrote different values there.
+//
+// Lookup by station ID is a direct index over all 4096 IDs.
+template <size_t MaxStations = 16>
+class BasicGNSSStationCache
+{
+public:
+    enum Update
+    {
+        IGNORED,   // no station metadata, malformed, or no room for another station
+        UNCHANGED, // same frame as last time
+        UPDATED    // decoded into the station's entry
+    };
+
+    static constexpr size_t MAX_STATIONS = MaxStations;
+
+    BasicGNSSStationCache() { clear(); }
+
+    BasicGNSSStationCache(const BasicGNSSStationCache &) = delete;
+    BasicGNSSStationCache &operator=(const BasicGNSSStationCache &) = delete;
+
+    // handler(const GNSSStationInfo &info, uint16_t message_number) is called
+    // on UPDATED, with the station's whole entry
+    template <class Handler>
+    Update add(const GNSSParserBase::MessageView &view, Handler handler);
+
+    Update add(const GNSSParserBase::MessageView &view)
+    {
+        return add(view, [](const GNSSStationInfo &, uint16_t) {});
+    }
+
+    // nullptr for a station not heard from
+    const GNSSStationInfo *find(uint16_t station_id) const
+    {
+        return station_id < STATION_IDS && index_[station_id] != NONE ? &entries_[index_[station_id]].info : nullptr;
+    }
+
+    size_t size() const { return count_; }
+
+    // Stations turned away because MaxStations were already cached
+    size_t overflows() const { return overflows_; }
+
+    void clear()
+    {
+        for (size_t i = 0; i < STATION_IDS; i++)
+            index_[i] = NONE;
+        count_ = 0;
+        overflows_ = 0;
+    }
+
+private:
+    static constexpr size_t STATION_IDS = 4096;
+    static constexpr size_t MESSAGE_KINDS = 6;
+
+    typedef typename std::conditional<(MaxStations < 255), uint8_t, uint16_t>::type Index;
+    static constexpr Index NONE = static_cast<Index>(~0);
+
+    // Last frame seen per message kind, length 0 when none
+    struct Seen
+    {
+        uint32_t crc;
+        uint16_t length;
+    };
+
+    struct Entry
+    {
+        GNSSStationInfo info;
+        Seen seen[MESSAGE_KINDS];
+    };
+
+    static unsigned kind(uint8_t bit)
+    {
+        unsigned k = 0;
+        while (bit > 1)
+        {
+            bit >>= 1;
+            k++;
+        }
+        return k;
+    }
+
+    Index index_[STATION_IDS];
+    Entry entries_[MaxStations];
+    size_t count_;
+    size_t overflows_;
+};
+
+template <size_t MaxStations>
+constexpr size_t BasicGNSSStationCache<MaxStations>::MAX_STATIONS;
+
+template <size_t MaxStations>
+constexpr size_t BasicGNSSStationCache<MaxStations>::STATION_IDS;
+
+template <size_t MaxStations>
+constexpr typename BasicGNSSStationCache<MaxStations>::Index BasicGNSSStationCache<MaxStations>::NONE;
+
+template <size_t MaxStations>
+template <class Handler>
+typename BasicGNSSStationCache<MaxStations>::Update
+BasicGNSSStationCache<MaxStations>::add(const GNSSParserBase::MessageView &view, Handler handler)
+{
+    if (view.type != GNSSParserBase::Message::Type::RTCM3)
+    {
+        return IGNORED;
+    }
+
+    GNSSRTCM3Header header(view);
+    uint16_t number = header.messageNumber();
+    uint8_t bit = GNSSStationDecoder::messageBit(number);
+    if (!bit)
+    {
+        return IGNORED;
+    }
+
+    uint16_t station_id = header.stationId();
+    Index index = index_[station_id];
+    Seen *seen = nullptr;
+    uint32_t crc = GNSSStationDecoder::frameCRC(view);
+    uint16_t length = static_cast<uint16_t>(view.length());
+
+    if (index != NONE)
+    {
+        seen = &entries_[index].seen[kind(bit)];
+        if (seen->length == length && seen->crc == crc)
+        {
+            return UNCHANGED;
+        }
+    }
+    else if (count_ == MaxStations)
+    {
+        overflows_++;
+        return IGNORED;
+    }
+
+    // A new station gets the next free entry, which only counts once its
+    // first frame decoded
+    if (index == NONE)
+    {
+        index = static_cast<Index>(count_);
+        GNSSStationDecoder::reset(entries_[index].info, station_id);
+        for (size_t k = 0; k < MESSAGE_KINDS; k++)
+            entries_[index].seen[k].length = 0;
+        seen = &entries_[index].seen[kind(bit)];
+    }
+
+    Entry &entry = entries_[index];
+    GNSSStationInfo before = entry.info;
+    if (!GNSSStationDecoder::decode(view, entry.info))
+    {
+        return IGNORED;
+    }
+
+    // A repeat of another message is only unchanged while the fields it
+    // shares with this one still hold what it wrote
+    uint8_t others = GNSSStationDecoder::overlappingBits(bit);
+    if (others && !GNSSStationDecoder::sameSharedFields(bit, before, entry.info))
+    {
+        for (size_t k = 0; k < MESSAGE_KINDS; k++)
+            if (others & (1u << k))
+                entry.seen[k].length = 0;
+    }
+
+    if (index_[station_id] == NONE)
+    {
+        index_[station_id] = index;
+        count_++;
+    }
+    seen->crc = crc;
+    seen->length = length;
+
+    const GNSSStationInfo &updated = entry.info;
+    handler(updated, number);
+    return UPDATED;
+}
+
+typedef BasicGNSSStationCache<> GNSSStationCache;
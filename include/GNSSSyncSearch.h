@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Finds the next byte that can start a frame, one of a set of up to
+// MAX_SET_SIZE bytes. The parser builds the set from the first bytes of its
+// framers (GNSSFramer.h); FRAME_STARTS holds those of the default framers:
+// the RTCM3 preamble 0xD3, the first UBX sync character 0xB5 and the NMEA
+// '$' / '!'. Used by the scanner to jump over binary traffic and line noise
+// instead of trying every protocol at every position.
+//
+// find() uses AVX2 or SSE2 on x86 (picked at start-up) and NEON on aarch64,
+// with a scalar loop everywhere else.
+class GNSSSyncSearch
+{
+public:
+    enum Engine
+    {
+        SCALAR,
+        SSE2,
+        AVX2,
+        NEON
+    };
+
+    static constexpr size_t MAX_SET_SIZE = 8;
+
+    // The bytes both as a list, for the SIMD compares, and as a 256-bit map
+    struct Set
+    {
+        uint8_t count;
+        uint8_t bytes[MAX_SET_SIZE];
+        uint32_t map[8];
+
+        bool contains(uint8_t c) const
+        {
+            return (map[c >> 5] >> (c & 31)) & 1;
+        }
+    };
+
+    static const Set FRAME_STARTS;
+
+    static bool isSyncByte(uint8_t c)
+    {
+        return FRAME_STARTS.contains(c);
+    }
+
+    // Returns the offset of the first byte of the set, or length if there is none
+    static size_t find(const uint8_t *data, size_t length, const Set &set = FRAME_STARTS)
+    {
+        if (length < 16)
+            return findScalar(data, length, set);
+
+        return findBlock(data, length, set);
+    }
+
+    static size_t findScalar(const uint8_t *data, size_t length, const Set &set = FRAME_STARTS)
+    {
+        size_t i = 0;
+        while (i < length && !set.contains(data[i]))
+            i++;
+        return i;
+    }
+
+    // Individual engines, exposed for testing and benchmarking. An engine not
+    // supported on this CPU falls back to the scalar loop.
+    static size_t findSSE2(const uint8_t *data, size_t length, const Set &set = FRAME_STARTS);
+    static size_t findAVX2(const uint8_t *data, size_t length, const Set &set = FRAME_STARTS);
+    static size_t findNEON(const uint8_t *data, size_t length, const Set &set = FRAME_STARTS);
+
+    static bool supported(Engine engine);
+    static Engine engine();
+
+private:
+    static const Engine SELECTED_ENGINE;
+
+    static Engine initialize();
+    static size_t findBlock(const uint8_t *data, size_t length, const Set &set);
+};
@@ -0,0 +1,311 @@
+#include "GNSSCRC24Q.h"
+
+#if !defined(ARDUINO)
+#define GNSS_CRC24Q_SLICING 1
+#endif
+
+#if !defined(ARDUINO) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GNSS_CRC24Q_PCLMUL 1
+#include <cpuid.h>
+#include <immintrin.h>
+#elif !defined(ARDUINO) && defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO) && defined(__linux__)
+#define GNSS_CRC24Q_PMULL 1
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace
+{
+    const uint32_t POLYNOMIAL = 0x1864CFB;
+
+    // Compile-time table generation, kept to single-return constexpr for C++11
+
+    constexpr uint32_t shiftBits(uint32_t crc, int bits)
+    {
+        return bits == 0 ? crc & 0xFFFFFF
+                         : shiftBits((crc & 0x800000) ? (crc << 1) ^ POLYNOMIAL : crc << 1, bits - 1);
+    }
+
+    constexpr uint32_t tableEntry(uint32_t i)
+    {
+        return shiftBits(i << 16, 8);
+    }
+
+    constexpr uint32_t appendZeroByte(uint32_t crc)
+    {
+        return ((crc << 8) & 0xFFFFFF) ^ tableEntry(crc >> 16);
+    }
+
+    constexpr uint32_t slicingEntry(int k, uint32_t i)
+    {
+        return k == 0 ? tableEntry(i) : appendZeroByte(slicingEntry(k - 1, i));
+    }
+
+#define GNSS_CRC24Q_4(f, i) f(i), f(i + 1), f(i + 2), f(i + 3)
+#define GNSS_CRC24Q_16(f, i) GNSS_CRC24Q_4(f, i), GNSS_CRC24Q_4(f, i + 4), GNSS_CRC24Q_4(f, i + 8), GNSS_CRC24Q_4(f, i + 12)
+#define GNSS_CRC24Q_64(f, i) GNSS_CRC24Q_16(f, i), GNSS_CRC24Q_16(f, i + 16), GNSS_CRC24Q_16(f, i + 32), GNSS_CRC24Q_16(f, i + 48)
+#define GNSS_CRC24Q_256(f) GNSS_CRC24Q_64(f, 0), GNSS_CRC24Q_64(f, 64), GNSS_CRC24Q_64(f, 128), GNSS_CRC24Q_64(f, 192)
+
+#if defined(GNSS_CRC24Q_SLICING)
+#define GNSS_CRC24Q_SLICE0(i) slicingEntry(0, i)
+#define GNSS_CRC24Q_SLICE1(i) slicingEntry(1, i)
+#define GNSS_CRC24Q_SLICE2(i) slicingEntry(2, i)
+#define GNSS_CRC24Q_SLICE3(i) slicingEntry(3, i)
+#define GNSS_CRC24Q_SLICE4(i) slicingEntry(4, i)
+#define GNSS_CRC24Q_SLICE5(i) slicingEntry(5, i)
+#define GNSS_CRC24Q_SLICE6(i) slicingEntry(6, i)
+#define GNSS_CRC24Q_SLICE7(i) slicingEntry(7, i)
+
+    // SLICING_TABLE[k][b] is the CRC of byte b followed by k zero bytes
+    const uint32_t SLICING_TABLE[8][256] = {
+        {GNSS_CRC24Q_256(GNSS_CRC24Q_SLICE0)},
+        {GNSS_CRC24Q_256(GNSS_CRC24Q_SLICE1)},
+        {GNSS_CRC24Q_256(GNSS_CRC24Q_SLICE2)},
+        {GNSS_CRC24Q_256(GNSS_CRC24Q_SLICE3)},
+        {GNSS_CRC24Q_256(GNSS_CRC24Q_SLICE4)},
+        {GNSS_CRC24Q_256(GNSS_CRC24Q_SLICE5)},
+        {GNSS_CRC24Q_256(GNSS_CRC24Q_SLICE6)},
+        {GNSS_CRC24Q_256(GNSS_CRC24Q_SLICE7)},
+    };
+#endif
+
+#if defined(GNSS_CRC24Q_PCLMUL) || defined(GNSS_CRC24Q_PMULL)
+    // Folding constants, x^n mod P
+    const uint64_t X128_MOD_P = 0x6243DA;
+    const uint64_t X192_MOD_P = 0xB22B31;
+    const uint64_t X512_MOD_P = 0x7DB43E;
+    const uint64_t X576_MOD_P = 0xB937A7;
+
+    // Blocks shorter than this are cheaper to run through the tables
+    const size_t CLMUL_MIN_LENGTH = 64;
+#endif
+}
+
+// Generated at compile time so the tables live in flash / rodata
+const uint32_t GNSSCRC24Q::CRC24Q_TABLE[256] = {GNSS_CRC24Q_256(tableEntry)};
+
+const GNSSCRC24Q::Engine GNSSCRC24Q::SELECTED_ENGINE = GNSSCRC24Q::initialize();
+
+GNSSCRC24Q::Engine GNSSCRC24Q::initialize()
+{
+    if (clmulSupported())
+        return CLMUL;
+
+#if defined(GNSS_CRC24Q_SLICING)
+    return SLICING_BY_8;
+#else
+    return TABLE;
+#endif
+}
+
+GNSSCRC24Q::Engine GNSSCRC24Q::engine()
+{
+    return SELECTED_ENGINE;
+}
+
+uint32_t GNSSCRC24Q::updateBlock(uint32_t crc, const uint8_t *data, size_t length)
+{
+    switch (SELECTED_ENGINE)
+    {
+    case CLMUL:
+        return updateClmul(crc, data, length);
+    case SLICING_BY_8:
+        return updateSlicingBy8(crc, data, length);
+    default:
+        return updateTable(crc, data, length);
+    }
+}
+
+uint32_t GNSSCRC24Q::update(uint32_t crc,
+                            const uint8_t *first, size_t first_length,
+                            const uint8_t *second, size_t second_length)
+{
+    crc = update(crc, first, first_length);
+    return update(crc, second, second_length);
+}
+
+uint32_t GNSSCRC24Q::updateTable(uint32_t crc, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        crc = update(crc, data[i]);
+    }
+
+    return crc & 0xFFFFFF;
+}
+
+uint32_t GNSSCRC24Q::updateSlicingBy8(uint32_t crc, const uint8_t *data, size_t length)
+{
+#if defined(GNSS_CRC24Q_SLICING)
+    crc &= 0xFFFFFF;
+
+    while (length >= 8)
+    {
+        // The register lines up with the first three bytes of the block
+        uint32_t b0 = data[0] ^ (crc >> 16);
+        uint32_t b1 = data[1] ^ ((crc >> 8) & 0xFF);
+        uint32_t b2 = data[2] ^ (crc & 0xFF);
+
+        crc = SLICING_TABLE[7][b0] ^ SLICING_TABLE[6][b1] ^
+              SLICING_TABLE[5][b2] ^ SLICING_TABLE[4][data[3]] ^
+              SLICING_TABLE[3][data[4]] ^ SLICING_TABLE[2][data[5]] ^
+              SLICING_TABLE[1][data[6]] ^ SLICING_TABLE[0][data[7]];
+
+        data += 8;
+        length -= 8;
+    }
+#endif
+
+    return updateTable(crc, data, length);
+}
+
+#if defined(GNSS_CRC24Q_PCLMUL)
+
+bool GNSSCRC24Q::clmulSupported()
+{
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    return (ecx & bit_PCLMUL) && (ecx & bit_SSSE3);
+}
+
+// The folding engine treats the data as one big-endian polynomial: each 16
+// byte block is byte-swapped so its first byte holds the highest powers, and
+// blocks are folded forward with multiplications by x^n mod P. The 128-bit
+// remainder is finally reduced through the tables.
+__attribute__((target("pclmul,ssse3"))) static inline __m128i fold(__m128i x, __m128i constants)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(x, constants, 0x01),
+                         _mm_clmulepi64_si128(x, constants, 0x10));
+}
+
+__attribute__((target("pclmul,ssse3"))) uint32_t GNSSCRC24Q::updateClmul(uint32_t crc, const uint8_t *data, size_t length)
+{
+    if (length < CLMUL_MIN_LENGTH || SELECTED_ENGINE != CLMUL)
+        return updateSlicingBy8(crc, data, length);
+
+    const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i fold_by_1 = _mm_set_epi64x(X128_MOD_P, X192_MOD_P);
+    const __m128i fold_by_4 = _mm_set_epi64x(X512_MOD_P, X576_MOD_P);
+
+    const uint8_t *p = data;
+    __m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), reverse);
+    x0 = _mm_xor_si128(x0, _mm_set_epi32(static_cast<int>((crc & 0xFFFFFF) << 8), 0, 0, 0));
+    p += 16;
+
+    if (length >= 128)
+    {
+        __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), reverse);
+        __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16)), reverse);
+        __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 32)), reverse);
+        p += 48;
+
+        while (static_cast<size_t>(data + length - p) >= 64)
+        {
+            x0 = _mm_xor_si128(fold(x0, fold_by_4), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), reverse));
+            x1 = _mm_xor_si128(fold(x1, fold_by_4), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16)), reverse));
+            x2 = _mm_xor_si128(fold(x2, fold_by_4), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 32)), reverse));
+            x3 = _mm_xor_si128(fold(x3, fold_by_4), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 48)), reverse));
+            p += 64;
+        }
+
+        x0 = _mm_xor_si128(fold(x0, fold_by_1), x1);
+        x0 = _mm_xor_si128(fold(x0, fold_by_1), x2);
+        x0 = _mm_xor_si128(fold(x0, fold_by_1), x3);
+    }
+
+    while (static_cast<size_t>(data + length - p) >= 16)
+    {
+        x0 = _mm_xor_si128(fold(x0, fold_by_1), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), reverse));
+        p += 16;
+    }
+
+    uint8_t remainder[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(remainder), _mm_shuffle_epi8(x0, reverse));
+
+    crc = updateSlicingBy8(0, remainder, sizeof(remainder));
+    return updateSlicingBy8(crc, p, data + length - p);
+}
+
+#elif defined(GNSS_CRC24Q_PMULL)
+
+bool GNSSCRC24Q::clmulSupported()
+{
+    return (getauxval(AT_HWCAP) & HWCAP_PMULL) != 0;
+}
+
+// Same folding scheme as the PCLMULQDQ engine, see above
+static inline uint8x16_t loadReversed(const uint8_t *p)
+{
+    uint8x16_t v = vrev64q_u8(vld1q_u8(p));
+    return vextq_u8(v, v, 8);
+}
+
+static inline uint8x16_t fold(uint8x16_t x, uint64_t hi_constant, uint64_t lo_constant)
+{
+    uint64x2_t v = vreinterpretq_u64_u8(x);
+    poly128_t hi = vmull_p64(vgetq_lane_u64(v, 1), hi_constant);
+    poly128_t lo = vmull_p64(vgetq_lane_u64(v, 0), lo_constant);
+    return veorq_u8(vreinterpretq_u8_p128(hi), vreinterpretq_u8_p128(lo));
+}
+
+uint32_t GNSSCRC24Q::updateClmul(uint32_t crc, const uint8_t *data, size_t length)
+{
+    if (length < CLMUL_MIN_LENGTH || SELECTED_ENGINE != CLMUL)
+        return updateSlicingBy8(crc, data, length);
+
+    const uint8_t *p = data;
+    uint64x2_t initial = vcombine_u64(vcreate_u64(0), vcreate_u64(static_cast<uint64_t>(crc & 0xFFFFFF) << 40));
+    uint8x16_t x0 = veorq_u8(loadReversed(p), vreinterpretq_u8_u64(initial));
+    p += 16;
+
+    if (length >= 128)
+    {
+        uint8x16_t x1 = loadReversed(p);
+        uint8x16_t x2 = loadReversed(p + 16);
+        uint8x16_t x3 = loadReversed(p + 32);
+        p += 48;
+
+        while (static_cast<size_t>(data + length - p) >= 64)
+        {
+            x0 = veorq_u8(fold(x0, X576_MOD_P, X512_MOD_P), loadReversed(p));
+            x1 = veorq_u8(fold(x1, X576_MOD_P, X512_MOD_P), loadReversed(p + 16));
+            x2 = veorq_u8(fold(x2, X576_MOD_P, X512_MOD_P), loadReversed(p + 32));
+            x3 = veorq_u8(fold(x3, X576_MOD_P, X512_MOD_P), loadReversed(p + 48));
+            p += 64;
+        }
+
+        x0 = veorq_u8(fold(x0, X192_MOD_P, X128_MOD_P), x1);
+        x0 = veorq_u8(fold(x0, X192_MOD_P, X128_MOD_P), x2);
+        x0 = veorq_u8(fold(x0, X192_MOD_P, X128_MOD_P), x3);
+    }
+
+    while (static_cast<size_t>(data + length - p) >= 16)
+    {
+        x0 = veorq_u8(fold(x0, X192_MOD_P, X128_MOD_P), loadReversed(p));
+        p += 16;
+    }
+
+    uint8_t remainder[16];
+    uint8x16_t v = vrev64q_u8(x0);
+    vst1q_u8(remainder, vextq_u8(v, v, 8));
+
+    crc = updateSlicingBy8(0, remainder, sizeof(remainder));
+    return updateSlicingBy8(crc, p, data + length - p);
+}
+
+#else
+
+bool GNSSCRC24Q::clmulSupported()
+{
+    return false;
+}
+
+uint32_t GNSSCRC24Q::updateClmul(uint32_t crc, const uint8_t *data, size_t length)
+{
+    return updateSlicingBy8(crc, data, length);
+}
+
+#endif
@@ -0,0 +1,176 @@
+#include "GNSSChunkedParser.h"
+
+#if !defined(ARDUINO)
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+
+    // The scanner of GNSSParser, run over flat memory from one idle position
+    // to the next. The memory runs to the end of the capture, so a candidate
+    // cut off by it fails like one failing its check and the scan resumes one
+    // byte after its preamble.
+    class FlatScanner
+    {
+    public:
+        typedef GNSSParser::FramerList Framers;
+        typedef GNSSParserBase::Message Message;
+
+        struct Step
+        {
+            size_t next; // next idle position
+            bool valid;  // a valid frame starts at the current position
+            Message::Type type;
+            size_t length;
+        };
+
+        Step step(const uint8_t *data, size_t size, size_t pos)
+        {
+            unsigned framers = Framers::FIRST_BYTE[data[pos]] & GNSSParser::ENABLED_FRAMERS;
+            if (!framers)
+            {
+                size_t next = pos + 1 + GNSSSyncSearch::find(data + pos + 1, size - pos - 1, GNSSParser::FRAME_STARTS);
+                return {next, false, Message::Type::UNKNOWN, 0};
+            }
+
+            // Framers sharing a first byte take their turns in list order
+            Message::Type type = Message::Type::UNKNOWN;
+            for (unsigned index = 0; framers >> index; index++)
+            {
+                if (!(framers & (1u << index)))
+                    continue;
+
+                const GNSSFramerEntry &framer = Framers::ENTRIES[index];
+                GNSSParserBase::ScanState state = GNSSParserBase::ScanState();
+                GNSSParserBase::ParseResult result;
+                framer.scan(state, data + pos, size - pos, GNSSParser::BUFFER_SIZE, result);
+                type = framer.type;
+
+                if (result.complete && result.valid)
+                    return {pos + result.length, true, type, result.length};
+            }
+
+            return {pos + 1, false, type, 0};
+        }
+    };
+
+}
+
+GNSSChunkedParser::GNSSChunkedParser(size_t threads, size_t chunk_size)
+    : threads_(threads), chunk_size_(chunk_size)
+{
+    if (threads_ == 0)
+    {
+        threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (chunk_size_ == 0)
+    {
+        chunk_size_ = 1;
+    }
+}
+
+std::vector<GNSSChunkedParser::Frame> GNSSChunkedParser::parse(const uint8_t *data, size_t size)
+{
+    std::vector<Frame> frames;
+    parse(data, size, [&](const Frame &frame)
+          { frames.push_back(frame); });
+    return frames;
+}
+
+static void scanChunk(const uint8_t *data, size_t size, size_t begin, size_t end,
+                      std::vector<GNSSChunkedParser::Frame> &frames, size_t &exit)
+{
+    FlatScanner scanner;
+    size_t pos = begin;
+
+    while (pos < end)
+    {
+        FlatScanner::Step step = scanner.step(data, size, pos);
+        if (step.valid)
+        {
+            frames.push_back({step.type, pos, step.length});
+        }
+        pos = step.next;
+    }
+
+    exit = pos;
+}
+
+void GNSSChunkedParser::parseWave(const uint8_t *data, size_t size, size_t begin, Cursor &cursor, std::vector<Frame> &frames)
+{
+    size_t count = std::min(threads_, (size - begin + chunk_size_ - 1) / chunk_size_);
+    chunks_.resize(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        Chunk &chunk = chunks_[i];
+        chunk.begin = begin + i * chunk_size_;
+        chunk.end = std::min(chunk.begin + chunk_size_, size);
+        chunk.frames.clear();
+    }
+
+    // The calling thread takes the first chunk
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < count; i++)
+    {
+        Chunk &chunk = chunks_[i];
+        workers.push_back(std::thread([&chunk, data, size]
+                                      { scanChunk(data, size, chunk.begin, chunk.end, chunk.frames, chunk.exit); }));
+    }
+    scanChunk(data, size, chunks_[0].begin, chunks_[0].end, chunks_[0].frames, chunks_[0].exit);
+
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        merge(data, size, chunks_[i], cursor, frames);
+    }
+}
+
+// Follows the true scanner position through one chunk. Until it meets a
+// position the chunk's own pass went through, frames are found again one
+// step at a time; from there on the two passes agree and the chunk's frames
+// are taken as they are.
+void GNSSChunkedParser::merge(const uint8_t *data, size_t size, const Chunk &chunk, Cursor &cursor, std::vector<Frame> &frames)
+{
+    FlatScanner scanner;
+    size_t pos = cursor.pos;
+    size_t next_frame = 0;
+
+    while (pos < chunk.end)
+    {
+        while (next_frame < chunk.frames.size() &&
+               chunk.frames[next_frame].offset + chunk.frames[next_frame].length <= pos)
+        {
+            next_frame++;
+        }
+
+        // The chunk's pass went through every position except those inside
+        // its frames
+        bool inside = next_frame < chunk.frames.size() && chunk.frames[next_frame].offset < pos;
+
+        if (!inside)
+        {
+            frames.insert(frames.end(), chunk.frames.begin() + next_frame, chunk.frames.end());
+            cursor.pos = chunk.exit;
+            return;
+        }
+
+        FlatScanner::Step step = scanner.step(data, size, pos);
+        if (step.valid)
+        {
+            frames.push_back({step.type, pos, step.length});
+        }
+        pos = step.next;
+    }
+
+    cursor.pos = pos;
+}
+
+#endif
@@ -0,0 +1,630 @@
+#include "GNSSEphemeris.h"
+#include "GNSSBitReader.h"
+#include <math.h>
+#include <string.h>
+
+constexpr size_t GNSSSatelliteStates::MAX_SATELLITES;
+constexpr size_t GNSSEphemerisCache::KEPLER_SLOTS;
+constexpr size_t GNSSEphemerisCache::GLONASS_SLOTS;
+
+// Semicircles to radians, with the value of pi the ICDs prescribe
+static const double SEMICIRCLE = 3.1415926535898;
+
+static const double SPEED_OF_LIGHT = 299792458.0;
+static const double WEEK = 604800.0;
+static const double HALF_WEEK = WEEK / 2;
+static const double DAY = 86400.0;
+
+// Earth constants per system: gravitational constant and rotation rate
+static const double GM_GPS = 3.986005e14;
+static const double GM_GALILEO = 3.986004418e14;
+static const double GM_BEIDOU = 3.986004418e14;
+static const double EARTH_RATE_GPS = 7.2921151467e-5;
+static const double EARTH_RATE_BEIDOU = 7.292115e-5;
+
+// PZ-90
+static const double GM_GLONASS = 3.9860044e14;
+static const double EARTH_RATE_GLONASS = 7.292115e-5;
+static const double RADIUS_GLONASS = 6378136.0;
+static const double J2_GLONASS = 1.0826257e-3;
+
+// Newton iterations of Kepler's equation after a first step from the mean
+// anomaly. Broadcast eccentricities stay below 0.1, where the error shrinks
+// from e^2 to e^16; the count is fixed so the loop does not branch per
+// satellite.
+static const int KEPLER_ITERATIONS = 3;
+
+// Slot ranges in kepler_: GPS, QZSS, Galileo, BeiDou
+static const int QZSS_OFFSET = 32;
+static const int GALILEO_OFFSET = QZSS_OFFSET + 10;
+static const int BEIDOU_OFFSET = GALILEO_OFFSET + 36;
+
+static inline double pow2(int exponent)
+{
+    return ldexp(1.0, exponent);
+}
+
+static inline double wrap(double seconds, double half)
+{
+    if (seconds > half)
+        return seconds - 2 * half;
+    if (seconds < -half)
+        return seconds + 2 * half;
+    return seconds;
+}
+
+// BeiDou GEO satellites, whose orbit elements are in an inertial frame
+static bool isBeidouGeo(uint8_t prn)
+{
+    return prn <= 5 || prn >= 59;
+}
+
+GNSSEphemerisCache::GNSSEphemerisCache(int leap_seconds)
+    : leap_seconds_(leap_seconds)
+{
+    clear();
+}
+
+void GNSSEphemerisCache::clear()
+{
+    for (size_t i = 0; i < KEPLER_SLOTS; i++)
+        index_[i] = -1;
+    for (size_t i = 0; i < GLONASS_SLOTS; i++)
+        glonass_valid_[i] = false;
+    kepler_count_ = 0;
+    glonass_count_ = 0;
+    geo_count_ = 0;
+}
+
+int GNSSEphemerisCache::keplerSlot(GNSSSystem::Type system, uint8_t prn)
+{
+    switch (system)
+    {
+    case GNSSSystem::GPS:
+        return prn >= 1 && prn <= 32 ? prn - 1 : -1;
+    case GNSSSystem::QZSS:
+        return prn >= 193 && prn <= 202 ? QZSS_OFFSET + prn - 193 : -1;
+    case GNSSSystem::GALILEO:
+        return prn >= 1 && prn <= 36 ? GALILEO_OFFSET + prn - 1 : -1;
+    case GNSSSystem::BEIDOU:
+        return prn >= 1 && prn <= 63 ? BEIDOU_OFFSET + prn - 1 : -1;
+    default:
+        return -1;
+    }
+}
+
+bool GNSSEphemerisCache::decode(const uint8_t *frame, size_t length, GNSSKeplerEphemeris &eph)
+{
+    GNSSRTCM3Header header(frame, length);
+    uint16_t number = header.messageNumber();
+    size_t payload_length = header.payloadLength();
+    if (length < 6 || payload_length + 6 > length)
+    {
+        return false;
+    }
+
+    GNSSBitReader reader(frame + 3, payload_length);
+    reader.skip(12);
+
+    switch (number)
+    {
+    case 1019:
+    case 1044:
+        if (number == 1019)
+        {
+            eph.system = GNSSSystem::GPS;
+            eph.prn = reader.read(6);
+            eph.week = reader.read(10);
+            eph.accuracy = reader.read(4);
+            reader.skip(2); // codes on L2
+            eph.idot = reader.readSigned(14) * pow2(-43) * SEMICIRCLE;
+            eph.iode = reader.read(8);
+        }
+        else
+        {
+            eph.system = GNSSSystem::QZSS;
+            eph.prn = 192 + reader.read(4);
+        }
+        eph.toc = reader.read(16) * 16.0;
+        eph.af2 = reader.readSigned(8) * pow2(-55);
+        eph.af1 = reader.readSigned(16) * pow2(-43);
+        eph.af0 = reader.readSigned(22) * pow2(-31);
+        if (number == 1019)
+            eph.iodc = reader.read(10);
+        else
+            eph.iode = reader.read(8);
+        eph.crs = reader.readSigned(16) * pow2(-5);
+        eph.delta_n = reader.readSigned(16) * pow2(-43) * SEMICIRCLE;
+        eph.m0 = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.cuc = reader.readSigned(16) * pow2(-29);
+        eph.e = reader.read(32) * pow2(-33);
+        eph.cus = reader.readSigned(16) * pow2(-29);
+        eph.sqrt_a = reader.read(32) * pow2(-19);
+        eph.toe = reader.read(16) * 16.0;
+        eph.cic = reader.readSigned(16) * pow2(-29);
+        eph.omega0 = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.cis = reader.readSigned(16) * pow2(-29);
+        eph.i0 = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.crc = reader.readSigned(16) * pow2(-5);
+        eph.omega = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.omega_dot = reader.readSigned(24) * pow2(-43) * SEMICIRCLE;
+        if (number == 1019)
+        {
+            eph.tgd = reader.readSigned(8) * pow2(-31);
+            eph.health = reader.read(6);
+        }
+        else
+        {
+            eph.idot = reader.readSigned(14) * pow2(-43) * SEMICIRCLE;
+            reader.skip(2); // codes on L2
+            eph.week = reader.read(10);
+            eph.accuracy = reader.read(4);
+            eph.health = reader.read(6);
+            eph.tgd = reader.readSigned(8) * pow2(-31);
+            eph.iodc = reader.read(10);
+        }
+        break;
+
+    case 1042:
+        eph.system = GNSSSystem::BEIDOU;
+        eph.prn = reader.read(6);
+        eph.week = reader.read(13);
+        eph.accuracy = reader.read(4);
+        eph.idot = reader.readSigned(14) * pow2(-43) * SEMICIRCLE;
+        eph.iode = reader.read(5);
+        eph.toc = reader.read(17) * 8.0;
+        eph.af2 = reader.readSigned(11) * pow2(-66);
+        eph.af1 = reader.readSigned(22) * pow2(-50);
+        eph.af0 = reader.readSigned(24) * pow2(-33);
+        eph.iodc = reader.read(5);
+        eph.crs = reader.readSigned(18) * pow2(-6);
+        eph.delta_n = reader.readSigned(16) * pow2(-43) * SEMICIRCLE;
+        eph.m0 = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.cuc = reader.readSigned(18) * pow2(-31);
+        eph.e = reader.read(32) * pow2(-33);
+        eph.cus = reader.readSigned(18) * pow2(-31);
+        eph.sqrt_a = reader.read(32) * pow2(-19);
+        eph.toe = reader.read(17) * 8.0;
+        eph.cic = reader.readSigned(18) * pow2(-31);
+        eph.omega0 = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.cis = reader.readSigned(18) * pow2(-31);
+        eph.i0 = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.crc = reader.readSigned(18) * pow2(-6);
+        eph.omega = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.omega_dot = reader.readSigned(24) * pow2(-43) * SEMICIRCLE;
+        eph.tgd = reader.readSigned(10) * 1e-10;
+        reader.skip(10); // TGD2
+        eph.health = reader.read(1);
+        break;
+
+    case 1045:
+    case 1046:
+        eph.system = GNSSSystem::GALILEO;
+        eph.prn = reader.read(6);
+        eph.week = reader.read(12);
+        eph.iode = reader.read(10);
+        eph.accuracy = reader.read(8);
+        eph.idot = reader.readSigned(14) * pow2(-43) * SEMICIRCLE;
+        eph.toc = reader.read(14) * 60.0;
+        eph.af2 = reader.readSigned(6) * pow2(-59);
+        eph.af1 = reader.readSigned(21) * pow2(-46);
+        eph.af0 = reader.readSigned(31) * pow2(-34);
+        eph.crs = reader.readSigned(16) * pow2(-5);
+        eph.delta_n = reader.readSigned(16) * pow2(-43) * SEMICIRCLE;
+        eph.m0 = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.cuc = reader.readSigned(16) * pow2(-29);
+        eph.e = reader.read(32) * pow2(-33);
+        eph.cus = reader.readSigned(16) * pow2(-29);
+        eph.sqrt_a = reader.read(32) * pow2(-19);
+        eph.toe = reader.read(14) * 60.0;
+        eph.cic = reader.readSigned(16) * pow2(-29);
+        eph.omega0 = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.cis = reader.readSigned(16) * pow2(-29);
+        eph.i0 = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.crc = reader.readSigned(16) * pow2(-5);
+        eph.omega = reader.readSigned(32) * pow2(-31) * SEMICIRCLE;
+        eph.omega_dot = reader.readSigned(24) * pow2(-43) * SEMICIRCLE;
+        eph.tgd = reader.readSigned(10) * pow2(-32); // BGD E5a/E1
+        eph.iodc = 0;
+        if (number == 1045)
+        {
+            eph.health = reader.read(3); // E5a SHS, DVS
+        }
+        else
+        {
+            eph.tgd = reader.readSigned(10) * pow2(-32); // BGD E5b/E1
+            eph.health = reader.read(3) << 3; // E5b SHS, DVS
+            eph.health |= reader.read(3);     // E1-B SHS, DVS
+        }
+        break;
+
+    default:
+        return false;
+    }
+
+    return !reader.overflow() && keplerSlot(eph.system, eph.prn) >= 0;
+}
+
+bool GNSSEphemerisCache::decode(const uint8_t *frame, size_t length, GNSSGlonassEphemeris &eph)
+{
+    GNSSRTCM3Header header(frame, length);
+    size_t payload_length = header.payloadLength();
+    if (header.messageNumber() != 1020 || length < 6 || payload_length + 6 > length)
+    {
+        return false;
+    }
+
+    GNSSBitReader reader(frame + 3, payload_length);
+    reader.skip(12);
+    eph.slot = reader.read(6);
+    eph.frequency_channel = static_cast<int8_t>(reader.read(5)) - 7;
+    reader.skip(1 + 1 + 2 + 12); // almanac health, availability, P1, tk
+    eph.health = reader.read(1);
+    reader.skip(1); // P2
+    eph.tb = reader.read(7) * 900;
+
+    // Per axis: velocity, position and acceleration, km based
+    for (int axis = 0; axis < 3; axis++)
+    {
+        eph.velocity[axis] = reader.readSignMagnitude(24) * pow2(-20) * 1e3;
+        eph.position[axis] = reader.readSignMagnitude(27) * pow2(-11) * 1e3;
+        eph.acceleration[axis] = reader.readSignMagnitude(5) * pow2(-30) * 1e3;
+    }
+
+    reader.skip(1); // P3
+    eph.gamma_n = reader.readSignMagnitude(11) * pow2(-40);
+    reader.skip(2 + 1); // P, ln
+    eph.tau_n = reader.readSignMagnitude(22) * pow2(-30);
+    reader.skip(5 + 5 + 1 + 4 + 11 + 2 + 1 + 11 + 32 + 5 + 22 + 1 + 7);
+
+    return !reader.overflow() && eph.slot >= 1 && eph.slot <= GLONASS_SLOTS;
+}
+
+GNSSEphemerisCache::Update GNSSEphemerisCache::add(const uint8_t *frame, size_t length)
+{
+    GNSSRTCM3Header header(frame, length);
+    if (header.messageNumber() == 1020)
+    {
+        GNSSGlonassEphemeris glonass;
+        return decode(frame, length, glonass) ? add(glonass) : IGNORED;
+    }
+
+    GNSSKeplerEphemeris kepler;
+    return decode(frame, length, kepler) ? add(kepler) : IGNORED;
+}
+
+GNSSEphemerisCache::Update GNSSEphemerisCache::add(const GNSSParserBase::MessageView &view)
+{
+    if (view.type != GNSSParserBase::Message::Type::RTCM3)
+    {
+        return IGNORED;
+    }
+
+    if (!view.second)
+    {
+        return add(view.first, view.first_length);
+    }
+
+    uint8_t frame[GNSSParserBase::MAX_RTCM3_LENGTH];
+    if (view.length() > sizeof(frame))
+    {
+        return IGNORED;
+    }
+
+    size_t length = view.copyTo(frame);
+    return add(frame, length);
+}
+
+GNSSEphemerisCache::Update GNSSEphemerisCache::add(const GNSSKeplerEphemeris &ephemeris)
+{
+    int slot = keplerSlot(ephemeris.system, ephemeris.prn);
+    if (slot < 0)
+    {
+        return IGNORED;
+    }
+
+    int16_t index = index_[slot];
+    if (index >= 0)
+    {
+        const GNSSKeplerEphemeris &cached = kepler_[slot];
+        if (cached.iode == ephemeris.iode && cached.toe == ephemeris.toe && cached.toc == ephemeris.toc)
+        {
+            return UNCHANGED;
+        }
+    }
+    else
+    {
+        index = index_[slot] = kepler_count_++;
+        if (ephemeris.system == GNSSSystem::BEIDOU && isBeidouGeo(ephemeris.prn))
+            geo_[geo_count_++] = index;
+    }
+
+    kepler_[slot] = ephemeris;
+    prepare(index, ephemeris);
+    return UPDATED;
+}
+
+GNSSEphemerisCache::Update GNSSEphemerisCache::add(const GNSSGlonassEphemeris &ephemeris)
+{
+    if (ephemeris.slot < 1 || ephemeris.slot > GLONASS_SLOTS)
+    {
+        return IGNORED;
+    }
+
+    size_t slot = ephemeris.slot - 1;
+    if (glonass_valid_[slot])
+    {
+        // tb repeats daily, so the state vector decides
+        const GNSSGlonassEphemeris &cached = glonass_[slot];
+        if (cached.tb == ephemeris.tb && memcmp(cached.position, ephemeris.position, sizeof(cached.position)) == 0)
+        {
+            return UNCHANGED;
+        }
+    }
+    else
+    {
+        glonass_valid_[slot] = true;
+        glonass_count_++;
+    }
+
+    glonass_[slot] = ephemeris;
+    return UPDATED;
+}
+
+const GNSSKeplerEphemeris *GNSSEphemerisCache::find(GNSSSystem::Type system, uint8_t prn) const
+{
+    int slot = keplerSlot(system, prn);
+    return slot >= 0 && index_[slot] >= 0 ? &kepler_[slot] : nullptr;
+}
+
+const GNSSGlonassEphemeris *GNSSEphemerisCache::findGlonass(uint8_t slot) const
+{
+    return slot >= 1 && slot <= GLONASS_SLOTS && glonass_valid_[slot - 1] ? &glonass_[slot - 1] : nullptr;
+}
+
+void GNSSEphemerisCache::prepare(size_t i, const GNSSKeplerEphemeris &eph)
+{
+    double gm = GM_GPS;
+    double earth_rate = EARTH_RATE_GPS;
+    double offset = 0; // system time to GPS time
+    if (eph.system == GNSSSystem::GALILEO)
+    {
+        gm = GM_GALILEO;
+    }
+    else if (eph.system == GNSSSystem::BEIDOU)
+    {
+        gm = GM_BEIDOU;
+        earth_rate = EARTH_RATE_BEIDOU;
+        offset = 14;
+    }
+
+    Orbits &o = orbits_;
+    double a = eph.sqrt_a * eph.sqrt_a;
+    o.system[i] = eph.system;
+    o.prn[i] = eph.prn;
+    o.healthy[i] = eph.health == 0;
+    o.toe[i] = eph.toe + offset;
+    o.toc[i] = eph.toc + offset;
+    o.a[i] = a;
+    o.n[i] = sqrt(gm / (a * a * a)) + eph.delta_n;
+    o.e[i] = eph.e;
+    o.root_1_e2[i] = sqrt(1 - eph.e * eph.e);
+    o.m0[i] = eph.m0;
+    o.cos_omega[i] = cos(eph.omega);
+    o.sin_omega[i] = sin(eph.omega);
+    o.node0[i] = eph.omega0 - earth_rate * eph.toe;
+    bool geo = eph.system == GNSSSystem::BEIDOU && isBeidouGeo(eph.prn);
+    o.node_rate[i] = geo ? eph.omega_dot : eph.omega_dot - earth_rate;
+    o.i0[i] = eph.i0;
+    o.idot[i] = eph.idot;
+    o.cuc[i] = eph.cuc;
+    o.cus[i] = eph.cus;
+    o.crc[i] = eph.crc;
+    o.crs[i] = eph.crs;
+    o.cic[i] = eph.cic;
+    o.cis[i] = eph.cis;
+    o.af0[i] = eph.af0;
+    o.af1[i] = eph.af1;
+    o.af2[i] = eph.af2;
+    o.relativity[i] = -2 * sqrt(gm) / (SPEED_OF_LIGHT * SPEED_OF_LIGHT) * eph.sqrt_a * eph.e;
+}
+
+size_t GNSSEphemerisCache::compute(double gps_time, GNSSSatelliteStates &states) const
+{
+    const Orbits &o = orbits_;
+    size_t n = kepler_count_;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        states.system[i] = o.system[i];
+        states.prn[i] = o.prn[i];
+        states.healthy[i] = o.healthy[i];
+    }
+
+    // IS-GPS-200 table 20-IV, the same for Galileo, BeiDou and QZSS, in
+    // stages over scratch arrays. Each loop calls either sin() or cos(), never
+    // both on one angle: compilers fuse such a pair into a scalar sincos() and
+    // give up on vectorising the loop. Angle sums are expanded so only the
+    // eccentric anomaly, node and inclination need their sine and cosine; the
+    // week wrap-around is done without branches.
+    double tk[KEPLER_SLOTS], ek[KEPLER_SLOTS], sin_a[KEPLER_SLOTS], cos_a[KEPLER_SLOTS];
+    double node[KEPLER_SLOTS], inc[KEPLER_SLOTS];
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double t = gps_time - o.toe[i];
+        tk[i] = t - WEEK * floor(t / WEEK + 0.5);
+        ek[i] = o.m0[i] + o.n[i] * tk[i];
+        sin_a[i] = sin(ek[i]);
+    }
+    for (size_t i = 0; i < n; i++)
+        ek[i] += o.e[i] * sin_a[i];
+
+    for (int k = 0; k < KEPLER_ITERATIONS; k++)
+    {
+        for (size_t i = 0; i < n; i++)
+            sin_a[i] = sin(ek[i]);
+        for (size_t i = 0; i < n; i++)
+            cos_a[i] = cos(ek[i]);
+        for (size_t i = 0; i < n; i++)
+        {
+            double m = o.m0[i] + o.n[i] * tk[i];
+            ek[i] -= (ek[i] - o.e[i] * sin_a[i] - m) / (1 - o.e[i] * cos_a[i]);
+        }
+    }
+
+    for (size_t i = 0; i < n; i++)
+        sin_a[i] = sin(ek[i]);
+    for (size_t i = 0; i < n; i++)
+        cos_a[i] = cos(ek[i]);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double e = o.e[i];
+        double sin_e = sin_a[i];
+        double cos_e = cos_a[i];
+        double scale = 1 / (1 - e * cos_e);
+        double sin_v = o.root_1_e2[i] * sin_e * scale;
+        double cos_v = (cos_e - e) * scale;
+
+        // Argument of latitude phi = v + omega, corrected by du of at most
+        // a few 1e-5 rad, where two series terms are exact
+        double sin_phi = sin_v * o.cos_omega[i] + cos_v * o.sin_omega[i];
+        double cos_phi = cos_v * o.cos_omega[i] - sin_v * o.sin_omega[i];
+        double sin_2phi = 2 * sin_phi * cos_phi;
+        double cos_2phi = cos_phi * cos_phi - sin_phi * sin_phi;
+
+        double du = o.cus[i] * sin_2phi + o.cuc[i] * cos_2phi;
+        double sin_du = du * (1 - du * du / 6);
+        double cos_du = 1 - du * du / 2;
+        double r = o.a[i] * (1 - e * cos_e) + o.crs[i] * sin_2phi + o.crc[i] * cos_2phi;
+
+        // Position in the orbital plane, for now
+        states.x[i] = r * (cos_phi * cos_du - sin_phi * sin_du);
+        states.y[i] = r * (sin_phi * cos_du + cos_phi * sin_du);
+        inc[i] = o.i0[i] + o.idot[i] * tk[i] + o.cis[i] * sin_2phi + o.cic[i] * cos_2phi;
+        node[i] = o.node0[i] + o.node_rate[i] * tk[i];
+
+        double tc = gps_time - o.toc[i];
+        tc -= WEEK * floor(tc / WEEK + 0.5);
+        states.clock[i] = o.af0[i] + (o.af1[i] + o.af2[i] * tc) * tc + o.relativity[i] * sin_e;
+    }
+
+    // Inclination, then node
+    for (size_t i = 0; i < n; i++)
+        sin_a[i] = sin(inc[i]);
+    for (size_t i = 0; i < n; i++)
+        cos_a[i] = cos(inc[i]);
+    for (size_t i = 0; i < n; i++)
+    {
+        states.z[i] = states.y[i] * sin_a[i];
+        states.y[i] *= cos_a[i];
+    }
+
+    for (size_t i = 0; i < n; i++)
+        sin_a[i] = sin(node[i]);
+    for (size_t i = 0; i < n; i++)
+        cos_a[i] = cos(node[i]);
+    for (size_t i = 0; i < n; i++)
+    {
+        double x = states.x[i];
+        double y = states.y[i];
+        states.x[i] = x * cos_a[i] - y * sin_a[i];
+        states.y[i] = x * sin_a[i] + y * cos_a[i];
+    }
+
+    // BeiDou GEO: from the inertial frame of the elements, tilted by -5
+    // degrees, into the rotating frame
+    const double cos_5 = cos(-5 * SEMICIRCLE / 180);
+    const double sin_5 = sin(-5 * SEMICIRCLE / 180);
+    for (size_t k = 0; k < geo_count_; k++)
+    {
+        size_t i = geo_[k];
+        double tk = wrap(gps_time - o.toe[i], HALF_WEEK);
+        double angle = EARTH_RATE_BEIDOU * tk;
+        double cos_a = cos(angle);
+        double sin_a = sin(angle);
+
+        double x = states.x[i];
+        double y = cos_5 * states.y[i] + sin_5 * states.z[i];
+        double z = -sin_5 * states.y[i] + cos_5 * states.z[i];
+        states.x[i] = cos_a * x + sin_a * y;
+        states.y[i] = -sin_a * x + cos_a * y;
+        states.z[i] = z;
+    }
+
+    states.count = n;
+    computeGlonass(gps_time, states);
+    return states.count;
+}
+
+// Right-hand side of the GLONASS equations of motion, PZ-90 rotating frame
+static void glonassDerivatives(const double *state, const double *acceleration, double *derivative)
+{
+    double x = state[0], y = state[1], z = state[2];
+    double r2 = x * x + y * y + z * z;
+    double r = sqrt(r2);
+    double mu = GM_GLONASS / (r2 * r);
+    double j2 = 1.5 * J2_GLONASS * GM_GLONASS * RADIUS_GLONASS * RADIUS_GLONASS / (r2 * r2 * r);
+    double z2 = 5 * z * z / r2;
+    double w2 = EARTH_RATE_GLONASS * EARTH_RATE_GLONASS;
+
+    derivative[0] = state[3];
+    derivative[1] = state[4];
+    derivative[2] = state[5];
+    derivative[3] = -mu * x - j2 * x * (1 - z2) + w2 * x + 2 * EARTH_RATE_GLONASS * state[4] + acceleration[0];
+    derivative[4] = -mu * y - j2 * y * (1 - z2) + w2 * y - 2 * EARTH_RATE_GLONASS * state[3] + acceleration[1];
+    derivative[5] = -mu * z - j2 * z * (3 - z2) + acceleration[2];
+}
+
+// GLONASS ICD appendix A.3.1.2: fourth order Runge-Kutta from tb, in steps
+// of at most 60 s
+void GNSSEphemerisCache::computeGlonass(double gps_time, GNSSSatelliteStates &states) const
+{
+    const double STEP = 60;
+    double moscow_time = fmod(gps_time - leap_seconds_ + 3 * 3600, DAY);
+    if (moscow_time < 0)
+        moscow_time += DAY;
+
+    for (size_t slot = 0; slot < GLONASS_SLOTS; slot++)
+    {
+        if (!glonass_valid_[slot])
+            continue;
+
+        const GNSSGlonassEphemeris &eph = glonass_[slot];
+        double tk = wrap(moscow_time - eph.tb, DAY / 2);
+
+        double state[6] = {eph.position[0], eph.position[1], eph.position[2],
+                           eph.velocity[0], eph.velocity[1], eph.velocity[2]};
+        double remaining = tk;
+        while (remaining != 0)
+        {
+            double h = fabs(remaining) > STEP ? (remaining > 0 ? STEP : -STEP) : remaining;
+            double k1[6], k2[6], k3[6], k4[6], temp[6];
+
+            glonassDerivatives(state, eph.acceleration, k1);
+            for (int j = 0; j < 6; j++)
+                temp[j] = state[j] + k1[j] * h / 2;
+            glonassDerivatives(temp, eph.acceleration, k2);
+            for (int j = 0; j < 6; j++)
+                temp[j] = state[j] + k2[j] * h / 2;
+            glonassDerivatives(temp, eph.acceleration, k3);
+            for (int j = 0; j < 6; j++)
+                temp[j] = state[j] + k3[j] * h;
+            glonassDerivatives(temp, eph.acceleration, k4);
+            for (int j = 0; j < 6; j++)
+                state[j] += (k1[j] + 2 * k2[j] + 2 * k3[j] + k4[j]) * h / 6;
+
+            remaining -= h;
+        }
+
+        size_t i = states.count++;
+        states.system[i] = GNSSSystem::GLONASS;
+        states.prn[i] = eph.slot;
+        states.healthy[i] = eph.health == 0;
+        states.x[i] = state[0];
+        states.y[i] = state[1];
+        states.z[i] = state[2];
+        states.clock[i] = -eph.tau_n + eph.gamma_n * tk;
+    }
+}
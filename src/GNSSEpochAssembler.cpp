@@ -0,0 +1,54 @@
+#include "GNSSEpochAssembler.h"
+
+#if !defined(ARDUINO)
+#include <chrono>
+#endif
+
+constexpr size_t GNSSEpoch::MAX_MESSAGES;
+
+static const uint32_t DAY_MS = 86400000;
+static const uint32_t WEEK_MS = 7 * DAY_MS;
+
+GNSSEpochAssembler::GNSSEpochAssembler(uint32_t timeout_ms, int leap_seconds)
+    : timeout_ms_(timeout_ms), leap_seconds_(leap_seconds)
+{
+    epoch_.count = 0;
+}
+
+uint32_t GNSSEpochAssembler::gpsTime(GNSSSystem::Type system, uint32_t epoch_time) const
+{
+    switch (system)
+    {
+    case GNSSSystem::BEIDOU:
+        return (epoch_time + 14000) % WEEK_MS;
+
+    case GNSSSystem::GLONASS:
+    {
+        // Day of week (7 when unknown) and Moscow time of day
+        uint32_t day = epoch_time >> 27;
+        int64_t time = int64_t(day % 7) * DAY_MS + (epoch_time & 0x7FFFFFF) - 3 * 3600000 + leap_seconds_ * 1000;
+        return static_cast<uint32_t>((time + WEEK_MS) % WEEK_MS);
+    }
+
+    default:
+        return epoch_time % WEEK_MS;
+    }
+}
+
+// Compared by time of day, so a GLONASS message without its day of week still
+// joins its epoch
+bool GNSSEpochAssembler::sameEpoch(uint16_t station_id, uint32_t time) const
+{
+    return station_id == epoch_.station_id && time % DAY_MS == epoch_.time % DAY_MS;
+}
+
+uint64_t GNSSEpochAssembler::now()
+{
+#if defined(ARDUINO)
+    return static_cast<uint64_t>(micros()) * 1000;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
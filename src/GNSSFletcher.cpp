@@ -0,0 +1,150 @@
+#include "GNSSFletcher.h"
+
+#if !defined(ARDUINO) && defined(__GNUC__) && defined(__SSE2__)
+#define GNSS_FLETCHER_SSE2 1
+#include <emmintrin.h>
+#elif !defined(ARDUINO) && defined(__aarch64__)
+#define GNSS_FLETCHER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // Weight of each byte of a 16-byte block in CK_B
+    const uint8_t WEIGHTS[16] = {16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1};
+
+    uint16_t fold(uint32_t a, uint32_t b)
+    {
+        return static_cast<uint16_t>((a & 0xFF) | ((b & 0xFF) << 8));
+    }
+}
+
+GNSSFletcher::Engine GNSSFletcher::engine()
+{
+#if defined(GNSS_FLETCHER_SSE2)
+    return SSE2;
+#elif defined(GNSS_FLETCHER_NEON)
+    return NEON;
+#else
+    return BLOCKED;
+#endif
+}
+
+uint16_t GNSSFletcher::updateBlock(uint16_t sum, const uint8_t *data, size_t length)
+{
+#if defined(GNSS_FLETCHER_SSE2)
+    return updateSSE2(sum, data, length);
+#elif defined(GNSS_FLETCHER_NEON)
+    return updateNEON(sum, data, length);
+#else
+    return updateBlocked(sum, data, length);
+#endif
+}
+
+uint16_t GNSSFletcher::updateBlocked(uint16_t sum, const uint8_t *data, size_t length)
+{
+    uint32_t a = sum & 0xFF;
+    uint32_t b = sum >> 8;
+
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8)
+    {
+        const uint8_t *d = data + i;
+        b += 8 * a + 8 * d[0] + 7 * d[1] + 6 * d[2] + 5 * d[3] + 4 * d[4] + 3 * d[5] + 2 * d[6] + d[7];
+        a += d[0] + d[1] + d[2] + d[3] + d[4] + d[5] + d[6] + d[7];
+    }
+
+    return updateBytewise(fold(a, b), data + i, length - i);
+}
+
+#if defined(GNSS_FLETCHER_SSE2)
+
+uint16_t GNSSFletcher::updateSSE2(uint16_t sum, const uint8_t *data, size_t length)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weights = _mm_loadu_si128(reinterpret_cast<const __m128i *>(WEIGHTS));
+    const __m128i weights_lo = _mm_unpacklo_epi8(weights, zero);
+    const __m128i weights_hi = _mm_unpackhi_epi8(weights, zero);
+
+    __m128i sums = zero;     // byte sums of all blocks so far
+    __m128i prefix = zero;   // sums before each block, added up
+    __m128i weighted = zero; // weighted byte sums
+
+    size_t blocks = length / 16;
+    for (size_t i = 0; i < blocks; i++)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 16));
+        prefix = _mm_add_epi32(prefix, sums);
+        sums = _mm_add_epi32(sums, _mm_sad_epu8(v, zero));
+        weighted = _mm_add_epi32(weighted,
+                                 _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(v, zero), weights_lo),
+                                               _mm_madd_epi16(_mm_unpackhi_epi8(v, zero), weights_hi)));
+    }
+
+    // Only the low bytes matter, so 32-bit lanes may wrap freely
+    sums = _mm_add_epi32(sums, _mm_srli_si128(sums, 8));
+    prefix = _mm_add_epi32(prefix, _mm_srli_si128(prefix, 8));
+    weighted = _mm_add_epi32(weighted, _mm_srli_si128(weighted, 8));
+    weighted = _mm_add_epi32(weighted, _mm_srli_si128(weighted, 4));
+
+    uint32_t a = sum & 0xFF;
+    uint32_t b = sum >> 8;
+    b += static_cast<uint32_t>(blocks * 16) * a + 16 * static_cast<uint32_t>(_mm_cvtsi128_si32(prefix)) +
+         static_cast<uint32_t>(_mm_cvtsi128_si32(weighted));
+    a += static_cast<uint32_t>(_mm_cvtsi128_si32(sums));
+
+    return updateBytewise(fold(a, b), data + blocks * 16, length - blocks * 16);
+}
+
+uint16_t GNSSFletcher::updateNEON(uint16_t sum, const uint8_t *data, size_t length)
+{
+    return updateBlocked(sum, data, length);
+}
+
+#elif defined(GNSS_FLETCHER_NEON)
+
+uint16_t GNSSFletcher::updateSSE2(uint16_t sum, const uint8_t *data, size_t length)
+{
+    return updateBlocked(sum, data, length);
+}
+
+uint16_t GNSSFletcher::updateNEON(uint16_t sum, const uint8_t *data, size_t length)
+{
+    const uint8x8_t weights_lo = vld1_u8(WEIGHTS);
+    const uint8x8_t weights_hi = vld1_u8(WEIGHTS + 8);
+
+    uint32x4_t sums = vdupq_n_u32(0);
+    uint32x4_t prefix = vdupq_n_u32(0);
+    uint32x4_t weighted = vdupq_n_u32(0);
+
+    size_t blocks = length / 16;
+    for (size_t i = 0; i < blocks; i++)
+    {
+        uint8x16_t v = vld1q_u8(data + i * 16);
+        prefix = vaddq_u32(prefix, sums);
+        sums = vpadalq_u16(sums, vpaddlq_u8(v));
+        weighted = vpadalq_u16(weighted, vmull_u8(vget_low_u8(v), weights_lo));
+        weighted = vpadalq_u16(weighted, vmull_u8(vget_high_u8(v), weights_hi));
+    }
+
+    uint32_t a = sum & 0xFF;
+    uint32_t b = sum >> 8;
+    b += static_cast<uint32_t>(blocks * 16) * a + 16 * vaddvq_u32(prefix) + vaddvq_u32(weighted);
+    a += vaddvq_u32(sums);
+
+    return updateBytewise(fold(a, b), data + blocks * 16, length - blocks * 16);
+}
+
+#else
+
+uint16_t GNSSFletcher::updateSSE2(uint16_t sum, const uint8_t *data, size_t length)
+{
+    return updateBlocked(sum, data, length);
+}
+
+uint16_t GNSSFletcher::updateNEON(uint16_t sum, const uint8_t *data, size_t length)
+{
+    return updateBlocked(sum, data, length);
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include "GNSSFramer.h"
+
+#include <string.h>
+#include <algorithm>
+
+constexpr size_t GNSSFramer::SYNC_LENGTH;
+constexpr size_t GNSSFramer::FILTER_HEAD_LENGTH;
+constexpr bool GNSSFramer::LOG_INVALID;
+constexpr uint64_t GNSSFramer::Stats::*GNSSFramer::FRAMES;
+constexpr uint64_t GNSSFramer::Stats::*GNSSFramer::FAILURES;
+
+constexpr uint32_t GNSSNMEAFramer::PROTOCOL;
+constexpr GNSSFramer::Message::Type GNSSNMEAFramer::TYPE;
+constexpr size_t GNSSNMEAFramer::MAX_LENGTH;
+constexpr size_t GNSSNMEAFramer::FILTER_HEAD_LENGTH;
+constexpr bool GNSSNMEAFramer::LOG_INVALID;
+constexpr uint64_t GNSSFramer::Stats::*GNSSNMEAFramer::FRAMES;
+constexpr uint64_t GNSSFramer::Stats::*GNSSNMEAFramer::FAILURES;
+
+constexpr uint32_t GNSSRTCM3Framer::PROTOCOL;
+constexpr GNSSFramer::Message::Type GNSSRTCM3Framer::TYPE;
+constexpr size_t GNSSRTCM3Framer::MAX_LENGTH;
+constexpr uint32_t GNSSRTCM3Framer::SYNC;
+constexpr size_t GNSSRTCM3Framer::SYNC_LENGTH;
+constexpr size_t GNSSRTCM3Framer::HEAD_LENGTH;
+constexpr size_t GNSSRTCM3Framer::CHECK_BEGIN;
+constexpr size_t GNSSRTCM3Framer::CHECK_LENGTH;
+constexpr size_t GNSSRTCM3Framer::FILTER_HEAD_LENGTH;
+constexpr uint64_t GNSSFramer::Stats::*GNSSRTCM3Framer::FRAMES;
+constexpr uint64_t GNSSFramer::Stats::*GNSSRTCM3Framer::FAILURES;
+
+constexpr uint32_t GNSSUBXFramer::PROTOCOL;
+constexpr GNSSFramer::Message::Type GNSSUBXFramer::TYPE;
+constexpr size_t GNSSUBXFramer::MAX_LENGTH;
+constexpr uint32_t GNSSUBXFramer::SYNC;
+constexpr size_t GNSSUBXFramer::SYNC_LENGTH;
+constexpr size_t GNSSUBXFramer::HEAD_LENGTH;
+constexpr size_t GNSSUBXFramer::CHECK_BEGIN;
+constexpr size_t GNSSUBXFramer::CHECK_LENGTH;
+constexpr size_t GNSSUBXFramer::FILTER_HEAD_LENGTH;
+constexpr uint64_t GNSSFramer::Stats::*GNSSUBXFramer::FRAMES;
+constexpr uint64_t GNSSFramer::Stats::*GNSSUBXFramer::FAILURES;
+
+static uint8_t hexValue(uint8_t c)
+{
+    return c >= '0' && c <= '9' ? c - '0' : c >= 'A' && c <= 'F' ? c - 'A' + 10
+                                                                 : 0;
+}
+
+size_t GNSSNMEAFramer::scan(ScanState &state, const uint8_t *data, size_t available, size_t, ParseResult &result)
+{
+    size_t search_length = std::min(available, MAX_LENGTH - state.searched);
+
+    for (size_t i = 0; i < search_length; i++)
+    {
+        uint8_t c = data[i];
+
+        if (c == '\n')
+        {
+            size_t msg_length = state.searched + i + 1;
+            uint8_t checksum = state.checksum_ended ? state.checksum : state.checksum ^ c;
+
+            // Checksum digits sit right before the trailing "\r\n"
+            uint8_t received_checksum = (hexValue((state.history >> 16) & 0xFF) << 4) |
+                                        hexValue((state.history >> 8) & 0xFF);
+
+            bool is_valid = msg_length >= 4 && checksum == received_checksum;
+            result = {is_valid, true, msg_length, is_valid ? nullptr : "Checksum validation failed"};
+            return i + 1;
+        }
+
+        state.history = (state.history << 8) | c;
+
+        if (c == '$' || c == '!')
+        {
+            continue;
+        }
+
+        if (c == '*')
+        {
+            state.checksum_ended = true;
+        }
+        else if (!state.checksum_ended)
+        {
+            state.checksum ^= c;
+        }
+    }
+
+    if (state.searched + search_length == MAX_LENGTH)
+        result = {false, true, 0, "No final \\n found"};
+    else
+        result = {false, false, 0, "No message end found"};
+    return search_length;
+}
+
+size_t GNSSNMEAFramer::skip(ScanState &state, const uint8_t *data, size_t available, size_t, ParseResult &result)
+{
+    size_t search_length = std::min(available, MAX_LENGTH - state.searched);
+    const uint8_t *end = static_cast<const uint8_t *>(memchr(data, '\n', search_length));
+    if (end)
+    {
+        size_t count = end - data + 1;
+        result = {false, true, state.searched + count, "Filtered"};
+        return count;
+    }
+
+    if (state.searched + search_length == MAX_LENGTH)
+        result = {false, true, 0, "No final \\n found"};
+    else
+        result = {false, false, 0, "No message end found"};
+    return search_length;
+}
@@ -0,0 +1,3 @@
+#include "GNSSGSVAssembler.h"
+
+constexpr size_t GNSSSatellitesInView::MAX_SATELLITES;
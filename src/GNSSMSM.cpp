@@ -0,0 +1,242 @@
+#include "GNSSMSM.h"
+#include <math.h>
+
+constexpr size_t GNSSMSMObservations::MAX_SATELLITES;
+constexpr size_t GNSSMSMObservations::MAX_CELLS;
+constexpr double GNSSMSMDecoder::SPEED_OF_LIGHT;
+
+// Metres per millisecond of range
+static const double RANGE_MS = GNSSMSMDecoder::SPEED_OF_LIGHT / 1000.0;
+
+bool GNSSMSMDecoder::decode(const uint8_t *frame, size_t length, GNSSMSMObservations &obs)
+{
+    GNSSRTCM3Header header(frame, length);
+    unsigned type = header.msmType();
+    if (type < 4 || length < 6)
+    {
+        return false;
+    }
+
+    size_t payload_length = header.payloadLength();
+    if (payload_length + 6 > length)
+    {
+        return false;
+    }
+
+    GNSSBitReader reader(frame + 3, payload_length);
+    obs.message_number = reader.read(12);
+    obs.station_id = reader.read(12);
+    obs.system = header.system();
+    obs.msm_type = type;
+    obs.epoch_time = reader.read(30);
+    obs.multiple_message = reader.readBit();
+    obs.iods = reader.read(3);
+    reader.skip(7);
+    obs.clock_steering = reader.read(2);
+    obs.external_clock = reader.read(2);
+    obs.smoothing = reader.readBit();
+    obs.smoothing_interval = reader.read(3);
+
+    uint64_t satellite_mask = reader.read(64);
+    uint32_t signal_mask = reader.read(32);
+
+    size_t satellites = 0;
+    for (unsigned i = 0; i < 64; i++)
+    {
+        if (satellite_mask & (uint64_t(1) << (63 - i)))
+            obs.satellite_id[satellites++] = i + 1;
+    }
+
+    uint8_t signals[32];
+    size_t signal_count = 0;
+    for (unsigned i = 0; i < 32; i++)
+    {
+        if (signal_mask & (uint32_t(1) << (31 - i)))
+            signals[signal_count++] = i + 1;
+    }
+
+    // The cell mask is limited to 64 bits
+    if (satellites * signal_count > GNSSMSMObservations::MAX_CELLS)
+    {
+        return false;
+    }
+
+    size_t mask_bits = satellites * signal_count;
+    uint64_t cell_mask = reader.read(mask_bits);
+    size_t cells = 0;
+    for (size_t i = 0; i < mask_bits; i++)
+    {
+        if (cell_mask & (uint64_t(1) << (mask_bits - 1 - i)))
+        {
+            obs.cell_satellite[cells] = i / signal_count;
+            obs.signal_id[cells] = signals[i % signal_count];
+            cells++;
+        }
+    }
+    obs.satellite_count = satellites;
+    obs.cell_count = cells;
+
+    // Satellite data: each field for every satellite in turn
+    bool extended = type == 5 || type == 7;
+    double rough_range[GNSSMSMObservations::MAX_SATELLITES];
+    double rough_rate[GNSSMSMObservations::MAX_SATELLITES];
+
+    for (size_t i = 0; i < satellites; i++)
+    {
+        uint32_t milliseconds = reader.read(8);
+        rough_range[i] = milliseconds == 255 ? NAN : milliseconds;
+    }
+    for (size_t i = 0; i < satellites; i++)
+    {
+        obs.satellite_info[i] = extended ? reader.read(4) : 0;
+    }
+    for (size_t i = 0; i < satellites; i++)
+    {
+        rough_range[i] += reader.read(10) / 1024.0;
+    }
+    for (size_t i = 0; i < satellites; i++)
+    {
+        int32_t rate = extended ? reader.readSigned(14) : -8192;
+        rough_rate[i] = rate == -8192 ? NAN : rate;
+    }
+
+    // Signal data: each field for every cell in turn. MSM6/7 use the
+    // extended resolution fields.
+    bool fine = type >= 6;
+    unsigned range_bits = fine ? 20 : 15;
+    unsigned phase_bits = fine ? 24 : 22;
+    double range_scale = fine ? 1.0 / (1 << 29) : 1.0 / (1 << 24);
+    double phase_scale = fine ? 1.0 / (1u << 31) : 1.0 / (1 << 29);
+
+    for (size_t i = 0; i < cells; i++)
+    {
+        int32_t value = reader.readSigned(range_bits);
+        double rough = rough_range[obs.cell_satellite[i]];
+        obs.pseudorange[i] = value == -(1 << (range_bits - 1)) ? NAN : (rough + value * range_scale) * RANGE_MS;
+    }
+    for (size_t i = 0; i < cells; i++)
+    {
+        int32_t value = reader.readSigned(phase_bits);
+        double rough = rough_range[obs.cell_satellite[i]];
+        obs.phaserange[i] = value == -(1 << (phase_bits - 1)) ? NAN : (rough + value * phase_scale) * RANGE_MS;
+    }
+    for (size_t i = 0; i < cells; i++)
+    {
+        obs.lock_time[i] = reader.read(fine ? 10 : 4);
+    }
+    for (size_t i = 0; i < cells; i++)
+    {
+        obs.half_cycle[i] = reader.readBit();
+    }
+    for (size_t i = 0; i < cells; i++)
+    {
+        obs.cnr[i] = fine ? reader.read(10) / 16.0f : reader.read(6);
+    }
+    for (size_t i = 0; i < cells; i++)
+    {
+        int32_t value = extended ? reader.readSigned(15) : -16384;
+        double rough = rough_rate[obs.cell_satellite[i]];
+        obs.phaserange_rate[i] = value == -16384 ? NAN : rough + value * 0.0001;
+    }
+
+    return !reader.overflow();
+}
+
+bool GNSSMSMDecoder::decode(const GNSSParserBase::MessageView &view, GNSSMSMObservations &obs)
+{
+    if (!view.second)
+    {
+        return decode(view.first, view.first_length, obs);
+    }
+
+    uint8_t frame[GNSSParserBase::MAX_RTCM3_LENGTH];
+    if (view.length() > sizeof(frame))
+    {
+        return false;
+    }
+
+    size_t length = view.copyTo(frame);
+    return decode(frame, length, obs);
+}
+
+double GNSSMSMDecoder::carrierFrequency(GNSSSystem::Type system, uint8_t signal_id, int glonass_channel)
+{
+    const double L1 = 1575.42e6;
+    const double L2 = 1227.60e6;
+    const double L5 = 1176.45e6;
+    const double E6 = 1278.75e6;
+    const double E5B = 1207.14e6;
+
+    switch (system)
+    {
+    case GNSSSystem::GPS:
+        if ((signal_id >= 2 && signal_id <= 4) || signal_id >= 30)
+            return L1;
+        if (signal_id >= 8 && signal_id <= 17)
+            return L2;
+        if (signal_id >= 22 && signal_id <= 24)
+            return L5;
+        break;
+
+    case GNSSSystem::GLONASS:
+        if (signal_id == 2 || signal_id == 3)
+            return 1602.0e6 + glonass_channel * 0.5625e6;
+        if (signal_id == 8 || signal_id == 9)
+            return 1246.0e6 + glonass_channel * 0.4375e6;
+        break;
+
+    case GNSSSystem::GALILEO:
+        if (signal_id >= 2 && signal_id <= 6)
+            return L1;
+        if (signal_id >= 8 && signal_id <= 12)
+            return E6;
+        if (signal_id >= 14 && signal_id <= 16)
+            return E5B;
+        if (signal_id >= 18 && signal_id <= 20)
+            return 1191.795e6;
+        if (signal_id >= 22 && signal_id <= 24)
+            return L5;
+        break;
+
+    case GNSSSystem::SBAS:
+        if (signal_id == 2)
+            return L1;
+        if (signal_id >= 22 && signal_id <= 24)
+            return L5;
+        break;
+
+    case GNSSSystem::QZSS:
+        if (signal_id == 2 || signal_id >= 30)
+            return L1;
+        if (signal_id >= 9 && signal_id <= 11)
+            return E6;
+        if (signal_id >= 15 && signal_id <= 17)
+            return L2;
+        if (signal_id >= 22 && signal_id <= 24)
+            return L5;
+        break;
+
+    case GNSSSystem::BEIDOU:
+        if (signal_id >= 2 && signal_id <= 4)
+            return 1561.098e6;
+        if (signal_id >= 8 && signal_id <= 10)
+            return 1268.52e6;
+        if ((signal_id >= 14 && signal_id <= 16) || signal_id == 25)
+            return E5B;
+        if (signal_id >= 22 && signal_id <= 24)
+            return L5;
+        if (signal_id >= 30)
+            return L1;
+        break;
+
+    case GNSSSystem::NAVIC:
+        if (signal_id == 22)
+            return L5;
+        break;
+
+    default:
+        break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "GNSSMappedFile.h"
+
+#if !defined(ARDUINO)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GNSS_MAPPED_FILE_MMAP 1
+#endif
+
+GNSSMappedFile::GNSSMappedFile(const char *path)
+{
+#if defined(GNSS_MAPPED_FILE_MMAP)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+    {
+        size_ = static_cast<size_t>(st.st_size);
+        valid_ = true;
+
+        if (size_ > 0)
+        {
+            void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                // Captures are parsed front to back
+                madvise(data, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<uint8_t *>(data);
+                mapped_ = true;
+            }
+            else
+            {
+                valid_ = false;
+            }
+        }
+    }
+
+    close(fd);
+#else
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return;
+
+    size_t capacity = 0;
+    uint8_t buffer[65536];
+    size_t bytes_read;
+    valid_ = true;
+
+    while ((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        if (size_ + bytes_read > capacity)
+        {
+            capacity = (size_ + bytes_read) * 2;
+            uint8_t *grown = static_cast<uint8_t *>(realloc(data_, capacity));
+            if (!grown)
+            {
+                valid_ = false;
+                break;
+            }
+            data_ = grown;
+        }
+
+        memcpy(data_ + size_, buffer, bytes_read);
+        size_ += bytes_read;
+    }
+
+    fclose(file);
+#endif
+}
+
+GNSSMappedFile::~GNSSMappedFile()
+{
+#if defined(GNSS_MAPPED_FILE_MMAP)
+    if (mapped_)
+        munmap(data_, size_);
+#else
+    free(data_);
+#endif
+}
+
+#endif
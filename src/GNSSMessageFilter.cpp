@@ -0,0 +1,127 @@
+#include "GNSSMessageFilter.h"
+#include <string.h>
+
+constexpr size_t GNSSMessageFilter::MAX_NMEA_ADDRESSES;
+constexpr size_t GNSSMessageFilter::MAX_ADDRESS_LENGTH;
+constexpr size_t GNSSMessageFilter::RTCM3_HEAD_LENGTH;
+constexpr size_t GNSSMessageFilter::NMEA_HEAD_LENGTH;
+constexpr size_t GNSSMessageFilter::MAX_UBX_MESSAGES;
+constexpr size_t GNSSMessageFilter::UBX_HEAD_LENGTH;
+
+void GNSSMessageFilter::clear()
+{
+    rtcm3_filtered_ = false;
+    nmea_filtered_ = false;
+    ubx_filtered_ = false;
+    skip_rejected_ = false;
+    nmea_count_ = 0;
+    ubx_count_ = 0;
+    memset(ubx_classes_, 0, sizeof(ubx_classes_));
+    memset(rtcm3_, 0, sizeof(rtcm3_));
+}
+
+void GNSSMessageFilter::allowRTCM3(uint16_t first, uint16_t last)
+{
+    rtcm3_filtered_ = true;
+    for (uint32_t number = first; number <= last && number < 4096; number++)
+        rtcm3_[number >> 5] |= uint32_t(1) << (number & 31);
+}
+
+void GNSSMessageFilter::blockRTCM3()
+{
+    rtcm3_filtered_ = true;
+    memset(rtcm3_, 0, sizeof(rtcm3_));
+}
+
+bool GNSSMessageFilter::allowNMEA(const char *address)
+{
+    size_t length = strlen(address);
+    if (length == 0 || length > MAX_ADDRESS_LENGTH || nmea_count_ == MAX_NMEA_ADDRESSES)
+    {
+        return false;
+    }
+
+    nmea_filtered_ = true;
+    memcpy(nmea_[nmea_count_], address, length);
+    nmea_lengths_[nmea_count_] = static_cast<uint8_t>(length);
+    nmea_count_++;
+    return true;
+}
+
+void GNSSMessageFilter::blockNMEA()
+{
+    nmea_filtered_ = true;
+    nmea_count_ = 0;
+}
+
+bool GNSSMessageFilter::passesNMEA(const uint8_t *address, size_t length) const
+{
+    if (!nmea_filtered_)
+    {
+        return true;
+    }
+
+    // The address ends at the first ',' or '*'; one cut off is longer than
+    // any in the table
+    size_t end = 0;
+    while (end < length && address[end] != ',' && address[end] != '*')
+        end++;
+    bool complete = end < length;
+
+    for (size_t i = 0; i < nmea_count_; i++)
+    {
+        size_t n = nmea_lengths_[i];
+        if (n == 3)
+        {
+            // Formatter: the last three characters, whatever the talker
+            if (complete && end >= 3 && memcmp(address + end - 3, nmea_[i], 3) == 0)
+                return true;
+        }
+        else if (complete && end == n && memcmp(address, nmea_[i], n) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GNSSMessageFilter::allowUBX(uint8_t message_class)
+{
+    ubx_filtered_ = true;
+    ubx_classes_[message_class >> 5] |= uint32_t(1) << (message_class & 31);
+}
+
+bool GNSSMessageFilter::allowUBX(uint8_t message_class, uint8_t id)
+{
+    if (ubx_count_ == MAX_UBX_MESSAGES)
+    {
+        return false;
+    }
+
+    ubx_filtered_ = true;
+    ubx_[ubx_count_++] = static_cast<uint16_t>((message_class << 8) | id);
+    return true;
+}
+
+void GNSSMessageFilter::blockUBX()
+{
+    ubx_filtered_ = true;
+    ubx_count_ = 0;
+    memset(ubx_classes_, 0, sizeof(ubx_classes_));
+}
+
+bool GNSSMessageFilter::passesUBX(uint8_t message_class, uint8_t id) const
+{
+    if (!ubx_filtered_ || ((ubx_classes_[message_class >> 5] >> (message_class & 31)) & 1))
+    {
+        return true;
+    }
+
+    uint16_t key = static_cast<uint16_t>((message_class << 8) | id);
+    for (size_t i = 0; i < ubx_count_; i++)
+    {
+        if (ubx_[i] == key)
+            return true;
+    }
+    return false;
+}
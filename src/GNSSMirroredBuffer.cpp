@@ -0,0 +1,67 @@
+#include "GNSSMirroredBuffer.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+GNSSMirroredBuffer::GNSSMirroredBuffer(size_t size)
+{
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (size == 0 || page_size <= 0 || size % static_cast<size_t>(page_size) != 0)
+        return;
+
+    int fd = static_cast<int>(syscall(SYS_memfd_create, "gnss_parser_ring", MFD_CLOEXEC));
+    if (fd < 0)
+        return;
+
+    if (ftruncate(fd, size) != 0)
+    {
+        close(fd);
+        return;
+    }
+
+    // Reserve both halves first so the second mapping lands right after the first
+    void *base = mmap(nullptr, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+    {
+        close(fd);
+        return;
+    }
+
+    uint8_t *first = static_cast<uint8_t *>(base);
+    if (mmap(first, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(first + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        munmap(base, 2 * size);
+        close(fd);
+        return;
+    }
+
+    close(fd);
+    data_ = first;
+    size_ = size;
+}
+
+GNSSMirroredBuffer::~GNSSMirroredBuffer()
+{
+    if (data_)
+        munmap(data_, 2 * size_);
+}
+
+#else
+
+GNSSMirroredBuffer::GNSSMirroredBuffer(size_t)
+{
+}
+
+GNSSMirroredBuffer::~GNSSMirroredBuffer()
+{
+}
+
+#endif
@@ -0,0 +1,423 @@
+#include "GNSSNMEA.h"
+#include <math.h>
+#include <string.h>
+
+constexpr size_t GNSSNMEAFields::MAX_FIELDS;
+constexpr size_t GNSSNMEAGSA::MAX_SATELLITES;
+constexpr size_t GNSSNMEAGSV::MAX_SATELLITES;
+constexpr int8_t GNSSSatelliteInView::UNKNOWN_ELEVATION;
+constexpr uint16_t GNSSSatelliteInView::UNKNOWN_AZIMUTH;
+
+// Powers of ten held exactly by a double
+static const double POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                               1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static inline bool isDigit(char c)
+{
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// Digits from data[i] on, up to `limit` of them kept in value, the rest
+// skipped. Returns the number of digits read.
+static size_t readDigits(const char *data, size_t length, size_t &i, uint64_t &value, size_t limit)
+{
+    size_t start = i;
+    for (; i < length && isDigit(data[i]); i++)
+    {
+        if (i - start < limit)
+            value = value * 10 + (data[i] - '0');
+    }
+    return i - start;
+}
+
+GNSSNMEAFields::GNSSNMEAFields(const GNSSParserBase::MessageView &view)
+{
+    if (!view.second)
+    {
+        split(reinterpret_cast<const char *>(view.first), view.first_length);
+        return;
+    }
+
+    size_t first = view.first_length < sizeof(copy_) ? view.first_length : sizeof(copy_);
+    size_t second = view.second_length < sizeof(copy_) - first ? view.second_length : sizeof(copy_) - first;
+    memcpy(copy_, view.first, first);
+    memcpy(copy_ + first, view.second, second);
+    split(copy_, first + second);
+}
+
+void GNSSNMEAFields::split(const char *sentence, size_t length)
+{
+    data_ = sentence;
+    if (length > UINT16_MAX - 1)
+        length = UINT16_MAX - 1;
+
+    size_t i = length && (sentence[0] == '$' || sentence[0] == '!') ? 1 : 0;
+    size_t count = 0;
+    begin_[0] = static_cast<uint16_t>(i);
+    for (; i < length; i++)
+    {
+        char c = sentence[i];
+        if (c == ',')
+        {
+            if (count + 1 == MAX_FIELDS)
+                break;
+            begin_[++count] = static_cast<uint16_t>(i + 1);
+        }
+        else if (c == '*' || c == '\r' || c == '\n')
+        {
+            break;
+        }
+    }
+    begin_[count + 1] = static_cast<uint16_t>(i + 1);
+    count_ = count + 1;
+}
+
+bool GNSSNMEAFields::is(const char *formatter) const
+{
+    GNSSNMEAField address = field(0);
+    size_t length = strlen(formatter);
+    return address.length >= length && memcmp(address.data + address.length - length, formatter, length) == 0;
+}
+
+GNSSSystem::Type GNSSNMEAFields::system() const
+{
+    GNSSNMEAField address = field(0);
+    if (address.length < 2)
+        return GNSSSystem::NONE;
+
+    switch ((address.data[0] << 8) | address.data[1])
+    {
+    case ('G' << 8) | 'P':
+        return GNSSSystem::GPS;
+    case ('G' << 8) | 'L':
+        return GNSSSystem::GLONASS;
+    case ('G' << 8) | 'A':
+        return GNSSSystem::GALILEO;
+    case ('G' << 8) | 'B':
+    case ('B' << 8) | 'D':
+        return GNSSSystem::BEIDOU;
+    case ('G' << 8) | 'Q':
+    case ('Q' << 8) | 'Z':
+        return GNSSSystem::QZSS;
+    case ('G' << 8) | 'I':
+        return GNSSSystem::NAVIC;
+    default:
+        return GNSSSystem::NONE;
+    }
+}
+
+double GNSSNMEAFields::number(size_t index) const
+{
+    GNSSNMEAField f = field(index);
+    double value = NAN;
+    parseNumber(f.data, f.length, value);
+    return value;
+}
+
+uint32_t GNSSNMEAFields::integer(size_t index, uint32_t missing) const
+{
+    GNSSNMEAField f = field(index);
+    uint32_t value = missing;
+    parseInteger(f.data, f.length, value);
+    return value;
+}
+
+double GNSSNMEAFields::coordinate(size_t index) const
+{
+    GNSSNMEAField f = field(index);
+    double value = NAN;
+    parseCoordinate(f.data, f.length, character(index + 1), value);
+    return value;
+}
+
+double GNSSNMEAFields::time(size_t index) const
+{
+    GNSSNMEAField f = field(index);
+    double value = NAN;
+    parseTime(f.data, f.length, value);
+    return value;
+}
+
+bool GNSSNMEAFields::parseNumber(const char *data, size_t length, double &value)
+{
+    size_t i = 0;
+    bool negative = false;
+    if (i < length && (data[i] == '-' || data[i] == '+'))
+        negative = data[i++] == '-';
+
+    // Digits past the 19th significant one only move the decimal point
+    uint64_t mantissa = 0;
+    size_t significant = 0;
+    int exponent = 0;
+    bool digits = false;
+    for (; i < length && isDigit(data[i]); i++)
+    {
+        digits = true;
+        if (significant < 19)
+        {
+            mantissa = mantissa * 10 + (data[i] - '0');
+            significant += mantissa != 0;
+        }
+        else
+        {
+            exponent++;
+        }
+    }
+    if (i < length && data[i] == '.')
+    {
+        for (i++; i < length && isDigit(data[i]); i++)
+        {
+            digits = true;
+            if (significant < 19)
+            {
+                mantissa = mantissa * 10 + (data[i] - '0');
+                significant += mantissa != 0;
+                exponent--;
+            }
+        }
+    }
+    if (!digits || i != length)
+        return false;
+
+    double result = static_cast<double>(mantissa);
+    if (exponent < 0)
+    {
+        for (; exponent < -22; exponent += 22)
+            result /= POW10[22];
+        result /= POW10[-exponent];
+    }
+    else if (exponent > 0)
+    {
+        for (; exponent > 22; exponent -= 22)
+            result *= POW10[22];
+        result *= POW10[exponent];
+    }
+    value = negative ? -result : result;
+    return true;
+}
+
+bool GNSSNMEAFields::parseInteger(const char *data, size_t length, uint32_t &value)
+{
+    if (!length || length > 9)
+        return false;
+
+    size_t i = 0;
+    uint64_t result = 0;
+    if (readDigits(data, length, i, result, 9) != length)
+        return false;
+    value = static_cast<uint32_t>(result);
+    return true;
+}
+
+bool GNSSNMEAFields::parseCoordinate(const char *data, size_t length, char hemisphere, double &degrees)
+{
+    bool negative = hemisphere == 'S' || hemisphere == 'W';
+    if (!negative && hemisphere != 'N' && hemisphere != 'E')
+        return false;
+
+    size_t i = 0;
+    uint64_t whole = 0;
+    size_t digits = readDigits(data, length, i, whole, 9);
+    if (digits < 3 || digits > 5)
+        return false;
+
+    // Minutes as one fraction, divided once
+    uint64_t fraction = 0;
+    size_t places = 0;
+    if (i < length && data[i] == '.')
+    {
+        i++;
+        places = readDigits(data, length, i, fraction, 15);
+        if (places > 15)
+            places = 15;
+    }
+    if (i != length)
+        return false;
+
+    double minutes = static_cast<double>((whole % 100) * static_cast<uint64_t>(POW10[places]) + fraction) /
+                     POW10[places];
+    double result = static_cast<double>(whole / 100) + minutes / 60.0;
+    degrees = negative ? -result : result;
+    return true;
+}
+
+bool GNSSNMEAFields::parseTime(const char *data, size_t length, double &seconds)
+{
+    size_t i = 0;
+    uint64_t hhmmss = 0;
+    if (readDigits(data, length, i, hhmmss, 6) != 6)
+        return false;
+
+    uint64_t fraction = 0;
+    size_t places = 0;
+    if (i < length && data[i] == '.')
+    {
+        i++;
+        places = readDigits(data, length, i, fraction, 9);
+        if (places > 9)
+            places = 9;
+    }
+    if (i != length)
+        return false;
+
+    unsigned hours = static_cast<unsigned>(hhmmss / 10000);
+    unsigned minutes = static_cast<unsigned>(hhmmss / 100 % 100);
+    unsigned secs = static_cast<unsigned>(hhmmss % 100);
+    if (hours > 23 || minutes > 59 || secs > 60)
+        return false;
+
+    seconds = hours * 3600.0 + minutes * 60.0 + secs + fraction / POW10[places];
+    return true;
+}
+
+bool GNSSNMEADecoder::decode(const GNSSNMEAFields &fields, GNSSNMEAGGA &gga)
+{
+    if (!fields.is("GGA"))
+        return false;
+
+    gga.time = fields.time(1);
+    gga.latitude = fields.coordinate(2);
+    gga.longitude = fields.coordinate(4);
+    gga.quality = static_cast<uint8_t>(fields.integer(6));
+    gga.satellites = static_cast<uint8_t>(fields.integer(7));
+    gga.hdop = fields.number(8);
+    gga.altitude = fields.number(9);
+    gga.geoid_separation = fields.number(11);
+    gga.correction_age = fields.number(13);
+    gga.reference_station = static_cast<uint16_t>(fields.integer(14));
+    return true;
+}
+
+bool GNSSNMEADecoder::decode(const GNSSNMEAFields &fields, GNSSNMEARMC &rmc)
+{
+    if (!fields.is("RMC"))
+        return false;
+
+    rmc.time = fields.time(1);
+    rmc.valid = fields.character(2) == 'A';
+    rmc.latitude = fields.coordinate(3);
+    rmc.longitude = fields.coordinate(5);
+    rmc.speed = fields.number(7);
+    rmc.course = fields.number(8);
+
+    // ddmmyy
+    uint32_t date = 0;
+    GNSSNMEAField f = fields.field(9);
+    if (f.length == 6 && GNSSNMEAFields::parseInteger(f.data, f.length, date))
+    {
+        rmc.day = static_cast<uint8_t>(date / 10000);
+        rmc.month = static_cast<uint8_t>(date / 100 % 100);
+        rmc.year = static_cast<uint16_t>(date % 100 < 80 ? 2000 + date % 100 : 1900 + date % 100);
+    }
+    else
+    {
+        rmc.day = rmc.month = 0;
+        rmc.year = 0;
+    }
+
+    rmc.magnetic_variation = fields.number(10);
+    if (fields.character(11) == 'W')
+        rmc.magnetic_variation = -rmc.magnetic_variation;
+    rmc.mode = fields.character(12);
+    rmc.nav_status = fields.character(13);
+    return true;
+}
+
+bool GNSSNMEADecoder::decode(const GNSSNMEAFields &fields, GNSSNMEAGSA &gsa)
+{
+    if (!fields.is("GSA"))
+        return false;
+
+    gsa.selection = fields.character(1);
+    gsa.fix = static_cast<uint8_t>(fields.integer(2));
+    gsa.satellite_count = 0;
+    for (size_t i = 0; i < GNSSNMEAGSA::MAX_SATELLITES; i++)
+    {
+        uint32_t id = fields.integer(3 + i);
+        if (id)
+            gsa.satellites[gsa.satellite_count++] = static_cast<uint16_t>(id);
+    }
+    gsa.pdop = fields.number(15);
+    gsa.hdop = fields.number(16);
+    gsa.vdop = fields.number(17);
+    gsa.system_id = static_cast<uint8_t>(fields.integer(18));
+    return true;
+}
+
+bool GNSSNMEADecoder::decode(const GNSSNMEAFields &fields, GNSSNMEAVTG &vtg)
+{
+    if (!fields.is("VTG"))
+        return false;
+
+    vtg.course = fields.number(1);
+    vtg.magnetic_course = fields.number(3);
+    vtg.speed_knots = fields.number(5);
+    vtg.speed_kmh = fields.number(7);
+    vtg.mode = fields.character(9);
+    return true;
+}
+
+bool GNSSNMEADecoder::decode(const GNSSNMEAFields &fields, GNSSNMEAGST &gst)
+{
+    if (!fields.is("GST"))
+        return false;
+
+    gst.time = fields.time(1);
+    gst.rms = fields.number(2);
+    gst.semi_major = fields.number(3);
+    gst.semi_minor = fields.number(4);
+    gst.orientation = fields.number(5);
+    gst.latitude_sigma = fields.number(6);
+    gst.longitude_sigma = fields.number(7);
+    gst.altitude_sigma = fields.number(8);
+    return true;
+}
+
+bool GNSSNMEADecoder::decode(const GNSSNMEAFields &fields, GNSSNMEAGSV &gsv)
+{
+    if (!fields.is("GSV") || fields.count() < 4)
+        return false;
+
+    uint32_t sentences = fields.integer(1);
+    uint32_t sentence = fields.integer(2);
+    uint32_t in_view = fields.integer(3, 256);
+    if (sentences < 1 || sentences > 9 || sentence < 1 || sentence > sentences || in_view > 255)
+        return false;
+
+    // Up to four blocks of ID, elevation, azimuth, SNR, then the signal ID
+    size_t blocks = (fields.count() - 4) / 4;
+    if (blocks > GNSSNMEAGSV::MAX_SATELLITES)
+        blocks = GNSSNMEAGSV::MAX_SATELLITES;
+    uint8_t signal_id = 0;
+    if ((fields.count() - 4) % 4 == 1)
+    {
+        char c = fields.character(fields.count() - 1);
+        signal_id = static_cast<uint8_t>(isDigit(c) ? c - '0' : c >= 'A' && c <= 'F' ? c - 'A' + 10 : 0);
+    }
+
+    GNSSSystem::Type system = fields.system();
+    gsv.count = 0;
+    for (size_t b = 0; b < blocks; b++)
+    {
+        size_t index = 4 + 4 * b;
+        uint32_t id = fields.integer(index);
+        if (!id)
+            continue;
+
+        uint32_t elevation = fields.integer(index + 1, 0xFFFFFFFF);
+        uint32_t azimuth = fields.integer(index + 2, 0xFFFFFFFF);
+        GNSSSatelliteInView &satellite = gsv.satellites[gsv.count++];
+        satellite.id = static_cast<uint16_t>(id);
+        satellite.elevation = elevation <= 90 ? static_cast<int8_t>(elevation) : GNSSSatelliteInView::UNKNOWN_ELEVATION;
+        satellite.azimuth = azimuth < 360 ? static_cast<uint16_t>(azimuth) : GNSSSatelliteInView::UNKNOWN_AZIMUTH;
+        satellite.snr = static_cast<uint8_t>(fields.integer(index + 3) < 100 ? fields.integer(index + 3) : 0);
+        satellite.system = system;
+        satellite.signal_id = signal_id;
+    }
+
+    gsv.sentences = static_cast<uint8_t>(sentences);
+    gsv.sentence = static_cast<uint8_t>(sentence);
+    gsv.in_view = static_cast<uint8_t>(in_view);
+    gsv.signal_id = signal_id;
+    return true;
+}
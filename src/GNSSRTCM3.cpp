@@ -0,0 +1,3 @@
+#include "GNSSRTCM3.h"
+
+constexpr size_t GNSSRTCM3Header::HEAD_LENGTH;
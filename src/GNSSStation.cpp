@@ -0,0 +1,177 @@
+#include "GNSSStation.h"
+#include "GNSSBitReader.h"
+#include <math.h>
+#include <string.h>
+
+constexpr size_t GNSSStationInfo::MAX_STRING;
+
+// Counted string field (DF029 / DF030 and the like): an 8-bit count, then
+// that many characters, of which the first MAX_STRING are kept
+static void readString(GNSSBitReader &reader, char *destination)
+{
+    size_t count = reader.read(8);
+    size_t kept = count < GNSSStationInfo::MAX_STRING ? count : GNSSStationInfo::MAX_STRING;
+    for (size_t i = 0; i < kept; i++)
+        destination[i] = static_cast<char>(reader.read(8));
+    destination[kept] = '\0';
+    reader.skip((count - kept) * 8);
+}
+
+uint8_t GNSSStationDecoder::messageBit(uint16_t message_number)
+{
+    switch (message_number)
+    {
+    case 1005:
+        return GNSSStationInfo::MESSAGE_1005;
+    case 1006:
+        return GNSSStationInfo::MESSAGE_1006;
+    case 1007:
+        return GNSSStationInfo::MESSAGE_1007;
+    case 1008:
+        return GNSSStationInfo::MESSAGE_1008;
+    case 1033:
+        return GNSSStationInfo::MESSAGE_1033;
+    case 1230:
+        return GNSSStationInfo::MESSAGE_1230;
+    default:
+        return 0;
+    }
+}
+
+uint8_t GNSSStationDecoder::overlappingBits(uint8_t bit)
+{
+    const uint8_t position = GNSSStationInfo::MESSAGE_1005 | GNSSStationInfo::MESSAGE_1006;
+    const uint8_t descriptors = GNSSStationInfo::MESSAGE_1007 | GNSSStationInfo::MESSAGE_1008 | GNSSStationInfo::MESSAGE_1033;
+    if (bit & position)
+        return position & ~bit;
+    if (bit & descriptors)
+        return descriptors & ~bit;
+    return 0;
+}
+
+bool GNSSStationDecoder::sameSharedFields(uint8_t bit, const GNSSStationInfo &a, const GNSSStationInfo &b)
+{
+    if (bit & (GNSSStationInfo::MESSAGE_1005 | GNSSStationInfo::MESSAGE_1006))
+    {
+        return a.x == b.x && a.y == b.y && a.z == b.z && a.itrf_year == b.itrf_year && a.gps == b.gps &&
+               a.glonass == b.glonass && a.galileo == b.galileo && a.reference_station == b.reference_station && a.single_oscillator == b.single_oscillator &&
+               a.quarter_cycle == b.quarter_cycle;
+    }
+    if (bit & (GNSSStationInfo::MESSAGE_1007 | GNSSStationInfo::MESSAGE_1008 | GNSSStationInfo::MESSAGE_1033))
+    {
+        return a.antenna_setup_id == b.antenna_setup_id && strcmp(a.antenna_descriptor, b.antenna_descriptor) == 0 &&
+               strcmp(a.antenna_serial, b.antenna_serial) == 0 && strcmp(a.receiver_type, b.receiver_type) == 0 &&
+               strcmp(a.receiver_firmware, b.receiver_firmware) == 0 &&
+               strcmp(a.receiver_serial, b.receiver_serial) == 0;
+    }
+    return true;
+}
+
+void GNSSStationDecoder::reset(GNSSStationInfo &info, uint16_t station_id)
+{
+    memset(&info, 0, sizeof(info));
+    info.station_id = station_id;
+    info.l1_ca_bias = info.l1_p_bias = info.l2_ca_bias = info.l2_p_bias = NAN;
+}
+
+bool GNSSStationDecoder::decode(const uint8_t *frame, size_t length, GNSSStationInfo &info)
+{
+    GNSSRTCM3Header header(frame, length);
+    uint16_t number = header.messageNumber();
+    uint8_t bit = messageBit(number);
+    size_t payload_length = header.payloadLength();
+    if (!bit || length < 6 || payload_length + 6 > length)
+    {
+        return false;
+    }
+
+    // Decode into a copy, so a short payload leaves info untouched
+    GNSSStationInfo decoded = info;
+    GNSSBitReader reader(frame + 3, payload_length);
+    reader.skip(12);
+    decoded.station_id = reader.read(12);
+
+    switch (number)
+    {
+    case 1005:
+    case 1006:
+        decoded.itrf_year = reader.read(6);
+        decoded.gps = reader.readBit();
+        decoded.glonass = reader.readBit();
+        decoded.galileo = reader.readBit();
+        decoded.reference_station = reader.readBit();
+        decoded.x = reader.readSigned(38) * 0.0001;
+        decoded.single_oscillator = reader.readBit();
+        reader.skip(1);
+        decoded.y = reader.readSigned(38) * 0.0001;
+        decoded.quarter_cycle = reader.read(2);
+        decoded.z = reader.readSigned(38) * 0.0001;
+        if (number == 1006)
+            decoded.antenna_height = reader.read(16) * 0.0001;
+        break;
+
+    case 1007:
+    case 1008:
+    case 1033:
+        readString(reader, decoded.antenna_descriptor);
+        decoded.antenna_setup_id = reader.read(8);
+        if (number == 1007)
+            break;
+        readString(reader, decoded.antenna_serial);
+        if (number == 1008)
+            break;
+        readString(reader, decoded.receiver_type);
+        readString(reader, decoded.receiver_firmware);
+        readString(reader, decoded.receiver_serial);
+        break;
+
+    case 1230:
+    {
+        decoded.biases_aligned = reader.readBit();
+        reader.skip(3);
+        unsigned mask = reader.read(4);
+        double *biases[] = {&decoded.l1_ca_bias, &decoded.l1_p_bias, &decoded.l2_ca_bias, &decoded.l2_p_bias};
+        for (unsigned i = 0; i < 4; i++)
+            *biases[i] = mask & (8 >> i) ? reader.readSigned(16) * 0.02 : NAN;
+        break;
+    }
+    }
+
+    if (reader.overflow())
+    {
+        return false;
+    }
+
+    decoded.messages |= bit;
+    info = decoded;
+    return true;
+}
+
+bool GNSSStationDecoder::decode(const GNSSParserBase::MessageView &view, GNSSStationInfo &info)
+{
+    if (!view.second)
+    {
+        return decode(view.first, view.first_length, info);
+    }
+
+    uint8_t frame[GNSSParserBase::MAX_RTCM3_LENGTH];
+    if (view.length() > sizeof(frame))
+    {
+        return false;
+    }
+
+    size_t length = view.copyTo(frame);
+    return decode(frame, length, info);
+}
+
+uint32_t GNSSStationDecoder::frameCRC(const GNSSParserBase::MessageView &view)
+{
+    uint32_t crc = 0;
+    size_t length = view.length();
+    for (size_t i = length >= 3 ? length - 3 : 0; i < length; i++)
+    {
+        uint8_t byte = i < view.first_length ? view.first[i] : view.second[i - view.first_length];
+        crc = (crc << 8) | byte;
+    }
+    return crc;
+}
@@ -0,0 +1,233 @@
+#include "GNSSSyncSearch.h"
+#include "GNSSFramer.h"
+
+#if !defined(ARDUINO) && defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define GNSS_SYNC_SEARCH_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#elif !defined(ARDUINO) && defined(__aarch64__)
+#define GNSS_SYNC_SEARCH_NEON 1
+#include <arm_neon.h>
+#endif
+
+constexpr size_t GNSSSyncSearch::MAX_SET_SIZE;
+
+const GNSSSyncSearch::Set GNSSSyncSearch::FRAME_STARTS =
+    GNSSDefaultFramers::firstBytes(GNSSDefaultFramers::enabled(GNSSProtocol::ALL));
+
+const GNSSSyncSearch::Engine GNSSSyncSearch::SELECTED_ENGINE = GNSSSyncSearch::initialize();
+
+GNSSSyncSearch::Engine GNSSSyncSearch::initialize()
+{
+    if (supported(AVX2))
+        return AVX2;
+    if (supported(SSE2))
+        return SSE2;
+    if (supported(NEON))
+        return NEON;
+    return SCALAR;
+}
+
+GNSSSyncSearch::Engine GNSSSyncSearch::engine()
+{
+    return SELECTED_ENGINE;
+}
+
+size_t GNSSSyncSearch::findBlock(const uint8_t *data, size_t length, const Set &set)
+{
+    switch (SELECTED_ENGINE)
+    {
+    case AVX2:
+        return findAVX2(data, length, set);
+    case SSE2:
+        return findSSE2(data, length, set);
+    case NEON:
+        return findNEON(data, length, set);
+    default:
+        return findScalar(data, length, set);
+    }
+}
+
+#if defined(GNSS_SYNC_SEARCH_X86)
+
+static bool cpuHasAVX2()
+{
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    // The OS must also save the YMM registers
+    if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX))
+        return false;
+
+    unsigned int xcr0_lo, xcr0_hi;
+    __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if ((xcr0_lo & 0x6) != 0x6)
+        return false;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    return (ebx & bit_AVX2) != 0;
+}
+
+bool GNSSSyncSearch::supported(Engine engine)
+{
+    if (engine == AVX2)
+        return cpuHasAVX2();
+    return engine == SCALAR || engine == SSE2;
+}
+
+// One kernel per set size, so the compares are unrolled
+template <size_t N>
+static size_t findSSE2Bytes(const uint8_t *data, size_t length, const GNSSSyncSearch::Set &set)
+{
+    __m128i targets[N];
+    for (size_t k = 0; k < N; k++)
+        targets[k] = _mm_set1_epi8(static_cast<char>(set.bytes[k]));
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i hits = _mm_cmpeq_epi8(v, targets[0]);
+        for (size_t k = 1; k < N; k++)
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, targets[k]));
+        unsigned int mask = _mm_movemask_epi8(hits);
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    return i + GNSSSyncSearch::findScalar(data + i, length - i, set);
+}
+
+template <size_t N>
+__attribute__((target("avx2"))) static size_t findAVX2Bytes(const uint8_t *data, size_t length, const GNSSSyncSearch::Set &set)
+{
+    __m256i targets[N];
+    for (size_t k = 0; k < N; k++)
+        targets[k] = _mm256_set1_epi8(static_cast<char>(set.bytes[k]));
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        __m256i hits = _mm256_cmpeq_epi8(v, targets[0]);
+        for (size_t k = 1; k < N; k++)
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(v, targets[k]));
+        unsigned int mask = _mm256_movemask_epi8(hits);
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    return i + GNSSSyncSearch::findSSE2(data + i, length - i, set);
+}
+
+typedef size_t (*FindKernel)(const uint8_t *data, size_t length, const GNSSSyncSearch::Set &set);
+
+static const FindKernel SSE2_KERNELS[GNSSSyncSearch::MAX_SET_SIZE] = {
+    findSSE2Bytes<1>, findSSE2Bytes<2>, findSSE2Bytes<3>, findSSE2Bytes<4>,
+    findSSE2Bytes<5>, findSSE2Bytes<6>, findSSE2Bytes<7>, findSSE2Bytes<8>};
+
+static const FindKernel AVX2_KERNELS[GNSSSyncSearch::MAX_SET_SIZE] = {
+    findAVX2Bytes<1>, findAVX2Bytes<2>, findAVX2Bytes<3>, findAVX2Bytes<4>,
+    findAVX2Bytes<5>, findAVX2Bytes<6>, findAVX2Bytes<7>, findAVX2Bytes<8>};
+
+size_t GNSSSyncSearch::findSSE2(const uint8_t *data, size_t length, const Set &set)
+{
+    if (set.count == 0)
+        return length;
+    return SSE2_KERNELS[set.count - 1](data, length, set);
+}
+
+size_t GNSSSyncSearch::findAVX2(const uint8_t *data, size_t length, const Set &set)
+{
+    if (SELECTED_ENGINE != AVX2)
+        return findSSE2(data, length, set);
+    if (set.count == 0)
+        return length;
+    return AVX2_KERNELS[set.count - 1](data, length, set);
+}
+
+size_t GNSSSyncSearch::findNEON(const uint8_t *data, size_t length, const Set &set)
+{
+    return findScalar(data, length, set);
+}
+
+#elif defined(GNSS_SYNC_SEARCH_NEON)
+
+bool GNSSSyncSearch::supported(Engine engine)
+{
+    return engine == SCALAR || engine == NEON;
+}
+
+size_t GNSSSyncSearch::findSSE2(const uint8_t *data, size_t length, const Set &set)
+{
+    return findScalar(data, length, set);
+}
+
+size_t GNSSSyncSearch::findAVX2(const uint8_t *data, size_t length, const Set &set)
+{
+    return findScalar(data, length, set);
+}
+
+template <size_t N>
+static size_t findNEONBytes(const uint8_t *data, size_t length, const GNSSSyncSearch::Set &set)
+{
+    uint8x16_t targets[N];
+    for (size_t k = 0; k < N; k++)
+        targets[k] = vdupq_n_u8(set.bytes[k]);
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(data + i);
+        uint8x16_t hits = vceqq_u8(v, targets[0]);
+        for (size_t k = 1; k < N; k++)
+            hits = vorrq_u8(hits, vceqq_u8(v, targets[k]));
+
+        // Narrow to four bits per byte to get a scalar mask
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+        if (mask)
+            return i + (__builtin_ctzll(mask) >> 2);
+    }
+
+    return i + GNSSSyncSearch::findScalar(data + i, length - i, set);
+}
+
+typedef size_t (*FindKernel)(const uint8_t *data, size_t length, const GNSSSyncSearch::Set &set);
+
+static const FindKernel NEON_KERNELS[GNSSSyncSearch::MAX_SET_SIZE] = {
+    findNEONBytes<1>, findNEONBytes<2>, findNEONBytes<3>, findNEONBytes<4>,
+    findNEONBytes<5>, findNEONBytes<6>, findNEONBytes<7>, findNEONBytes<8>};
+
+size_t GNSSSyncSearch::findNEON(const uint8_t *data, size_t length, const Set &set)
+{
+    if (set.count == 0)
+        return length;
+    return NEON_KERNELS[set.count - 1](data, length, set);
+}
+
+#else
+
+bool GNSSSyncSearch::supported(Engine engine)
+{
+    return engine == SCALAR;
+}
+
+size_t GNSSSyncSearch::findSSE2(const uint8_t *data, size_t length, const Set &set)
+{
+    return findScalar(data, length, set);
+}
+
+size_t GNSSSyncSearch::findAVX2(const uint8_t *data, size_t length, const Set &set)
+{
+    return findScalar(data, length, set);
+}
+
+size_t GNSSSyncSearch::findNEON(const uint8_t *data, size_t length, const Set &set)
+{
+    return findScalar(data, length, set);
+}
+
+#endif
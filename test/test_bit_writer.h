@@ -0,0 +1,81 @@
+#ifndef __TEST_BIT_WRITER_H__
+#define __TEST_BIT_WRITER_H__
+
+#include <math.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#include "GNSSCRC24Q.h"
+
+// Appends MSB-first bit fields to an RTCM3 payload, shared by the tests that
+// build RTCM3 messages
+class BitWriter
+{
+public:
+    // Fields wider than 64 bits get zeros ahead of the value
+    void put(uint64_t value, unsigned count)
+    {
+        for (; count > 64; count--, bits_++)
+        {
+            if (bits_ % 8 == 0)
+                payload_.push_back(0);
+        }
+
+        for (unsigned i = 0; i < count; i++, bits_++)
+        {
+            if (bits_ % 8 == 0)
+                payload_.push_back(0);
+            if ((value >> (count - 1 - i)) & 1)
+                payload_.back() |= 0x80 >> (bits_ % 8);
+        }
+    }
+
+    // Quantised two's complement field
+    void putSigned(double value, double scale, unsigned count)
+    {
+        put(static_cast<uint64_t>(llround(value / scale)) & (count == 64 ? ~0ull : (1ull << count) - 1), count);
+    }
+
+    void putUnsigned(double value, double scale, unsigned count)
+    {
+        put(static_cast<uint64_t>(llround(value / scale)), count);
+    }
+
+    // Quantised sign-magnitude field
+    void putSignMagnitude(double value, double scale, unsigned count)
+    {
+        uint64_t magnitude = static_cast<uint64_t>(llround(fabs(value) / scale));
+        put((value < 0 ? 1ull << (count - 1) : 0) | magnitude, count);
+    }
+
+    // Character count, then the characters
+    void putString(const char *text)
+    {
+        put(strlen(text), 8);
+        for (const char *c = text; *c; c++)
+            put(static_cast<uint8_t>(*c), 8);
+    }
+
+    // The payload with the RTCM3 header and CRC
+    std::vector<uint8_t> frame() const
+    {
+        std::vector<uint8_t> frame;
+        frame.reserve(3 + payload_.size() + 3);
+        frame.push_back(0xD3);
+        frame.push_back(uint8_t(payload_.size() >> 8));
+        frame.push_back(uint8_t(payload_.size() & 0xFF));
+        frame.insert(frame.end(), payload_.begin(), payload_.end());
+        uint32_t crc = GNSSCRC24Q::calculate(frame.data(), frame.size());
+        frame.push_back(crc >> 16);
+        frame.push_back(crc >> 8);
+        frame.push_back(crc);
+        return frame;
+    }
+
+private:
+    std::vector<uint8_t> payload_;
+    size_t bits_ = 0;
+};
+
+#endif // __TEST_BIT_WRITER_H__
@@ -0,0 +1,213 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(ARDUINO)
+#include <vector>
+#include "GNSSChunkedParser.h"
+
+struct Frame
+{
+    int type;
+    size_t length;
+    uint32_t hash;
+};
+
+static uint32_t fnv1a(const uint8_t *data, size_t length, uint32_t hash = 2166136261u)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static std::vector<uint8_t> loadCapture(const char *path = "test/test-data/test-data-33816-2193.bin")
+{
+    std::vector<uint8_t> data;
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    fclose(file);
+    return data;
+}
+
+// Zeros after the data fail any candidate still waiting at its end, as the
+// end of the capture does for GNSSChunkedParser
+static std::vector<Frame> parseSequentially(const std::vector<uint8_t> &data)
+{
+    std::vector<Frame> frames;
+    GNSSParser parser;
+    auto sink = [&](const GNSSParser::MessageView &view, bool valid)
+    {
+        if (!valid)
+            return;
+        uint32_t hash = fnv1a(view.first, view.first_length);
+        hash = fnv1a(view.second, view.second_length, hash);
+        frames.push_back({view.type, view.length(), hash});
+    };
+    parser.encode_to(data.data(), data.size(), sink);
+
+    std::vector<uint8_t> flush(GNSSParser::BUFFER_SIZE, 0);
+    parser.encode_to(flush.data(), flush.size(), sink);
+    return frames;
+}
+
+static void assertSameFrames(const std::vector<uint8_t> &data, size_t threads, size_t chunk_size)
+{
+    std::vector<Frame> expected = parseSequentially(data);
+
+    GNSSChunkedParser parser(threads, chunk_size);
+    std::vector<GNSSChunkedParser::Frame> frames = parser.parse(data.data(), data.size());
+
+    TEST_ASSERT_EQUAL(expected.size(), frames.size());
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        TEST_ASSERT_EQUAL(expected[i].type, frames[i].type);
+        TEST_ASSERT_EQUAL(expected[i].length, frames[i].length);
+        TEST_ASSERT_EQUAL_HEX32(expected[i].hash, fnv1a(&data[frames[i].offset], frames[i].length));
+    }
+}
+
+void test_chunked_matches_sequential()
+{
+    std::vector<uint8_t> data = loadCapture();
+
+    // Chunk sizes around the longest RTCM3 frame put seams inside frames
+    const size_t chunk_sizes[] = {1000, 1029, 4096, 65536, 1 << 20};
+    for (size_t chunk_size : chunk_sizes)
+    {
+        assertSameFrames(data, 1, chunk_size);
+        assertSameFrames(data, 4, chunk_size);
+    }
+}
+
+void test_chunked_matches_sequential_with_corruption()
+{
+    std::vector<uint8_t> data = loadCapture();
+
+    // Sprinkle preambles to create false candidates that cross the seams
+    uint32_t state = 12345;
+    for (size_t i = 0; i < data.size(); i += 1 + (state >> 16) % 64)
+    {
+        state = state * 1103515245u + 12345u;
+        if ((state >> 8) % 3 == 0)
+            data[i] = 0xD3;
+        else if ((state >> 8) % 3 == 1)
+            data[i] = '$';
+    }
+
+    assertSameFrames(data, 4, 777);
+    assertSameFrames(data, 3, 8192);
+}
+
+void test_chunked_truncated_candidate_at_end()
+{
+    // An RTCM3 header announcing more bytes than remain fails at the end of
+    // the capture instead of hiding the sentence after it
+    const char *sentence = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+    std::vector<uint8_t> data;
+    data.insert(data.end(), sentence, sentence + strlen(sentence));
+    data.push_back(0xD3);
+    data.push_back(0x00);
+    data.push_back(0xFF);
+    data.insert(data.end(), sentence, sentence + strlen(sentence));
+
+    GNSSChunkedParser parser(2, 16);
+    TEST_ASSERT_EQUAL(2, parser.parse(data.data(), data.size()).size());
+    assertSameFrames(data, 2, 16);
+}
+
+void test_chunked_matches_sequential_on_short_captures()
+{
+    // The 0xD3 at offset 201 of the 5-2 capture announces an 897 byte frame
+    // in 824 bytes
+    std::vector<uint8_t> data = loadCapture("test/test-data/test-data-5-2.bin");
+    GNSSChunkedParser parser(1, 1 << 20);
+    std::vector<GNSSChunkedParser::Frame> frames = parser.parse(data.data(), data.size());
+
+    size_t nmea = 0;
+    size_t rtcm3 = 0;
+    for (const GNSSChunkedParser::Frame &frame : frames)
+    {
+        nmea += frame.type == GNSSParserBase::Message::NMEA;
+        rtcm3 += frame.type == GNSSParserBase::Message::RTCM3;
+    }
+    TEST_ASSERT_EQUAL(5, nmea);
+    TEST_ASSERT_EQUAL(2, rtcm3);
+
+    const size_t chunk_sizes[] = {64, 200, 1 << 20};
+    for (size_t chunk_size : chunk_sizes)
+    {
+        assertSameFrames(data, 1, chunk_size);
+        assertSameFrames(data, 4, chunk_size);
+    }
+
+    data = loadCapture("test/test-data/test-data-56-5.bin");
+    for (size_t chunk_size : chunk_sizes)
+    {
+        assertSameFrames(data, 1, chunk_size);
+        assertSameFrames(data, 4, chunk_size);
+    }
+}
+
+void test_chunked_truncated_candidate_in_last_chunk()
+{
+    // A header announcing 1029 bytes close to the end of the capture, with
+    // frames after it, so the last chunks' own passes and the seams ahead of
+    // them all run into the truncated candidate
+    std::vector<uint8_t> data = loadCapture("test/test-data/test-data-56-5.bin");
+    std::vector<uint8_t> tail(data.begin(), data.begin() + 600);
+    const uint8_t header[] = {0xD3, 0x03, 0xFF};
+    data.insert(data.end(), header, header + sizeof(header));
+    data.insert(data.end(), tail.begin(), tail.end());
+
+    const size_t chunk_sizes[] = {100, 333, 1000};
+    for (size_t chunk_size : chunk_sizes)
+    {
+        assertSameFrames(data, 2, chunk_size);
+        assertSameFrames(data, 4, chunk_size);
+    }
+}
+
+void register_chunked_parser_tests()
+{
+    RUN_TEST(test_chunked_matches_sequential);
+    RUN_TEST(test_chunked_matches_sequential_with_corruption);
+    RUN_TEST(test_chunked_truncated_candidate_at_end);
+    RUN_TEST(test_chunked_matches_sequential_on_short_captures);
+    RUN_TEST(test_chunked_truncated_candidate_in_last_chunk);
+}
+
+#else
+
+void test_chunked_truncated_candidate_in_last_chunk()
+{
+    // A header announcing 1029 bytes close to the end of the capture, with
+    // frames after it, so the last chunks' own passes and the seams ahead of
+    // them all run into the truncated candidate
+    std::vector<uint8_t> data = loadCapture("test/test-data/test-data-56-5.bin");
+    std::vector<uint8_t> tail(data.begin(), data.begin() + 600);
+    const uint8_t header[] = {0xD3, 0x03, 0xFF};
+    data.insert(data.end(), header, header + sizeof(header));
+    data.insert(data.end(), tail.begin(), tail.end());
+
+    const size_t chunk_sizes[] = {100, 333, 1000};
+    for (size_t chunk_size : chunk_sizes)
+    {
+        assertSameFrames(data, 2, chunk_size);
+        assertSameFrames(data, 4, chunk_size);
+    }
+}
+
+void register_chunked_parser_tests()
+{
+}
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef __TEST_CHUNKED_PARSER_H__
+#define __TEST_CHUNKED_PARSER_H__
+
+void register_chunked_parser_tests();
+
+#endif // __TEST_CHUNKED_PARSER_H__
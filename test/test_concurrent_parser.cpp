@@ -0,0 +1,182 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(ARDUINO)
+#include <thread>
+#include <vector>
+#include "GNSSConcurrentParser.h"
+
+#if GNSS_PARSER_EVENTFD
+#include <poll.h>
+#endif
+
+struct Seen
+{
+    int type;
+    size_t length;
+    uint32_t hash;
+};
+
+static uint32_t fnv1a(const uint8_t *data, size_t length, uint32_t hash = 2166136261u)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static std::vector<uint8_t> loadCapture()
+{
+    std::vector<uint8_t> data;
+    FILE *file = fopen("test/test-data/test-data-33816-2193.bin", "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    fclose(file);
+    return data;
+}
+
+// Single-threaded reference with the same buffer configuration
+template <size_t BufferSize, size_t MaxMessages>
+static std::vector<Seen> parseSequentially(const std::vector<uint8_t> &data)
+{
+    std::vector<Seen> seen;
+    BasicGNSSParser<BufferSize, MaxMessages> parser;
+    parser.encode_to(data.data(), data.size(), [&](const GNSSParserBase::MessageView &view, bool valid)
+                     {
+                         if (!valid)
+                             return;
+                         uint32_t hash = fnv1a(view.first, view.first_length);
+                         hash = fnv1a(view.second, view.second_length, hash);
+                         seen.push_back({view.type, view.length(), hash});
+                     });
+    return seen;
+}
+
+template <size_t BufferSize, size_t MaxMessages>
+static void stress(bool blocking)
+{
+    std::vector<uint8_t> data = loadCapture();
+    std::vector<Seen> expected = parseSequentially<BufferSize, MaxMessages>(data);
+
+    BasicGNSSConcurrentParser<BufferSize, MaxMessages> parser;
+    std::vector<Seen> seen;
+    seen.reserve(expected.size());
+    std::atomic<bool> done(false);
+
+    std::thread producer([&]
+                         {
+                             srand(1234);
+                             size_t pos = 0;
+                             while (pos < data.size())
+                             {
+                                 size_t chunk = std::min<size_t>(1 + rand() % 700, data.size() - pos);
+                                 size_t consumed = parser.encode_stream(&data[pos], chunk);
+                                 if (consumed == 0)
+                                     std::this_thread::yield();
+                                 pos += consumed;
+                             }
+                             done = true; });
+
+    while (!done || parser.available())
+    {
+        if (blocking)
+        {
+            parser.wait_for(std::chrono::milliseconds(100));
+        }
+
+        typename GNSSParserBase::MessageView views[8];
+        size_t count = parser.peekMessages(views, 8);
+        for (size_t i = 0; i < count; i++)
+        {
+            uint32_t hash = fnv1a(views[i].first, views[i].first_length);
+            hash = fnv1a(views[i].second, views[i].second_length, hash);
+            seen.push_back({views[i].type, views[i].length(), hash});
+        }
+        parser.release(count);
+    }
+
+    producer.join();
+
+    TEST_ASSERT_EQUAL(0, parser.dropped());
+    TEST_ASSERT_FALSE(parser.available());
+    TEST_ASSERT_EQUAL(expected.size(), seen.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        TEST_ASSERT_EQUAL(expected[i].type, seen[i].type);
+        TEST_ASSERT_EQUAL(expected[i].length, seen[i].length);
+        TEST_ASSERT_EQUAL_HEX32(expected[i].hash, seen[i].hash);
+    }
+}
+
+void test_spsc_stress_polling()
+{
+    stress<4096, 128>(false);
+}
+
+void test_spsc_stress_small_ring()
+{
+    stress<1536, 64>(false);
+}
+
+void test_spsc_stress_blocking()
+{
+    stress<2048, 64>(true);
+}
+
+void test_wait_times_out()
+{
+    GNSSConcurrentParser parser;
+    TEST_ASSERT_FALSE(parser.wait_for(std::chrono::milliseconds(10)));
+}
+
+void test_event_fd_signals_messages()
+{
+#if GNSS_PARSER_EVENTFD
+    const char *sentence = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+    GNSSConcurrentParser parser;
+    int fd = parser.eventFd();
+    TEST_ASSERT_GREATER_OR_EQUAL(0, fd);
+
+    struct pollfd pfd = {fd, POLLIN, 0};
+    TEST_ASSERT_EQUAL(0, poll(&pfd, 1, 0));
+
+    std::thread producer([&]
+                         { parser.encode((const uint8_t *)sentence, strlen(sentence)); });
+
+    TEST_ASSERT_EQUAL(1, poll(&pfd, 1, 10000));
+    uint64_t counter;
+    TEST_ASSERT_EQUAL(sizeof(counter), read(fd, &counter, sizeof(counter)));
+    TEST_ASSERT_TRUE(parser.available());
+    TEST_ASSERT_EQUAL(strlen(sentence), parser.getMessage().length);
+
+    producer.join();
+#else
+    TEST_IGNORE_MESSAGE("eventfd is Linux only");
+#endif
+}
+
+void register_concurrent_parser_tests()
+{
+    RUN_TEST(test_spsc_stress_polling);
+    RUN_TEST(test_spsc_stress_small_ring);
+    RUN_TEST(test_spsc_stress_blocking);
+    RUN_TEST(test_wait_times_out);
+    RUN_TEST(test_event_fd_signals_messages);
+}
+
+#else
+
+void register_concurrent_parser_tests()
+{
+}
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef __TEST_CONCURRENT_PARSER_H__
+#define __TEST_CONCURRENT_PARSER_H__
+
+void register_concurrent_parser_tests();
+
+#endif // __TEST_CONCURRENT_PARSER_H__
@@ -0,0 +1,79 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "GNSSCRC24Q.h"
+
+// Bit-by-bit CRC-24Q used as the reference for all engines
+static uint32_t reference_crc24q(uint32_t crc, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= static_cast<uint32_t>(data[i]) << 16;
+        for (int j = 0; j < 8; j++)
+        {
+            crc <<= 1;
+            if (crc & 0x1000000)
+                crc ^= 0x1864CFB;
+        }
+    }
+    return crc & 0xFFFFFF;
+}
+
+void test_crc_known_frame()
+{
+    // RTCM3 1005 frame from the RTCM 10403 specification examples
+    const uint8_t frame[] = {0xD3, 0x00, 0x13, 0x3E, 0xD7, 0xD3, 0x02, 0x02, 0x98, 0x0E,
+                             0xDE, 0xEF, 0x34, 0xB4, 0xBD, 0x62, 0xAC, 0x09, 0x41, 0x98,
+                             0x6F, 0x33, 0x36, 0x0B, 0x98};
+    const size_t crc_offset = sizeof(frame) - 3;
+    uint32_t expected = (frame[crc_offset] << 16) | (frame[crc_offset + 1] << 8) | frame[crc_offset + 2];
+
+    TEST_ASSERT_EQUAL_HEX32(expected, GNSSCRC24Q::calculate(frame, crc_offset));
+    TEST_ASSERT_EQUAL_HEX32(0, GNSSCRC24Q::calculate(frame, sizeof(frame)));
+}
+
+void test_crc_engines_match_reference()
+{
+    static uint8_t data[4096 + 64];
+    srand(4242);
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = rand() & 0xFF;
+
+    printf("CRC-24Q engine: %d (clmul supported: %d)\n",
+           GNSSCRC24Q::engine(), GNSSCRC24Q::clmulSupported());
+
+    for (int iteration = 0; iteration < 2000; iteration++)
+    {
+        size_t offset = rand() % 64;
+        size_t length = iteration < 300 ? iteration : rand() % 4096;
+        uint32_t initial = rand() & 0xFFFFFF;
+        uint32_t expected = reference_crc24q(initial, data + offset, length);
+
+        TEST_ASSERT_EQUAL_HEX32(expected, GNSSCRC24Q::updateTable(initial, data + offset, length));
+        TEST_ASSERT_EQUAL_HEX32(expected, GNSSCRC24Q::updateSlicingBy8(initial, data + offset, length));
+        TEST_ASSERT_EQUAL_HEX32(expected, GNSSCRC24Q::updateClmul(initial, data + offset, length));
+        TEST_ASSERT_EQUAL_HEX32(expected, GNSSCRC24Q::update(initial, data + offset, length));
+    }
+}
+
+void test_crc_over_two_segments()
+{
+    static uint8_t data[2048];
+    srand(1717);
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = rand() & 0xFF;
+
+    for (size_t split = 0; split <= 1029; split += 7)
+    {
+        uint32_t expected = reference_crc24q(0, data, 1029);
+        uint32_t crc = GNSSCRC24Q::update(0, data, split, data + split, 1029 - split);
+        TEST_ASSERT_EQUAL_HEX32(expected, crc);
+    }
+}
+
+void register_crc_tests()
+{
+    RUN_TEST(test_crc_known_frame);
+    RUN_TEST(test_crc_engines_match_reference);
+    RUN_TEST(test_crc_over_two_segments);
+}
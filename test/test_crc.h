@@ -0,0 +1,6 @@
+#ifndef __TEST_CRC_H__
+#define __TEST_CRC_H__
+
+void register_crc_tests();
+
+#endif // __TEST_CRC_H__
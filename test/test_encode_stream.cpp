@@ -0,0 +1,101 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "GNSSParser.h"
+
+static const char *SENTENCE = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+
+static std::vector<uint8_t> repeatSentence(size_t count)
+{
+    std::vector<uint8_t> stream;
+    for (size_t i = 0; i < count; i++)
+    {
+        stream.insert(stream.end(), SENTENCE, SENTENCE + strlen(SENTENCE));
+    }
+    return stream;
+}
+
+void test_stream_consumes_what_fits()
+{
+    std::vector<uint8_t> stream = repeatSentence(200);
+    GNSSParser parser;
+    size_t messages = 0;
+
+    size_t consumed = parser.encode_stream(stream.data(), stream.size());
+    TEST_ASSERT_GREATER_THAN(0, consumed);
+    TEST_ASSERT_LESS_THAN(stream.size(), consumed);
+    TEST_ASSERT_EQUAL(0, parser.dropped());
+
+    // Queued messages pin the ring until they are consumed
+    TEST_ASSERT_EQUAL(0, parser.encode_stream(stream.data() + consumed, stream.size() - consumed));
+
+    size_t pos = consumed;
+    while (pos < stream.size())
+    {
+        while (parser.available())
+        {
+            TEST_ASSERT_EQUAL(strlen(SENTENCE), parser.getMessage().length);
+            messages++;
+        }
+        pos += parser.encode_stream(stream.data() + pos, stream.size() - pos);
+    }
+
+    while (parser.available())
+    {
+        parser.getMessage();
+        messages++;
+    }
+
+    TEST_ASSERT_EQUAL(200, messages);
+}
+
+void test_stream_skips_noise_larger_than_buffer()
+{
+    std::vector<uint8_t> stream(3 * GNSSParser::BUFFER_SIZE, 'x');
+    std::vector<uint8_t> sentence = repeatSentence(1);
+    stream.insert(stream.end(), sentence.begin(), sentence.end());
+
+    GNSSParser parser;
+    TEST_ASSERT_EQUAL(stream.size(), parser.encode_stream(stream.data(), stream.size()));
+    TEST_ASSERT_TRUE(parser.available());
+}
+
+void test_stream_whole_capture_in_one_call()
+{
+    FILE *file = fopen("test/test-data/test-data-33816-2193.bin", "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    fclose(file);
+
+    GNSSParser parser;
+    size_t nmea = 0;
+    size_t rtcm = 0;
+
+    size_t consumed = parser.encode_stream(data.data(), data.size(), [&](const GNSSParser::MessageView &view)
+                                           {
+                                               if (view.type == GNSSParser::Message::Type::NMEA)
+                                                   nmea++;
+                                               else if (view.type == GNSSParser::Message::Type::RTCM3)
+                                                   rtcm++;
+                                           });
+
+    TEST_ASSERT_EQUAL(data.size(), consumed);
+    TEST_ASSERT_EQUAL(33816, nmea);
+    TEST_ASSERT_EQUAL(2193, rtcm);
+    TEST_ASSERT_FALSE(parser.available());
+}
+
+void register_encode_stream_tests()
+{
+    RUN_TEST(test_stream_consumes_what_fits);
+    RUN_TEST(test_stream_skips_noise_larger_than_buffer);
+    RUN_TEST(test_stream_whole_capture_in_one_call);
+}
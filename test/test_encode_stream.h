@@ -0,0 +1,6 @@
+#ifndef __TEST_ENCODE_STREAM_H__
+#define __TEST_ENCODE_STREAM_H__
+
+void register_encode_stream_tests();
+
+#endif // __TEST_ENCODE_STREAM_H__
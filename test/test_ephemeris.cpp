@@ -0,0 +1,519 @@
+#include <unity.h>
+#include <math.h>
+#include <vector>
+#include "GNSSEphemeris.h"
+#include "test_bit_writer.h"
+
+static const double PI = 3.1415926535898;
+
+// gpsOrbit(17, 45) one hour after toe (and one hour before, with toe at the
+// start of the week, below), and glonassOrbit() 900 s after tb
+// integrated in 1 s steps, from an independent implementation
+static const double GPS_X = 21548393.029876;
+static const double GPS_Y = 10728969.288949;
+static const double GPS_Z = 11364608.492554;
+static const double GPS_CLOCK = 1.234136284960181743e-04;
+static const double GLONASS_X_900 = 13450761.550778;
+static const double GLONASS_Y_900 = -17281148.771622;
+static const double GLONASS_Z_900 = 12427222.764734;
+
+// A plausible GPS orbit; the other systems change a few elements
+static GNSSKeplerEphemeris gpsOrbit(uint8_t prn, uint16_t iode)
+{
+    GNSSKeplerEphemeris eph = {};
+    eph.system = GNSSSystem::GPS;
+    eph.prn = prn;
+    eph.week = 2330 % 1024;
+    eph.iode = iode;
+    eph.iodc = iode;
+    eph.accuracy = 2;
+    eph.toe = 345600;
+    eph.toc = 345600;
+    eph.af0 = 1.2345e-4;
+    eph.af1 = -3.1e-12;
+    eph.tgd = -1.1e-8;
+    eph.sqrt_a = 5153.6543;
+    eph.e = 0.0112345;
+    eph.m0 = 1.2345;
+    eph.delta_n = 4.5e-9;
+    eph.omega0 = -2.0123;
+    eph.omega_dot = -8.0e-9;
+    eph.i0 = 0.9612;
+    eph.idot = 1.0e-10;
+    eph.omega = 0.8123;
+    eph.cuc = -1.5e-6;
+    eph.cus = 8.1e-6;
+    eph.crc = 230.5;
+    eph.crs = -30.25;
+    eph.cic = 1.1e-7;
+    eph.cis = -5.2e-8;
+    return eph;
+}
+
+static std::vector<uint8_t> frame1019(const GNSSKeplerEphemeris &e)
+{
+    const double SC = PI;
+    BitWriter w;
+    w.put(1019, 12);
+    w.put(e.prn, 6);
+    w.put(e.week, 10);
+    w.put(e.accuracy, 4);
+    w.put(0, 2);
+    w.putSigned(e.idot, ldexp(1, -43) * SC, 14);
+    w.put(e.iode, 8);
+    w.putUnsigned(e.toc, 16, 16);
+    w.putSigned(e.af2, ldexp(1, -55), 8);
+    w.putSigned(e.af1, ldexp(1, -43), 16);
+    w.putSigned(e.af0, ldexp(1, -31), 22);
+    w.put(e.iodc, 10);
+    w.putSigned(e.crs, ldexp(1, -5), 16);
+    w.putSigned(e.delta_n, ldexp(1, -43) * SC, 16);
+    w.putSigned(e.m0, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.cuc, ldexp(1, -29), 16);
+    w.putUnsigned(e.e, ldexp(1, -33), 32);
+    w.putSigned(e.cus, ldexp(1, -29), 16);
+    w.putUnsigned(e.sqrt_a, ldexp(1, -19), 32);
+    w.putUnsigned(e.toe, 16, 16);
+    w.putSigned(e.cic, ldexp(1, -29), 16);
+    w.putSigned(e.omega0, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.cis, ldexp(1, -29), 16);
+    w.putSigned(e.i0, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.crc, ldexp(1, -5), 16);
+    w.putSigned(e.omega, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.omega_dot, ldexp(1, -43) * SC, 24);
+    w.putSigned(e.tgd, ldexp(1, -31), 8);
+    w.put(e.health, 6);
+    w.put(0, 2); // L2 P data, fit interval
+    return w.frame();
+}
+
+// 1045 (F/NAV) or 1046 (I/NAV)
+static std::vector<uint8_t> frameGalileo(uint16_t number, const GNSSKeplerEphemeris &e)
+{
+    const double SC = PI;
+    BitWriter w;
+    w.put(number, 12);
+    w.put(e.prn, 6);
+    w.put(e.week, 12);
+    w.put(e.iode, 10);
+    w.put(e.accuracy, 8);
+    w.putSigned(e.idot, ldexp(1, -43) * SC, 14);
+    w.putUnsigned(e.toc, 60, 14);
+    w.putSigned(e.af2, ldexp(1, -59), 6);
+    w.putSigned(e.af1, ldexp(1, -46), 21);
+    w.putSigned(e.af0, ldexp(1, -34), 31);
+    w.putSigned(e.crs, ldexp(1, -5), 16);
+    w.putSigned(e.delta_n, ldexp(1, -43) * SC, 16);
+    w.putSigned(e.m0, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.cuc, ldexp(1, -29), 16);
+    w.putUnsigned(e.e, ldexp(1, -33), 32);
+    w.putSigned(e.cus, ldexp(1, -29), 16);
+    w.putUnsigned(e.sqrt_a, ldexp(1, -19), 32);
+    w.putUnsigned(e.toe, 60, 14);
+    w.putSigned(e.cic, ldexp(1, -29), 16);
+    w.putSigned(e.omega0, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.cis, ldexp(1, -29), 16);
+    w.putSigned(e.i0, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.crc, ldexp(1, -5), 16);
+    w.putSigned(e.omega, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.omega_dot, ldexp(1, -43) * SC, 24);
+    w.putSigned(e.tgd, ldexp(1, -32), 10);
+    if (number == 1045)
+    {
+        w.put(e.health, 3);
+        w.put(0, 7);
+    }
+    else
+    {
+        w.putSigned(e.tgd, ldexp(1, -32), 10);
+        w.put(e.health >> 3, 3);
+        w.put(e.health & 7, 3);
+        w.put(0, 2);
+    }
+    return w.frame();
+}
+
+static std::vector<uint8_t> frame1042(const GNSSKeplerEphemeris &e)
+{
+    const double SC = PI;
+    BitWriter w;
+    w.put(1042, 12);
+    w.put(e.prn, 6);
+    w.put(e.week, 13);
+    w.put(e.accuracy, 4);
+    w.putSigned(e.idot, ldexp(1, -43) * SC, 14);
+    w.put(e.iode, 5);
+    w.putUnsigned(e.toc, 8, 17);
+    w.putSigned(e.af2, ldexp(1, -66), 11);
+    w.putSigned(e.af1, ldexp(1, -50), 22);
+    w.putSigned(e.af0, ldexp(1, -33), 24);
+    w.put(e.iodc, 5);
+    w.putSigned(e.crs, ldexp(1, -6), 18);
+    w.putSigned(e.delta_n, ldexp(1, -43) * SC, 16);
+    w.putSigned(e.m0, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.cuc, ldexp(1, -31), 18);
+    w.putUnsigned(e.e, ldexp(1, -33), 32);
+    w.putSigned(e.cus, ldexp(1, -31), 18);
+    w.putUnsigned(e.sqrt_a, ldexp(1, -19), 32);
+    w.putUnsigned(e.toe, 8, 17);
+    w.putSigned(e.cic, ldexp(1, -31), 18);
+    w.putSigned(e.omega0, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.cis, ldexp(1, -31), 18);
+    w.putSigned(e.i0, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.crc, ldexp(1, -6), 18);
+    w.putSigned(e.omega, ldexp(1, -31) * SC, 32);
+    w.putSigned(e.omega_dot, ldexp(1, -43) * SC, 24);
+    w.putSigned(e.tgd, 1e-10, 10);
+    w.put(0, 10);
+    w.put(e.health, 1);
+    return w.frame();
+}
+
+static std::vector<uint8_t> frame1020(const GNSSGlonassEphemeris &e)
+{
+    BitWriter w;
+    w.put(1020, 12);
+    w.put(e.slot, 6);
+    w.put(e.frequency_channel + 7, 5);
+    w.put(0, 1 + 1 + 2 + 12);
+    w.put(e.health, 1);
+    w.put(0, 1);
+    w.put(e.tb / 900, 7);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        w.putSignMagnitude(e.velocity[axis] / 1e3, ldexp(1, -20), 24);
+        w.putSignMagnitude(e.position[axis] / 1e3, ldexp(1, -11), 27);
+        w.putSignMagnitude(e.acceleration[axis] / 1e3, ldexp(1, -30), 5);
+    }
+    w.put(0, 1);
+    w.putSignMagnitude(e.gamma_n, ldexp(1, -40), 11);
+    w.put(0, 3);
+    w.putSignMagnitude(e.tau_n, ldexp(1, -30), 22);
+    w.put(0, 5 + 5 + 1 + 4 + 11 + 2 + 1 + 11);
+    w.put(0, 32);
+    w.put(0, 5 + 22 + 1 + 7);
+    return w.frame();
+}
+
+static GNSSGlonassEphemeris glonassOrbit()
+{
+    GNSSGlonassEphemeris eph = {};
+    eph.slot = 7;
+    eph.frequency_channel = -5;
+    eph.tb = 41 * 900;
+    eph.position[0] = 12345678.5;
+    eph.position[1] = -18765432.0;
+    eph.position[2] = 11234567.5;
+    eph.velocity[0] = 1234.5;
+    eph.velocity[1] = 1567.25;
+    eph.velocity[2] = 1456.75;
+    eph.acceleration[0] = 2.7939677238464355e-6;
+    eph.acceleration[2] = -1.862645149230957e-6;
+    eph.tau_n = -4.567e-5;
+    eph.gamma_n = 1.8e-12;
+    return eph;
+}
+
+static double radius(const GNSSSatelliteStates &states, size_t i)
+{
+    return sqrt(states.x[i] * states.x[i] + states.y[i] * states.y[i] + states.z[i] * states.z[i]);
+}
+
+void test_ephemeris_decode_gps()
+{
+    GNSSKeplerEphemeris orbit = gpsOrbit(17, 45);
+    std::vector<uint8_t> frame = frame1019(orbit);
+    TEST_ASSERT_EQUAL(3 + 61 + 3, frame.size());
+
+    GNSSKeplerEphemeris eph;
+    TEST_ASSERT_TRUE(GNSSEphemerisCache::decode(frame.data(), frame.size(), eph));
+    TEST_ASSERT_EQUAL(GNSSSystem::GPS, eph.system);
+    TEST_ASSERT_EQUAL(17, eph.prn);
+    TEST_ASSERT_EQUAL(2330 % 1024, eph.week);
+    TEST_ASSERT_EQUAL(45, eph.iode);
+    TEST_ASSERT_EQUAL(45, eph.iodc);
+    TEST_ASSERT_EQUAL(0, eph.health);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 345600, eph.toe);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 345600, eph.toc);
+
+    // Within a quantisation step
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -19), orbit.sqrt_a, eph.sqrt_a);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -33), orbit.e, eph.e);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -31) * PI, orbit.m0, eph.m0);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -31) * PI, orbit.omega0, eph.omega0);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -43) * PI, orbit.omega_dot, eph.omega_dot);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -43) * PI, orbit.idot, eph.idot);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -5), orbit.crc, eph.crc);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -29), orbit.cus, eph.cus);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -31), orbit.af0, eph.af0);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -43), orbit.af1, eph.af1);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -31), orbit.tgd, eph.tgd);
+
+    // Truncated payload, and a message that is no ephemeris
+    TEST_ASSERT_FALSE(GNSSEphemerisCache::decode(frame.data(), frame.size() - 1, eph));
+    frame[3] = 1005 >> 4;
+    frame[4] = (frame[4] & 0x0F) | ((1005 & 0x0F) << 4);
+    TEST_ASSERT_FALSE(GNSSEphemerisCache::decode(frame.data(), frame.size(), eph));
+}
+
+void test_ephemeris_decode_other_systems()
+{
+    GNSSKeplerEphemeris galileo = gpsOrbit(11, 97);
+    galileo.system = GNSSSystem::GALILEO;
+    galileo.toe = galileo.toc = 345600;
+    galileo.health = 0x09; // E5b signal out of service, E1-B data invalid
+
+    GNSSKeplerEphemeris eph;
+    std::vector<uint8_t> inav = frameGalileo(1046, galileo);
+    TEST_ASSERT_EQUAL(3 + 63 + 3, inav.size());
+    TEST_ASSERT_TRUE(GNSSEphemerisCache::decode(inav.data(), inav.size(), eph));
+    TEST_ASSERT_EQUAL(GNSSSystem::GALILEO, eph.system);
+    TEST_ASSERT_EQUAL(11, eph.prn);
+    TEST_ASSERT_EQUAL(97, eph.iode);
+    TEST_ASSERT_EQUAL(0x09, eph.health);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -34), galileo.af0, eph.af0);
+
+    galileo.health = 0x01;
+    std::vector<uint8_t> fnav = frameGalileo(1045, galileo);
+    TEST_ASSERT_EQUAL(3 + 62 + 3, fnav.size());
+    TEST_ASSERT_TRUE(GNSSEphemerisCache::decode(fnav.data(), fnav.size(), eph));
+    TEST_ASSERT_EQUAL(0x01, eph.health);
+
+    GNSSKeplerEphemeris beidou = gpsOrbit(23, 12);
+    beidou.system = GNSSSystem::BEIDOU;
+    beidou.iodc = 3;
+    beidou.tgd = 2.5e-9;
+    std::vector<uint8_t> bds = frame1042(beidou);
+    TEST_ASSERT_EQUAL(3 + 64 + 3, bds.size());
+    TEST_ASSERT_TRUE(GNSSEphemerisCache::decode(bds.data(), bds.size(), eph));
+    TEST_ASSERT_EQUAL(GNSSSystem::BEIDOU, eph.system);
+    TEST_ASSERT_EQUAL(23, eph.prn);
+    TEST_ASSERT_EQUAL(12, eph.iode);
+    TEST_ASSERT_EQUAL(3, eph.iodc);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -31), beidou.cuc, eph.cuc);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-10, beidou.tgd, eph.tgd);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -33), beidou.af0, eph.af0);
+
+    GNSSGlonassEphemeris orbit = glonassOrbit();
+    std::vector<uint8_t> glo = frame1020(orbit);
+    TEST_ASSERT_EQUAL(3 + 45 + 3, glo.size());
+    GNSSGlonassEphemeris state;
+    TEST_ASSERT_TRUE(GNSSEphemerisCache::decode(glo.data(), glo.size(), state));
+    TEST_ASSERT_EQUAL(7, state.slot);
+    TEST_ASSERT_EQUAL(-5, state.frequency_channel);
+    TEST_ASSERT_EQUAL(41 * 900, state.tb);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -11) * 1e3, orbit.position[axis], state.position[axis]);
+        TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -20) * 1e3, orbit.velocity[axis], state.velocity[axis]);
+        TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -30) * 1e3, orbit.acceleration[axis], state.acceleration[axis]);
+    }
+    TEST_ASSERT_TRUE(state.position[1] < 0);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -30), orbit.tau_n, state.tau_n);
+    TEST_ASSERT_DOUBLE_WITHIN(ldexp(1, -40), orbit.gamma_n, state.gamma_n);
+}
+
+void test_ephemeris_cache_updates()
+{
+    static GNSSEphemerisCache cache;
+    cache.clear();
+
+    std::vector<uint8_t> first = frame1019(gpsOrbit(5, 10));
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(first.data(), first.size()));
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UNCHANGED, cache.add(first.data(), first.size()));
+    TEST_ASSERT_EQUAL(1, cache.size());
+    TEST_ASSERT_EQUAL(10, cache.find(GNSSSystem::GPS, 5)->iode);
+    TEST_ASSERT_NULL(cache.find(GNSSSystem::GPS, 6));
+    TEST_ASSERT_NULL(cache.find(GNSSSystem::GALILEO, 5));
+
+    GNSSKeplerEphemeris next = gpsOrbit(5, 11);
+    next.toe = next.toc = 352800;
+    std::vector<uint8_t> second = frame1019(next);
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(second.data(), second.size()));
+    TEST_ASSERT_EQUAL(1, cache.size());
+    TEST_ASSERT_EQUAL(11, cache.find(GNSSSystem::GPS, 5)->iode);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 352800, cache.find(GNSSSystem::GPS, 5)->toe);
+
+    // F/NAV and I/NAV of one IODnav are the same ephemeris
+    GNSSKeplerEphemeris galileo = gpsOrbit(3, 50);
+    galileo.system = GNSSSystem::GALILEO;
+    std::vector<uint8_t> fnav = frameGalileo(1045, galileo);
+    std::vector<uint8_t> inav = frameGalileo(1046, galileo);
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(fnav.data(), fnav.size()));
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UNCHANGED, cache.add(inav.data(), inav.size()));
+
+    std::vector<uint8_t> glonass = frame1020(glonassOrbit());
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(glonass.data(), glonass.size()));
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UNCHANGED, cache.add(glonass.data(), glonass.size()));
+    TEST_ASSERT_EQUAL(-5, cache.findGlonass(7)->frequency_channel);
+    TEST_ASSERT_NULL(cache.findGlonass(8));
+    TEST_ASSERT_EQUAL(3, cache.size());
+
+    // Other messages, through the parser with the frame wrapped around the
+    // ring buffer end
+    uint8_t station[3 + 19 + 3] = {0xD3, 0x00, 19, 1005 >> 4, (1005 & 0x0F) << 4};
+    uint32_t crc = GNSSCRC24Q::calculate(station, 3 + 19);
+    station[22] = crc >> 16;
+    station[23] = crc >> 8;
+    station[24] = crc;
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::IGNORED, cache.add(station, sizeof(station)));
+
+    BasicGNSSParser<256, 8> parser;
+    std::vector<uint8_t> padding(200, 0);
+    parser.encode(padding.data(), padding.size());
+    GNSSKeplerEphemeris other = gpsOrbit(9, 1);
+    std::vector<uint8_t> wrapped = frame1019(other);
+    TEST_ASSERT_TRUE(parser.encode(wrapped.data(), wrapped.size()));
+    GNSSParserBase::MessageView view = parser.peekMessage();
+    TEST_ASSERT_EQUAL(GNSSParserBase::Message::Type::RTCM3, view.type);
+    TEST_ASSERT_NOT_NULL(view.second);
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(view));
+    parser.release();
+    TEST_ASSERT_EQUAL(4, cache.size());
+
+    cache.clear();
+    TEST_ASSERT_EQUAL(0, cache.size());
+    TEST_ASSERT_NULL(cache.find(GNSSSystem::GPS, 5));
+}
+
+void test_ephemeris_gps_position()
+{
+    static GNSSEphemerisCache cache;
+    cache.clear();
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(gpsOrbit(17, 45)));
+
+    // IS-GPS-200 20.3.3.4.3 on the unquantised elements
+    GNSSSatelliteStates states;
+    TEST_ASSERT_EQUAL(1, cache.compute(345600 + 3600, states));
+    TEST_ASSERT_EQUAL(GNSSSystem::GPS, states.system[0]);
+    TEST_ASSERT_EQUAL(17, states.prn[0]);
+    TEST_ASSERT_TRUE(states.healthy[0]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-3, GPS_X, states.x[0]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-3, GPS_Y, states.y[0]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-3, GPS_Z, states.z[0]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-15, GPS_CLOCK, states.clock[0]);
+
+    // An hour before a toe at the start of the week, from the end of the
+    // previous week
+    GNSSKeplerEphemeris next_week = gpsOrbit(17, 46);
+    next_week.toe = next_week.toc = 0;
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(next_week));
+    cache.compute(604800 - 3600, states);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-3, 14667464.776498, states.x[0]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-3, -3570963.141319, states.y[0]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-3, 21578778.895533, states.z[0]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-15, 1.234442607306595891e-04, states.clock[0]);
+}
+
+void test_ephemeris_all_systems()
+{
+    static GNSSEphemerisCache cache;
+    cache.clear();
+
+    GNSSKeplerEphemeris gps = gpsOrbit(1, 1);
+    GNSSKeplerEphemeris qzss = gpsOrbit(193, 1);
+    qzss.system = GNSSSystem::QZSS;
+    qzss.sqrt_a = 6493.3;
+    qzss.e = 0.075;
+    GNSSKeplerEphemeris galileo = gpsOrbit(36, 1);
+    galileo.system = GNSSSystem::GALILEO;
+    galileo.sqrt_a = 5440.6;
+    galileo.e = 0.0003;
+    GNSSKeplerEphemeris beidou = gpsOrbit(30, 1);
+    beidou.system = GNSSSystem::BEIDOU;
+    beidou.sqrt_a = 5282.6;
+    beidou.toe = beidou.toc = 345600 - 14;
+    // A geostationary orbit as BeiDou broadcasts it: inclined by the 5
+    // degrees the GEO rotation takes out again, node opposite the tilt axis
+    GNSSKeplerEphemeris geo = {};
+    geo.system = GNSSSystem::BEIDOU;
+    geo.prn = 60;
+    geo.iode = 1;
+    geo.toe = geo.toc = beidou.toe;
+    geo.sqrt_a = sqrt(cbrt(3.986004418e14 / (7.292115e-5 * 7.292115e-5)));
+    geo.e = 0.0001;
+    geo.i0 = 5 * PI / 180;
+    geo.omega0 = PI + 7.292115e-5 * geo.toe;
+
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(gps));
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(qzss));
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(galileo));
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(beidou));
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(geo));
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(glonassOrbit()));
+    GNSSKeplerEphemeris unknown = gpsOrbit(40, 1);
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::IGNORED, cache.add(unknown));
+
+    // 18 s past the GLONASS reference time, the start of which is
+    // tb - 3 h + leap seconds on the GPS clock
+    double time = 345600 + 41 * 900 - 3 * 3600 + 18;
+    GNSSSatelliteStates states;
+    TEST_ASSERT_EQUAL(6, cache.compute(time, states));
+
+    // The Kepler radius a(1 - e cos E) plus at most the harmonic corrections
+    const double bounds[][2] = {{26.2e6, 26.9e6}, {37.6e6, 46.8e6}, {29.59e6, 29.61e6},
+                                {27.56e6, 28.25e6}, {42.14e6, 42.19e6}};
+    for (size_t i = 0; i < 5; i++)
+    {
+        TEST_ASSERT_TRUE(radius(states, i) > bounds[i][0]);
+        TEST_ASSERT_TRUE(radius(states, i) < bounds[i][1]);
+    }
+
+    // The GEO hangs over the equator and stays put
+    TEST_ASSERT_EQUAL(60, states.prn[4]);
+    TEST_ASSERT_TRUE(fabs(states.z[4]) < 100);
+    double geo_x = states.x[4], geo_y = states.y[4];
+
+    // GLONASS at its reference time is the broadcast state vector
+    GNSSGlonassEphemeris glonass = glonassOrbit();
+    TEST_ASSERT_EQUAL(GNSSSystem::GLONASS, states.system[5]);
+    TEST_ASSERT_EQUAL(7, states.prn[5]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, glonass.position[0], states.x[5]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, glonass.position[2], states.z[5]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-15, -glonass.tau_n, states.clock[5]);
+
+    // Fifteen minutes on, 60 s steps stay within centimetres of 1 s steps
+    TEST_ASSERT_EQUAL(6, cache.compute(time + 900, states));
+    TEST_ASSERT_DOUBLE_WITHIN(10e3, geo_x, states.x[4]);
+    TEST_ASSERT_DOUBLE_WITHIN(10e3, geo_y, states.y[4]);
+    TEST_ASSERT_DOUBLE_WITHIN(0.05, GLONASS_X_900, states.x[5]);
+    TEST_ASSERT_DOUBLE_WITHIN(0.05, GLONASS_Y_900, states.y[5]);
+    TEST_ASSERT_DOUBLE_WITHIN(0.05, GLONASS_Z_900, states.z[5]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-15, -glonass.tau_n + glonass.gamma_n * 900, states.clock[5]);
+}
+
+void test_ephemeris_glonass_late_reference_time()
+{
+    // 23:45 Moscow time, past the 65535 s a 16-bit tb held
+    GNSSGlonassEphemeris orbit = glonassOrbit();
+    orbit.tb = 95 * 900;
+    std::vector<uint8_t> frame = frame1020(orbit);
+    GNSSGlonassEphemeris state;
+    TEST_ASSERT_TRUE(GNSSEphemerisCache::decode(frame.data(), frame.size(), state));
+    TEST_ASSERT_EQUAL(95 * 900, state.tb);
+
+    static GNSSEphemerisCache cache;
+    cache.clear();
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UPDATED, cache.add(state));
+    TEST_ASSERT_EQUAL(GNSSEphemerisCache::UNCHANGED, cache.add(state));
+
+    // At its reference time the position is the broadcast state vector
+    double time = 345600 + 95 * 900 - 3 * 3600 + 18;
+    GNSSSatelliteStates states;
+    TEST_ASSERT_EQUAL(1, cache.compute(time, states));
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const double *position[] = {states.x, states.y, states.z};
+        TEST_ASSERT_DOUBLE_WITHIN(1e-6, state.position[axis], position[axis][0]);
+    }
+}
+
+void register_ephemeris_tests()
+{
+    RUN_TEST(test_ephemeris_decode_gps);
+    RUN_TEST(test_ephemeris_decode_other_systems);
+    RUN_TEST(test_ephemeris_cache_updates);
+    RUN_TEST(test_ephemeris_glonass_late_reference_time);
+    RUN_TEST(test_ephemeris_gps_position);
+    RUN_TEST(test_ephemeris_all_systems);
+}
@@ -0,0 +1,6 @@
+#ifndef __TEST_EPHEMERIS_H__
+#define __TEST_EPHEMERIS_H__
+
+void register_ephemeris_tests();
+
+#endif // __TEST_EPHEMERIS_H__
@@ -0,0 +1,176 @@
+#include <unity.h>
+#include <stdio.h>
+#include <vector>
+#include "GNSSEpochAssembler.h"
+
+#if !defined(ARDUINO)
+#include <chrono>
+#include <thread>
+#endif
+
+struct EpochSummary
+{
+    uint32_t time;
+    size_t count;
+    GNSSEpoch::Completion completion;
+};
+
+static std::vector<std::vector<uint8_t>> captureFrames(const char *path)
+{
+    std::vector<std::vector<uint8_t>> frames;
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    GNSSParser parser;
+    uint8_t chunk[256];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        parser.encode_to(chunk, read, [&](const GNSSParser::MessageView &view, bool valid)
+                         {
+                             if (valid && view.type == GNSSParser::Message::Type::RTCM3)
+                             {
+                                 frames.push_back(std::vector<uint8_t>(view.length()));
+                                 view.copyTo(frames.back().data());
+                             }
+                         });
+    }
+    fclose(file);
+    return frames;
+}
+
+static GNSSParserBase::MessageView viewOf(const std::vector<uint8_t> &frame)
+{
+    return {GNSSParserBase::Message::Type::RTCM3, frame.data(), frame.size(), nullptr, 0};
+}
+
+void test_epochs_of_capture()
+{
+    GNSSEpochAssembler assembler;
+    std::vector<EpochSummary> epochs;
+    auto collect = [&](const GNSSEpoch &epoch)
+    { epochs.push_back({epoch.time, epoch.count, epoch.completion}); };
+
+    size_t ignored = 0;
+    for (const std::vector<uint8_t> &frame : captureFrames("test/test-data/test-data-656-43.bin"))
+    {
+        if (!assembler.add(viewOf(frame), collect))
+            ignored++;
+    }
+    assembler.flush(collect);
+
+    // 1006 and 1033 twice; the capture also lost some final messages
+    TEST_ASSERT_EQUAL(4, ignored);
+    TEST_ASSERT_EQUAL(21, epochs.size());
+
+    // Galileo MSM4 then BeiDou MSM4, whose BDT epoch is 14 s earlier
+    TEST_ASSERT_EQUAL(223634000, epochs[0].time);
+    TEST_ASSERT_EQUAL(2, epochs[0].count);
+    TEST_ASSERT_EQUAL(GNSSEpoch::FINAL_MESSAGE, epochs[0].completion);
+
+    // GPS and GLONASS (Moscow time of day) in one epoch, last message lost
+    TEST_ASSERT_EQUAL(223637000, epochs[3].time);
+    TEST_ASSERT_EQUAL(2, epochs[3].count);
+    TEST_ASSERT_EQUAL(GNSSEpoch::NEW_EPOCH, epochs[3].completion);
+
+    // GPS, GLONASS, Galileo
+    TEST_ASSERT_EQUAL(223639000, epochs[5].time);
+    TEST_ASSERT_EQUAL(3, epochs[5].count);
+
+    size_t completions[4] = {0, 0, 0, 0};
+    size_t messages = 0;
+    for (const EpochSummary &epoch : epochs)
+    {
+        completions[epoch.completion]++;
+        messages += epoch.count;
+    }
+    TEST_ASSERT_EQUAL(8, completions[GNSSEpoch::FINAL_MESSAGE]);
+    TEST_ASSERT_EQUAL(12, completions[GNSSEpoch::NEW_EPOCH]);
+    TEST_ASSERT_EQUAL(1, completions[GNSSEpoch::FLUSHED]);
+    TEST_ASSERT_EQUAL(39, messages);
+
+    TEST_ASSERT_FALSE(assembler.pending());
+    TEST_ASSERT_EQUAL(21, assembler.latency().epochs);
+    TEST_ASSERT_TRUE(assembler.latency().max_ns >= assembler.latency().last_ns);
+}
+
+void test_epoch_contents()
+{
+    std::vector<std::vector<uint8_t>> frames = captureFrames("test/test-data/test-data-656-43.bin");
+    GNSSEpochAssembler assembler;
+    size_t seen = 0;
+
+    uint64_t first = GNSSEpochAssembler::now();
+    assembler.add(viewOf(frames[0]), first, [&](const GNSSEpoch &) { seen++; });
+    TEST_ASSERT_TRUE(assembler.pending());
+    TEST_ASSERT_EQUAL(0, seen);
+
+    uint64_t last = GNSSEpochAssembler::now();
+    assembler.add(viewOf(frames[1]), last, [&](const GNSSEpoch &epoch)
+                  {
+                      seen++;
+                      TEST_ASSERT_EQUAL(2, epoch.count);
+                      TEST_ASSERT_EQUAL(first, epoch.first_received_ns);
+                      TEST_ASSERT_EQUAL(last, epoch.last_received_ns);
+                      TEST_ASSERT_EQUAL(1094, epoch.messages[0].message_number);
+                      TEST_ASSERT_EQUAL(19, epoch.messages[0].cell_count);
+                      TEST_ASSERT_EQUAL(1124, epoch.messages[1].message_number);
+                      TEST_ASSERT_EQUAL(25, epoch.messages[1].cell_count);
+                  });
+    TEST_ASSERT_EQUAL(1, seen);
+    TEST_ASSERT_FALSE(assembler.pending());
+
+    // Handed over within the call that completed it
+    TEST_ASSERT_TRUE(assembler.latency().last_ns < 1000000000ull);
+}
+
+#if !defined(ARDUINO)
+void test_epoch_timeout()
+{
+    std::vector<std::vector<uint8_t>> frames = captureFrames("test/test-data/test-data-656-43.bin");
+    GNSSEpochAssembler assembler(10);
+    std::vector<EpochSummary> epochs;
+    auto collect = [&](const GNSSEpoch &epoch)
+    { epochs.push_back({epoch.time, epoch.count, epoch.completion}); };
+
+    // Galileo MSM4 with more to come, which never does
+    assembler.add(viewOf(frames[0]), collect);
+    assembler.poll(collect);
+    TEST_ASSERT_EQUAL(0, epochs.size());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    assembler.poll(collect);
+    TEST_ASSERT_EQUAL(1, epochs.size());
+    TEST_ASSERT_EQUAL(GNSSEpoch::TIMEOUT, epochs[0].completion);
+    TEST_ASSERT_EQUAL(1, epochs[0].count);
+    TEST_ASSERT_TRUE(assembler.latency().last_ns >= 10000000ull);
+
+    assembler.poll(collect);
+    TEST_ASSERT_EQUAL(1, epochs.size());
+}
+#endif
+
+void test_epoch_gps_time()
+{
+    GNSSEpochAssembler assembler(200, 18);
+
+    TEST_ASSERT_EQUAL(345600000, assembler.gpsTime(GNSSSystem::GPS, 345600000));
+    TEST_ASSERT_EQUAL(345614000, assembler.gpsTime(GNSSSystem::BEIDOU, 345600000));
+
+    // Sunday 01:00 Moscow is Saturday 22:00 UTC, the end of the GPS week
+    uint32_t glonass = (0u << 27) | 3600000;
+    TEST_ASSERT_EQUAL(7 * 86400000u - 2 * 3600000 + 18000, assembler.gpsTime(GNSSSystem::GLONASS, glonass));
+
+    // BeiDou near the end of the week wraps around
+    TEST_ASSERT_EQUAL(4000, assembler.gpsTime(GNSSSystem::BEIDOU, 7 * 86400000u - 10000));
+}
+
+void register_epoch_assembler_tests()
+{
+    RUN_TEST(test_epochs_of_capture);
+    RUN_TEST(test_epoch_contents);
+#if !defined(ARDUINO)
+    RUN_TEST(test_epoch_timeout);
+#endif
+    RUN_TEST(test_epoch_gps_time);
+}
@@ -0,0 +1,6 @@
+#ifndef __TEST_EPOCH_ASSEMBLER_H__
+#define __TEST_EPOCH_ASSEMBLER_H__
+
+void register_epoch_assembler_tests();
+
+#endif // __TEST_EPOCH_ASSEMBLER_H__
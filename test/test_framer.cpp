@@ -0,0 +1,236 @@
+#include <unity.h>
+#include <string.h>
+#include <vector>
+#include "GNSSParser.h"
+
+static const char *SENTENCE = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+
+static const GNSSParserBase::Message::Type SBF_TYPE = static_cast<GNSSParserBase::Message::Type>(GNSSParserBase::Message::USER);
+
+static uint16_t crc16(uint16_t crc, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+// Septentrio SBF, as a framer from outside the library would add it: "$@",
+// CRC-16 of the rest of the block, block ID, then a length covering the whole
+// block. It shares '$' with NMEA and keeps its check in the header.
+struct SBFFramer : GNSSLengthFramer<SBFFramer>
+{
+    static constexpr uint32_t PROTOCOL = GNSSProtocol::USER;
+    static constexpr Message::Type TYPE = static_cast<Message::Type>(Message::USER);
+    static constexpr size_t MAX_LENGTH = 65535;
+    static constexpr uint32_t SYNC = ('$' << 8) | '@';
+    static constexpr size_t SYNC_LENGTH = 2;
+    static constexpr size_t HEAD_LENGTH = 8;
+    static constexpr size_t CHECK_BEGIN = 4;
+    static constexpr size_t CHECK_LENGTH = 0;
+
+    static size_t frameLength(const uint8_t *head)
+    {
+        size_t length = head[6] | (head[7] << 8);
+        return length % 4 == 0 ? length : 0;
+    }
+
+    static uint32_t check(uint32_t sum, const uint8_t *data, size_t length)
+    {
+        return crc16(static_cast<uint16_t>(sum), data, length);
+    }
+
+    static bool valid(const ScanState &state)
+    {
+        return state.sum == static_cast<uint32_t>(state.head[2] | (state.head[3] << 8));
+    }
+};
+
+typedef GNSSFramers<SBFFramer, GNSSNMEAFramer, GNSSRTCM3Framer, GNSSUBXFramer> SBFFramers;
+typedef BasicGNSSParser<4096, 128, GNSSProtocol::ALL, GNSSMessageQueue, SBFFramers> SBFParser;
+
+// Payload bytes stay clear of every preamble
+static std::vector<uint8_t> sbfBlock(uint16_t id, size_t payload_length)
+{
+    size_t length = 8 + payload_length;
+    std::vector<uint8_t> block = {'$', '@', 0, 0, uint8_t(id & 0xFF), uint8_t(id >> 8), uint8_t(length & 0xFF), uint8_t(length >> 8)};
+    for (size_t i = 0; i < payload_length; i++)
+        block.push_back(uint8_t(0x40 + (i * 7 + id) % 32));
+    uint16_t crc = crc16(0, block.data() + 4, block.size() - 4);
+    block[2] = crc & 0xFF;
+    block[3] = crc >> 8;
+    return block;
+}
+
+static std::vector<uint8_t> rtcm3Frame(size_t payload_length)
+{
+    std::vector<uint8_t> frame = {0xD3, uint8_t(payload_length >> 8), uint8_t(payload_length & 0xFF)};
+    for (size_t i = 0; i < payload_length; i++)
+        frame.push_back(uint8_t(0x40 + i % 32));
+    uint32_t crc = GNSSCRC24Q::calculate(frame.data(), frame.size());
+    frame.push_back(crc >> 16);
+    frame.push_back(crc >> 8);
+    frame.push_back(crc);
+    return frame;
+}
+
+static void append(std::vector<uint8_t> &stream, const std::vector<uint8_t> &frame)
+{
+    stream.insert(stream.end(), frame.begin(), frame.end());
+}
+
+static void append(std::vector<uint8_t> &stream, const char *sentence)
+{
+    stream.insert(stream.end(), sentence, sentence + strlen(sentence));
+}
+
+static std::vector<uint8_t> sbfStream()
+{
+    std::vector<uint8_t> stream;
+    append(stream, SENTENCE);
+    append(stream, sbfBlock(4007, 88)); // PVTGeodetic
+    append(stream, rtcm3Frame(40));
+    const char noise[] = "@@ \x01\x02 @";
+    stream.insert(stream.end(), noise, noise + sizeof(noise) - 1);
+    append(stream, sbfBlock(4027, 400)); // MeasEpoch
+    append(stream, SENTENCE);
+    return stream;
+}
+
+namespace
+{
+    // test_chunked_parser.cpp has a Frame of its own
+    struct Frame
+    {
+        GNSSParserBase::Message::Type type;
+        size_t length;
+        bool valid;
+    };
+}
+
+template <class Parser>
+static std::vector<Frame> parse(const std::vector<uint8_t> &stream, size_t chunk_size)
+{
+    static Parser parser;
+    parser.clear();
+    std::vector<Frame> frames;
+    for (size_t pos = 0; pos < stream.size(); pos += chunk_size)
+    {
+        size_t length = std::min(chunk_size, stream.size() - pos);
+        parser.encode_to(stream.data() + pos, length, [&](const GNSSParserBase::MessageView &view, bool valid)
+                         { frames.push_back({view.type, view.length(), valid}); });
+    }
+    return frames;
+}
+
+void test_default_first_byte_table()
+{
+    size_t starts = 0;
+    for (int c = 0; c < 256; c++)
+        starts += GNSSDefaultFramers::FIRST_BYTE[c] != 0;
+
+    TEST_ASSERT_EQUAL(4, starts);
+    TEST_ASSERT_EQUAL(1, GNSSDefaultFramers::FIRST_BYTE['$']);
+    TEST_ASSERT_EQUAL(1, GNSSDefaultFramers::FIRST_BYTE['!']);
+    TEST_ASSERT_EQUAL(2, GNSSDefaultFramers::FIRST_BYTE[0xD3]);
+    TEST_ASSERT_EQUAL(4, GNSSDefaultFramers::FIRST_BYTE[0xB5]);
+    TEST_ASSERT_EQUAL(0, GNSSDefaultFramers::FIRST_BYTE[0x62]);
+
+    TEST_ASSERT_EQUAL(4, GNSSSyncSearch::FRAME_STARTS.count);
+    for (int c = 0; c < 256; c++)
+        TEST_ASSERT_EQUAL(GNSSDefaultFramers::FIRST_BYTE[c] != 0, GNSSSyncSearch::isSyncByte(c));
+}
+
+void test_protocols_select_framers()
+{
+    typedef BasicGNSSParser<1024, 16, GNSSProtocol::NMEA> NMEAParser;
+    typedef BasicGNSSParser<4096, 16, GNSSProtocol::RTCM3 | GNSSProtocol::UBX> BinaryParser;
+
+    TEST_ASSERT_EQUAL(1, NMEAParser::ENABLED_FRAMERS);
+    TEST_ASSERT_EQUAL(2, NMEAParser::FRAME_STARTS.count);
+    TEST_ASSERT_EQUAL(GNSSParserBase::MAX_NMEA_LENGTH, NMEAParser::MAX_MESSAGE_LENGTH);
+
+    TEST_ASSERT_EQUAL(6, BinaryParser::ENABLED_FRAMERS);
+    TEST_ASSERT_EQUAL(2, BinaryParser::FRAME_STARTS.count);
+    TEST_ASSERT_EQUAL(4096, BinaryParser::MAX_MESSAGE_LENGTH);
+
+    TEST_ASSERT_EQUAL(3, SBFFramers::FIRST_BYTE['$']);
+    TEST_ASSERT_EQUAL(15, SBFParser::ENABLED_FRAMERS);
+    TEST_ASSERT_EQUAL(4, SBFParser::FRAME_STARTS.count);
+}
+
+void test_user_framer_in_mixed_stream()
+{
+    std::vector<uint8_t> stream = sbfStream();
+    const GNSSParserBase::Message::Type types[] = {GNSSParserBase::Message::NMEA, SBF_TYPE, GNSSParserBase::Message::RTCM3,
+                                                   SBF_TYPE, GNSSParserBase::Message::NMEA};
+    const size_t lengths[] = {67, 96, 46, 408, 67};
+
+    const size_t chunk_sizes[] = {1, 7, 256, 4096};
+    for (size_t chunk_size : chunk_sizes)
+    {
+        std::vector<Frame> frames = parse<SBFParser>(stream, chunk_size);
+
+        TEST_ASSERT_EQUAL(5, frames.size());
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            TEST_ASSERT_TRUE(frames[i].valid);
+            TEST_ASSERT_EQUAL(types[i], frames[i].type);
+            TEST_ASSERT_EQUAL(lengths[i], frames[i].length);
+        }
+    }
+}
+
+void test_user_framer_check_failure()
+{
+    std::vector<uint8_t> stream = sbfStream();
+    stream[67 + 20] ^= 0x01;
+
+    SBFParser parser;
+    size_t invalid = 0;
+    std::vector<GNSSParserBase::Message::Type> types;
+    parser.encode_to(stream.data(), stream.size(), [&](const GNSSParserBase::MessageView &view, bool valid)
+                     {
+                         if (!valid)
+                         {
+                             TEST_ASSERT_EQUAL(SBF_TYPE, view.type);
+                             invalid++;
+                             return;
+                         }
+                         types.push_back(view.type);
+                     });
+
+    TEST_ASSERT_EQUAL(1, invalid);
+    TEST_ASSERT_EQUAL(4, types.size());
+    TEST_ASSERT_EQUAL(SBF_TYPE, types[2]);
+
+#if GNSS_PARSER_STATS
+    GNSSParserBase::Stats stats = parser.stats();
+    TEST_ASSERT_EQUAL(1, stats.other_failures);
+    TEST_ASSERT_EQUAL(1, stats.other_frames);
+    TEST_ASSERT_EQUAL(2, stats.nmea_frames);
+    TEST_ASSERT_EQUAL(0, stats.checksum_failures);
+#endif
+}
+
+void test_user_framer_left_out_of_protocols()
+{
+    typedef BasicGNSSParser<4096, 128, GNSSProtocol::NMEA | GNSSProtocol::RTCM3, GNSSMessageQueue, SBFFramers> Parser;
+    std::vector<Frame> frames = parse<Parser>(sbfStream(), 256);
+
+    TEST_ASSERT_EQUAL(3, frames.size());
+    for (size_t i = 0; i < frames.size(); i++)
+        TEST_ASSERT_TRUE(frames[i].valid && frames[i].type != SBF_TYPE);
+}
+
+void register_framer_tests()
+{
+    RUN_TEST(test_default_first_byte_table);
+    RUN_TEST(test_protocols_select_framers);
+    RUN_TEST(test_user_framer_in_mixed_stream);
+    RUN_TEST(test_user_framer_check_failure);
+    RUN_TEST(test_user_framer_left_out_of_protocols);
+}
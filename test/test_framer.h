@@ -0,0 +1,6 @@
+#ifndef __TEST_FRAMER_H__
+#define __TEST_FRAMER_H__
+
+void register_framer_tests();
+
+#endif // __TEST_FRAMER_H__
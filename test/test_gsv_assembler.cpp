@@ -0,0 +1,216 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "GNSSGSVAssembler.h"
+
+#if !defined(ARDUINO)
+#include <thread>
+#endif
+
+extern const char *BULK_NMEA_MESSAGES;
+
+static GNSSGSVAssembler assembler;
+
+static GNSSGSVAssembler::Update add(const char *sentence)
+{
+    GNSSNMEAFields fields(sentence, strlen(sentence));
+    return assembler.add(fields);
+}
+
+void test_gsv_bulk_messages()
+{
+    assembler.clear();
+
+    GNSSParser parser;
+    size_t published = 0, accepted = 0, ignored = 0;
+    parser.encode_to(reinterpret_cast<const uint8_t *>(BULK_NMEA_MESSAGES), strlen(BULK_NMEA_MESSAGES),
+                     [&](const GNSSParser::MessageView &view, bool valid)
+                     {
+                         TEST_ASSERT_TRUE(valid);
+                         switch (assembler.add(view))
+                         {
+                         case GNSSGSVAssembler::PUBLISHED:
+                             published++;
+                             break;
+                         case GNSSGSVAssembler::ACCEPTED:
+                             accepted++;
+                             break;
+                         default:
+                             ignored++;
+                         }
+                     });
+
+    // 13 groups (GPS, GLONASS, BeiDou and Galileo, several signals each), the
+    // GGA, GSA and RMC sentences ignored
+    TEST_ASSERT_EQUAL(13, published);
+    TEST_ASSERT_EQUAL(9, accepted);
+    TEST_ASSERT_EQUAL(7, ignored);
+    TEST_ASSERT_EQUAL(0, assembler.incomplete());
+    TEST_ASSERT_TRUE(assembler.fresh());
+
+    const GNSSSatellitesInView &view = assembler.snapshot();
+    TEST_ASSERT_FALSE(assembler.fresh());
+    TEST_ASSERT_EQUAL(13, view.sequence);
+    TEST_ASSERT_EQUAL(6 + 6 + 3 + 4 + 1 + 5 + 5 + 5 + 3 + 5 + 7 + 7 + 5, view.count);
+
+    // $GPGSV,2,1,06,24,18,168,40,...,1
+    const GNSSSatelliteInView &first = view.satellites[0];
+    TEST_ASSERT_EQUAL(GNSSSystem::GPS, first.system);
+    TEST_ASSERT_EQUAL(1, first.signal_id);
+    TEST_ASSERT_EQUAL(24, first.id);
+    TEST_ASSERT_EQUAL(18, first.elevation);
+    TEST_ASSERT_EQUAL(168, first.azimuth);
+    TEST_ASSERT_EQUAL(40, first.snr);
+
+    // Last of all: $GAGSV,2,2,05,13,47,142,38,7
+    const GNSSSatelliteInView &last = view.satellites[view.count - 1];
+    TEST_ASSERT_EQUAL(GNSSSystem::GALILEO, last.system);
+    TEST_ASSERT_EQUAL(7, last.signal_id);
+    TEST_ASSERT_EQUAL(13, last.id);
+    TEST_ASSERT_EQUAL(38, last.snr);
+
+    // Groups contiguous, in the order first heard
+    size_t beidou_signal_6 = 0;
+    for (size_t i = 0; i < view.count; i++)
+        if (view.satellites[i].system == GNSSSystem::BEIDOU && view.satellites[i].signal_id == 6)
+            beidou_signal_6 |= size_t(1) << i;
+    TEST_ASSERT_EQUAL(size_t(0x7) << (6 + 6 + 3 + 4 + 1 + 5 + 5 + 5), beidou_signal_6);
+}
+
+void test_gsv_group_in_progress()
+{
+    assembler.clear();
+
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::ACCEPTED, add("$GPGSV,2,1,05,01,10,100,30,02,20,200,31,03,30,300,32,04,40,045,33,1"));
+    TEST_ASSERT_FALSE(assembler.fresh());
+    TEST_ASSERT_EQUAL(0, assembler.snapshot().count);
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::PUBLISHED, add("$GPGSV,2,2,05,05,50,,,1"));
+
+    const GNSSSatellitesInView &one = assembler.snapshot();
+    TEST_ASSERT_EQUAL(5, one.count);
+    TEST_ASSERT_EQUAL(GNSSSatelliteInView::UNKNOWN_AZIMUTH, one.satellites[4].azimuth);
+    TEST_ASSERT_EQUAL(0, one.satellites[4].snr);
+
+    // A new GPS cycle under way: GLONASS completing meanwhile publishes the
+    // previous GPS group
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::ACCEPTED, add("$GPGSV,2,1,05,01,10,100,40,02,20,200,41,03,30,300,42,04,40,045,43,1"));
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::PUBLISHED, add("$GLGSV,1,1,02,70,12,010,25,71,,,,1"));
+    const GNSSSatellitesInView &two = assembler.snapshot();
+    TEST_ASSERT_EQUAL(2, two.sequence);
+    TEST_ASSERT_EQUAL(7, two.count);
+    TEST_ASSERT_EQUAL(30, two.satellites[0].snr);
+    TEST_ASSERT_EQUAL(GNSSSystem::GLONASS, two.satellites[5].system);
+    TEST_ASSERT_EQUAL(GNSSSatelliteInView::UNKNOWN_ELEVATION, two.satellites[6].elevation);
+
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::PUBLISHED, add("$GPGSV,2,2,05,05,50,250,44,1"));
+    const GNSSSatellitesInView &three = assembler.snapshot();
+    TEST_ASSERT_EQUAL(7, three.count);
+    TEST_ASSERT_EQUAL(40, three.satellites[0].snr);
+    TEST_ASSERT_EQUAL(44, three.satellites[4].snr);
+
+    // Other signals of the same talker are groups of their own, a group with
+    // nothing in view empties its satellites
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::PUBLISHED, add("$GPGSV,1,1,01,01,10,100,20,8"));
+    TEST_ASSERT_EQUAL(8, assembler.snapshot().count);
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::PUBLISHED, add("$GPGSV,1,1,00,1"));
+    TEST_ASSERT_EQUAL(3, assembler.snapshot().count);
+}
+
+void test_gsv_out_of_sequence()
+{
+    assembler.clear();
+
+    // No first sentence
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::IGNORED, add("$GBGSV,2,2,05,28,07,217,40,1"));
+    TEST_ASSERT_EQUAL(1, assembler.incomplete());
+
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::ACCEPTED, add("$GBGSV,3,1,09,01,10,100,30,02,20,200,31,03,30,300,32,04,40,045,33,1"));
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::PUBLISHED, add("$GBGSV,1,1,01,05,10,100,30,1"));
+    TEST_ASSERT_EQUAL(2, assembler.incomplete());
+    TEST_ASSERT_EQUAL(1, assembler.snapshot().count);
+
+    // Sentence 2 lost
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::ACCEPTED, add("$GBGSV,3,1,09,01,10,100,30,02,20,200,31,03,30,300,32,04,40,045,33,1"));
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::IGNORED, add("$GBGSV,3,3,09,09,10,100,30,1"));
+    TEST_ASSERT_EQUAL(3, assembler.incomplete());
+    TEST_ASSERT_FALSE(assembler.fresh());
+    TEST_ASSERT_EQUAL(1, assembler.snapshot().count);
+
+    // Malformed sequence numbers
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::IGNORED, add("$GBGSV,2,3,05,28,07,217,40,1"));
+    TEST_ASSERT_EQUAL(GNSSGSVAssembler::IGNORED, add("$GBGSV,0,0,05,28,07,217,40,1"));
+}
+
+void test_gsv_group_capacity()
+{
+    static BasicGNSSGSVAssembler<2> small;
+    const char *sentences[] = {"$GPGSV,1,1,01,01,10,100,20,1", "$GLGSV,1,1,01,70,10,100,20,1",
+                               "$GAGSV,1,1,01,11,10,100,20,7"};
+    for (size_t i = 0; i < 3; i++)
+    {
+        GNSSNMEAFields fields(sentences[i], strlen(sentences[i]));
+        TEST_ASSERT_EQUAL(i < 2 ? BasicGNSSGSVAssembler<2>::PUBLISHED : BasicGNSSGSVAssembler<2>::IGNORED,
+                          small.add(fields));
+    }
+    TEST_ASSERT_EQUAL(1, small.overflows());
+    TEST_ASSERT_EQUAL(2, small.snapshot().count);
+}
+
+#if !defined(ARDUINO)
+void test_gsv_snapshot_consistency()
+{
+    assembler.clear();
+
+    // Every group of a cycle carries the cycle in its SNR; a snapshot must
+    // never mix cycles within a group
+    const size_t cycles = 20000;
+    char sentence[96];
+    std::thread producer([&]
+                         {
+                             for (size_t cycle = 0; cycle < cycles; cycle++)
+                             {
+                                 unsigned snr = cycle % 99;
+                                 for (unsigned part = 1; part <= 3; part++)
+                                 {
+                                     snprintf(sentence, sizeof(sentence),
+                                              "$GAGSV,3,%u,12,%u,10,100,%u,%u,10,100,%u,%u,10,100,%u,%u,10,100,%u,7",
+                                              part, part * 4, snr, part * 4 + 1, snr, part * 4 + 2, snr,
+                                              part * 4 + 3, snr);
+                                     add(sentence);
+                                 }
+                             } });
+
+    size_t seen = 0;
+    uint32_t last = 0;
+    while (last < cycles)
+    {
+        const GNSSSatellitesInView &view = assembler.snapshot();
+        TEST_ASSERT_TRUE(view.sequence >= last);
+        if (view.sequence == last)
+            continue;
+        last = view.sequence;
+        seen++;
+
+        TEST_ASSERT_EQUAL(12, view.count);
+        for (size_t i = 1; i < view.count; i++)
+            TEST_ASSERT_EQUAL(view.satellites[0].snr, view.satellites[i].snr);
+        TEST_ASSERT_EQUAL((view.sequence - 1) % 99, view.satellites[0].snr);
+    }
+    producer.join();
+
+    TEST_ASSERT_TRUE(seen > 0);
+    TEST_ASSERT_EQUAL(0, assembler.incomplete());
+}
+#endif
+
+void register_gsv_assembler_tests()
+{
+    RUN_TEST(test_gsv_bulk_messages);
+    RUN_TEST(test_gsv_group_in_progress);
+    RUN_TEST(test_gsv_out_of_sequence);
+    RUN_TEST(test_gsv_group_capacity);
+#if !defined(ARDUINO)
+    RUN_TEST(test_gsv_snapshot_consistency);
+#endif
+}
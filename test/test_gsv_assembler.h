@@ -0,0 +1,6 @@
+#ifndef __TEST_GSV_ASSEMBLER_H__
+#define __TEST_GSV_ASSEMBLER_H__
+
+void register_gsv_assembler_tests();
+
+#endif // __TEST_GSV_ASSEMBLER_H__
@@ -1,6 +1,28 @@
 #include <unity.h>
 #include "test_nmea.h"
 #include "test_dumps.h"
+#include "test_crc.h"
+#include "test_sync_search.h"
+#include "test_message_view.h"
+#include "test_parser_config.h"
+#include "test_message_queue.h"
+#include "test_encode_stream.h"
+#include "test_push_sink.h"
+#include "test_concurrent_parser.h"
+#include "test_parser_pool.h"
+#include "test_chunked_parser.h"
+#include "test_mapped_file.h"
+#include "test_parser_stats.h"
+#include "test_rtcm3_header.h"
+#include "test_msm.h"
+#include "test_epoch_assembler.h"
+#include "test_ephemeris.h"
+#include "test_station.h"
+#include "test_nmea_decoder.h"
+#include "test_gsv_assembler.h"
+#include "test_message_filter.h"
+#include "test_ubx.h"
+#include "test_framer.h"
 
 void process()
 {
@@ -9,6 +31,28 @@ void process()
     // Register all test suites
     register_nmea_tests();
     register_dump_tests();
+    register_crc_tests();
+    register_sync_search_tests();
+    register_message_view_tests();
+    register_parser_config_tests();
+    register_message_queue_tests();
+    register_encode_stream_tests();
+    register_push_sink_tests();
+    register_concurrent_parser_tests();
+    register_parser_pool_tests();
+    register_chunked_parser_tests();
+    register_mapped_file_tests();
+    register_parser_stats_tests();
+    register_rtcm3_header_tests();
+    register_msm_tests();
+    register_epoch_assembler_tests();
+    register_ephemeris_tests();
+    register_station_tests();
+    register_nmea_decoder_tests();
+    register_gsv_assembler_tests();
+    register_message_filter_tests();
+    register_ubx_tests();
+    register_framer_tests();
 
     UNITY_END();
 }
@@ -0,0 +1,69 @@
+#include <unity.h>
+#include <stdio.h>
+
+#if !defined(ARDUINO)
+#include <vector>
+#include "GNSSChunkedParser.h"
+#include "GNSSMappedFile.h"
+
+static const char *CAPTURE = "test/test-data/test-data-656-43.bin";
+
+void test_mapped_file_contents()
+{
+    std::vector<uint8_t> expected;
+    FILE *file = fopen(CAPTURE, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+    int c;
+    while ((c = fgetc(file)) != EOF)
+    {
+        expected.push_back(static_cast<uint8_t>(c));
+    }
+    fclose(file);
+
+    GNSSMappedFile mapped(CAPTURE);
+    TEST_ASSERT_TRUE(mapped.valid());
+    TEST_ASSERT_EQUAL(expected.size(), mapped.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected.data(), mapped.data(), expected.size());
+}
+
+void test_mapped_file_missing()
+{
+    GNSSMappedFile mapped("test/test-data/does-not-exist.bin");
+    TEST_ASSERT_FALSE(mapped.valid());
+    TEST_ASSERT_EQUAL(0, mapped.size());
+}
+
+void test_parse_from_mapping()
+{
+    GNSSMappedFile mapped(CAPTURE);
+    TEST_ASSERT_TRUE(mapped.valid());
+
+    size_t nmea = 0;
+    size_t rtcm = 0;
+    GNSSChunkedParser parser(2);
+    parser.parse(mapped.data(), mapped.size(), [&](const GNSSChunkedParser::Frame &frame)
+                 {
+                     if (frame.type == GNSSParserBase::Message::Type::NMEA)
+                         nmea++;
+                     else if (frame.type == GNSSParserBase::Message::Type::RTCM3)
+                         rtcm++;
+                 });
+
+    TEST_ASSERT_EQUAL(656, nmea);
+    TEST_ASSERT_EQUAL(43, rtcm);
+}
+
+void register_mapped_file_tests()
+{
+    RUN_TEST(test_mapped_file_contents);
+    RUN_TEST(test_mapped_file_missing);
+    RUN_TEST(test_parse_from_mapping);
+}
+
+#else
+
+void register_mapped_file_tests()
+{
+}
+
+#endif
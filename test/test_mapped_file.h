@@ -0,0 +1,6 @@
+#ifndef __TEST_MAPPED_FILE_H__
+#define __TEST_MAPPED_FILE_H__
+
+void register_mapped_file_tests();
+
+#endif // __TEST_MAPPED_FILE_H__
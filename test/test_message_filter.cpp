@@ -0,0 +1,332 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "GNSSParser.h"
+#include "GNSSRTCM3.h"
+
+typedef std::vector<std::vector<uint8_t>> Frames;
+
+static std::vector<uint8_t> loadCapture(const char *path)
+{
+    std::vector<uint8_t> data;
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    int c;
+    while ((c = fgetc(file)) != EOF)
+        data.push_back(static_cast<uint8_t>(c));
+
+    fclose(file);
+    return data;
+}
+
+static std::vector<uint8_t> bytes(const GNSSParserBase::MessageView &view)
+{
+    std::vector<uint8_t> frame(view.length());
+    view.copyTo(frame.data());
+    return frame;
+}
+
+// What a consumer sees through the parser's filter, or filtering by itself
+// when filter is nullptr and wanted() decides
+template <class Wanted>
+static Frames frames(const std::vector<uint8_t> &data, const GNSSMessageFilter *filter, Wanted wanted)
+{
+    Frames seen;
+    GNSSParser parser;
+    parser.setFilter(filter);
+    parser.encode_to(data.data(), data.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                     {
+                         if (valid && wanted(view))
+                             seen.push_back(bytes(view));
+                     });
+    return seen;
+}
+
+static bool isGGA(const std::vector<uint8_t> &sentence)
+{
+    return sentence.size() > 7 && memcmp(sentence.data() + 3, "GGA,", 4) == 0;
+}
+
+void test_filter_capture()
+{
+    std::vector<uint8_t> data = loadCapture("test/test-data/test-data-656-43.bin");
+
+    // Reference: everything framed, the consumer keeps GGA and 1005 / 1077
+    Frames expected = frames(data, nullptr, [](const GNSSParser::MessageView &view)
+                             {
+                                 if (view.type == GNSSParserBase::Message::Type::RTCM3)
+                                 {
+                                     uint16_t number = GNSSRTCM3Header(view).messageNumber();
+                                     return number == 1005 || number == 1077;
+                                 }
+                                 return isGGA(bytes(view));
+                             });
+    TEST_ASSERT_TRUE(expected.size() > 10);
+
+    GNSSMessageFilter filter;
+    filter.allowRTCM3(1005);
+    filter.allowRTCM3(1077);
+    filter.allowNMEA("GGA");
+    auto all = [](const GNSSParser::MessageView &) { return true; };
+
+    Frames checked = frames(data, &filter, all);
+    TEST_ASSERT_TRUE(expected == checked);
+
+    // Skipping by length needs a clean stream: the capture has frames cut
+    // short, whose lengths would swallow the frames after them
+    std::vector<uint8_t> clean;
+    Frames everything = frames(data, nullptr, all);
+    for (size_t i = 0; i < everything.size(); i++)
+        clean.insert(clean.end(), everything[i].begin(), everything[i].end());
+
+    filter.setSkipRejected(true);
+    Frames skipped = frames(clean, &filter, all);
+    TEST_ASSERT_TRUE(expected == skipped);
+
+    // Unfiltered protocols pass whole
+    GNSSMessageFilter rtcm_only;
+    rtcm_only.allowRTCM3(1077);
+    Frames nmea = frames(data, &rtcm_only, [](const GNSSParser::MessageView &view)
+                         { return view.type == GNSSParserBase::Message::Type::NMEA; });
+    TEST_ASSERT_EQUAL(656, nmea.size());
+}
+
+void test_filter_nmea_addresses()
+{
+    std::string stream = "$GNGGA,140656.00,4430.39666339,N,02600.98986769,E,7,17,1.0,89.7706,M,35.4899,M,,*42\r\n"
+                         "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+                         "$GNGSA,M,3,24,28,29,31,32,,,,,,,,1.5,1.0,1.1,1*3C\r\n"
+                         "$GPGSV,2,2,06,32,14,266,25,31,06,321,30,1*64\r\n"
+                         "$GLGSV,1,1,01,86,75,146,32,3*45\r\n";
+
+    GNSSMessageFilter filter;
+    filter.allowNMEA("GPGGA");
+    filter.allowNMEA("GSV");
+    TEST_ASSERT_FALSE(filter.allowNMEA("GPGGAX"));
+
+    // Queued mode, fed byte by byte so every decision spans several calls
+    GNSSParser parser;
+    parser.setFilter(&filter);
+    for (size_t i = 0; i < stream.size(); i++)
+        parser.encode(static_cast<uint8_t>(stream[i]));
+
+    const char *expected[] = {"$GPGGA", "$GPGSV", "$GLGSV"};
+    for (size_t i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_TRUE(parser.available());
+        GNSSParser::Message message = parser.getMessage();
+        TEST_ASSERT_EQUAL(0, memcmp(message.data, expected[i], 6));
+    }
+    TEST_ASSERT_FALSE(parser.available());
+
+    // Blocked entirely
+    filter.blockNMEA();
+    parser.encode(reinterpret_cast<const uint8_t *>(stream.data()), stream.size());
+    TEST_ASSERT_FALSE(parser.available());
+
+    // Back to everything
+    parser.setFilter(nullptr);
+    parser.encode(reinterpret_cast<const uint8_t *>(stream.data()), stream.size());
+    size_t count = 0;
+    while (parser.available())
+    {
+        parser.getMessage();
+        count++;
+    }
+    TEST_ASSERT_EQUAL(5, count);
+}
+
+static std::vector<uint8_t> rtcm3Frame(uint16_t number, size_t payload_length)
+{
+    std::vector<uint8_t> frame = {0xD3, uint8_t(payload_length >> 8), uint8_t(payload_length & 0xFF)};
+    for (size_t i = 0; i < payload_length; i++)
+        frame.push_back(uint8_t(i * 37));
+    if (payload_length >= 2)
+    {
+        frame[3] = number >> 4;
+        frame[4] = uint8_t((number & 0x0F) << 4) | (frame[4] & 0x0F);
+    }
+    uint32_t crc = GNSSCRC24Q::calculate(frame.data(), frame.size());
+    frame.push_back(crc >> 16);
+    frame.push_back(crc >> 8);
+    frame.push_back(crc);
+    return frame;
+}
+
+void test_filter_wrapped_header()
+{
+    std::vector<uint8_t> wanted = rtcm3Frame(1230, 20);
+    std::vector<uint8_t> unwanted = rtcm3Frame(1074, 20);
+    GNSSMessageFilter filter;
+    filter.allowRTCM3(1230);
+
+    // The header straddles the end of the ring at every offset
+    for (size_t padding = 1; padding <= 6; padding++)
+    {
+        for (int skip = 0; skip < 2; skip++)
+        {
+            filter.setSkipRejected(skip != 0);
+            BasicGNSSParser<128, 8> parser;
+            parser.setFilter(&filter);
+            std::vector<uint8_t> filler(128 - padding, 0);
+            parser.encode(filler.data(), filler.size());
+
+            size_t seen = 0;
+            auto sink = [&](const GNSSParserBase::MessageView &view, bool valid)
+            {
+                TEST_ASSERT_TRUE(valid);
+                TEST_ASSERT_EQUAL(1230, GNSSRTCM3Header(view).messageNumber());
+                seen++;
+            };
+            parser.encode_to(unwanted.data(), unwanted.size(), sink);
+            parser.encode_to(wanted.data(), wanted.size(), sink);
+            TEST_ASSERT_EQUAL(1, seen);
+        }
+    }
+
+    // Frames too short for a message number count as number 0
+    std::vector<uint8_t> empty = rtcm3Frame(0, 0);
+    GNSSParser parser;
+    parser.setFilter(&filter);
+    parser.encode(empty.data(), empty.size());
+    TEST_ASSERT_FALSE(parser.available());
+    filter.allowRTCM3(0);
+    parser.encode(empty.data(), empty.size());
+    TEST_ASSERT_TRUE(parser.available());
+}
+
+void test_filter_skip_tradeoff()
+{
+    // A corrupted header claiming a rejected number, with a wanted frame
+    // inside the bytes it claims to cover
+    std::vector<uint8_t> wanted = rtcm3Frame(1005, 19);
+    std::vector<uint8_t> stream = {0xD3, 0x00, 0x40, 0x43, 0x20, 0x00};
+    stream.insert(stream.end(), wanted.begin(), wanted.end());
+    stream.resize(stream.size() + 64, 0);
+
+    GNSSMessageFilter filter;
+    filter.allowRTCM3(1005);
+
+    // Checked, the false frame fails its CRC and the wanted one is found
+    GNSSParser checked;
+    checked.setFilter(&filter);
+    checked.encode(stream.data(), stream.size());
+    TEST_ASSERT_TRUE(checked.available());
+    TEST_ASSERT_EQUAL(1005, GNSSRTCM3Header(checked.getMessage()).messageNumber());
+
+    // Skipped by length, it is lost
+    filter.setSkipRejected(true);
+    GNSSParser skipped;
+    skipped.setFilter(&filter);
+    skipped.encode(stream.data(), stream.size());
+    TEST_ASSERT_FALSE(skipped.available());
+}
+
+void test_filter_rejected_corrupt()
+{
+    // A rejected frame with a broken CRC, then a wanted one
+    std::vector<uint8_t> rejected = rtcm3Frame(1074, 40);
+    rejected.back() ^= 0x01;
+    std::vector<uint8_t> wanted = rtcm3Frame(1005, 19);
+    std::vector<uint8_t> stream = rejected;
+    stream.insert(stream.end(), wanted.begin(), wanted.end());
+
+    GNSSMessageFilter filter;
+    filter.allowRTCM3(1005);
+
+    GNSSParser parser;
+    parser.setFilter(&filter);
+    size_t valid_frames = 0, invalid_frames = 0;
+    parser.encode_to(stream.data(), stream.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                     {
+                         if (valid)
+                         {
+                             valid_frames++;
+                             TEST_ASSERT_EQUAL(wanted.size(), view.length());
+                         }
+                         else
+                             invalid_frames++;
+                     });
+
+    TEST_ASSERT_EQUAL(1, valid_frames);
+    TEST_ASSERT_EQUAL(0, invalid_frames);
+
+#if GNSS_PARSER_STATS
+    GNSSParser::Stats stats = parser.stats();
+    TEST_ASSERT_EQUAL(1, stats.filtered_frames);
+    TEST_ASSERT_EQUAL(0, stats.bytes_filtered);
+    TEST_ASSERT_EQUAL(0, stats.crc_failures);
+    TEST_ASSERT_EQUAL(rejected.size(), stats.bytes_skipped);
+#endif
+}
+
+#if GNSS_PARSER_STATS
+void test_filter_stats()
+{
+    std::vector<uint8_t> data = loadCapture("test/test-data/test-data-656-43.bin");
+    GNSSMessageFilter filter;
+    filter.allowRTCM3(1077);
+    filter.blockNMEA();
+
+    // Candidates failing their check in the capture, filtered when their
+    // header is rejected and counted as failures otherwise
+    size_t failed = 0;
+    GNSSParser unfiltered;
+    unfiltered.encode_to(data.data(), data.size(), [&](const GNSSParser::MessageView &, bool valid)
+                         {
+                             if (!valid)
+                                 failed++;
+                         });
+
+    for (int skip = 0; skip < 2; skip++)
+    {
+        filter.setSkipRejected(skip != 0);
+        GNSSParser parser;
+        parser.setFilter(&filter);
+        size_t passed = 0, passed_bytes = 0;
+        parser.encode_to(data.data(), data.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                         {
+                             if (valid)
+                             {
+                                 passed++;
+                                 passed_bytes += view.length();
+                             }
+                         });
+
+        GNSSParser::Stats stats = parser.stats();
+        TEST_ASSERT_EQUAL(passed, stats.rtcm3_frames);
+        TEST_ASSERT_EQUAL(0, stats.nmea_frames);
+        TEST_ASSERT_EQUAL(skip ? stats.bytes_filtered : 0, stats.bytes_unchecked);
+
+        // Checked, exactly the valid frames not wanted and the rejected
+        // candidates failing their check; skipping unchecked also takes in
+        // frames cut short in the capture
+        if (skip)
+            TEST_ASSERT_TRUE(stats.filtered_frames >= 656);
+        else
+            TEST_ASSERT_EQUAL(656 + 43 - passed + failed,
+                              stats.filtered_frames + stats.crc_failures + stats.checksum_failures);
+
+        // Every byte is passed, filtered or skipped, apart from a candidate
+        // cut off at the end
+        uint64_t accounted = passed_bytes + stats.bytes_filtered + stats.bytes_skipped;
+        TEST_ASSERT_TRUE(accounted <= data.size());
+        TEST_ASSERT_TRUE(data.size() - accounted < GNSSParser::MAX_RTCM3_LENGTH);
+    }
+}
+#endif
+
+void register_message_filter_tests()
+{
+    RUN_TEST(test_filter_capture);
+    RUN_TEST(test_filter_nmea_addresses);
+    RUN_TEST(test_filter_wrapped_header);
+    RUN_TEST(test_filter_skip_tradeoff);
+    RUN_TEST(test_filter_rejected_corrupt);
+#if GNSS_PARSER_STATS
+    RUN_TEST(test_filter_stats);
+#endif
+}
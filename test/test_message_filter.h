@@ -0,0 +1,6 @@
+#ifndef __TEST_MESSAGE_FILTER_H__
+#define __TEST_MESSAGE_FILTER_H__
+
+void register_message_filter_tests();
+
+#endif // __TEST_MESSAGE_FILTER_H__
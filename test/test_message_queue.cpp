@@ -0,0 +1,159 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <string>
+#include <vector>
+#include "GNSSParser.h"
+
+static const char *SENTENCE = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+
+#if !defined(ARDUINO)
+// Count every allocation made through operator new in this test binary
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+#endif
+
+void test_queue_wraps_around()
+{
+    GNSSMessageQueue<int, 3> queue;
+
+    for (int i = 0; i < 10; i++)
+    {
+        TEST_ASSERT_TRUE(queue.push(i));
+        TEST_ASSERT_TRUE(queue.push(i + 100));
+        TEST_ASSERT_EQUAL(i, queue.front());
+        TEST_ASSERT_EQUAL(i + 100, queue.at(1));
+        queue.pop(2);
+        TEST_ASSERT_TRUE(queue.empty());
+    }
+
+    TEST_ASSERT_TRUE(queue.push(1));
+    TEST_ASSERT_TRUE(queue.push(2));
+    TEST_ASSERT_TRUE(queue.push(3));
+    TEST_ASSERT_TRUE(queue.full());
+    TEST_ASSERT_FALSE(queue.push(4));
+    TEST_ASSERT_EQUAL(3, queue.at(2));
+}
+
+void test_full_queue_counts_dropped()
+{
+    BasicGNSSParser<4096, 2> parser;
+    std::string sentences = std::string(SENTENCE) + SENTENCE + SENTENCE;
+
+    TEST_ASSERT_TRUE(parser.encode((const uint8_t *)sentences.data(), sentences.size()));
+    TEST_ASSERT_EQUAL(1, parser.dropped());
+
+    parser.release(2);
+    TEST_ASSERT_FALSE(parser.available());
+
+    parser.clear();
+    TEST_ASSERT_EQUAL(0, parser.dropped());
+}
+
+void test_batch_draining()
+{
+    GNSSParser parser;
+    size_t length = strlen(SENTENCE);
+
+    for (int i = 0; i < 5; i++)
+    {
+        TEST_ASSERT_TRUE(parser.encode((const uint8_t *)SENTENCE, length));
+    }
+
+    GNSSParser::MessageView views[8];
+    size_t count = parser.peekMessages(views, 8);
+    TEST_ASSERT_EQUAL(5, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL(length, views[i].length());
+        TEST_ASSERT_EQUAL_MEMORY(SENTENCE, views[i].first, length);
+    }
+    TEST_ASSERT_TRUE(views[1].first == views[0].first + length);
+
+    TEST_ASSERT_EQUAL(2, parser.peekMessages(views, 2));
+    parser.release(count);
+    TEST_ASSERT_FALSE(parser.available());
+    TEST_ASSERT_EQUAL(GNSSParser::BUFFER_SIZE, parser.available_write_space());
+}
+
+void test_steady_state_does_not_allocate()
+{
+#if defined(ARDUINO)
+    TEST_IGNORE_MESSAGE("Allocation counting needs a hosted build");
+#else
+    FILE *file = fopen("test/test-data/test-data-33816-2193.bin", "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    fclose(file);
+
+    GNSSParser parser;
+    size_t messages = 0;
+    size_t before = allocations;
+
+    for (size_t pos = 0; pos < data.size(); pos += 512)
+    {
+        TEST_ASSERT_TRUE(parser.encode(data.data() + pos, std::min<size_t>(512, data.size() - pos)));
+
+        GNSSParser::MessageView views[16];
+        size_t count;
+        while ((count = parser.peekMessages(views, 16)) > 0)
+        {
+            messages += count;
+            parser.release(count);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(0, allocations - before);
+    TEST_ASSERT_EQUAL(33816 + 2193, messages);
+#endif
+}
+
+void register_message_queue_tests()
+{
+    RUN_TEST(test_queue_wraps_around);
+    RUN_TEST(test_full_queue_counts_dropped);
+    RUN_TEST(test_batch_draining);
+    RUN_TEST(test_steady_state_does_not_allocate);
+}
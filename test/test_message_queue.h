@@ -0,0 +1,6 @@
+#ifndef __TEST_MESSAGE_QUEUE_H__
+#define __TEST_MESSAGE_QUEUE_H__
+
+void register_message_queue_tests();
+
+#endif // __TEST_MESSAGE_QUEUE_H__
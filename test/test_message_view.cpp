@@ -0,0 +1,198 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <utility>
+#include "GNSSParser.h"
+
+static const char *SENTENCE = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+
+void test_view_is_in_place()
+{
+    GNSSParser parser;
+    size_t length = strlen(SENTENCE);
+    TEST_ASSERT_TRUE(parser.encode((const uint8_t *)SENTENCE, length));
+
+    GNSSParser::MessageView view = parser.peekMessage();
+    TEST_ASSERT_EQUAL(GNSSParser::Message::Type::NMEA, view.type);
+    TEST_ASSERT_EQUAL(length, view.length());
+    TEST_ASSERT_NULL(view.second);
+    TEST_ASSERT_EQUAL_MEMORY(SENTENCE, view.first, length);
+
+    // Peeking again returns the same message until it is released
+    TEST_ASSERT_TRUE(parser.peekMessage().first == view.first);
+    parser.release();
+    TEST_ASSERT_FALSE(parser.available());
+    TEST_ASSERT_EQUAL(GNSSParser::Message::Type::UNKNOWN, parser.peekMessage().type);
+}
+
+void test_view_of_wrapped_message()
+{
+    GNSSParser parser;
+    size_t length = strlen(SENTENCE);
+    size_t sentences = 0;
+    size_t wrapped = 0;
+
+    // Enough sentences to wrap around the ring several times
+    for (size_t i = 0; i < 3 * GNSSParser::BUFFER_SIZE / length; i++)
+    {
+        TEST_ASSERT_TRUE(parser.encode((const uint8_t *)SENTENCE, length));
+
+        while (parser.available())
+        {
+            GNSSParser::MessageView view = parser.peekMessage();
+            TEST_ASSERT_EQUAL(length, view.length());
+
+            uint8_t copy[GNSSParser::MAX_MESSAGE_LENGTH];
+            TEST_ASSERT_EQUAL(length, view.copyTo(copy));
+            TEST_ASSERT_EQUAL_MEMORY(SENTENCE, copy, length);
+
+            if (view.second)
+                wrapped++;
+
+            parser.release();
+            sentences++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL(3 * GNSSParser::BUFFER_SIZE / length, sentences);
+    TEST_ASSERT_GREATER_THAN(0, wrapped);
+}
+
+void test_release_frees_space()
+{
+    GNSSParser parser;
+    size_t length = strlen(SENTENCE);
+
+    TEST_ASSERT_TRUE(parser.encode((const uint8_t *)SENTENCE, length));
+    TEST_ASSERT_TRUE(parser.encode((const uint8_t *)SENTENCE, length));
+    TEST_ASSERT_EQUAL(GNSSParser::BUFFER_SIZE - 2 * length, parser.available_write_space());
+
+    parser.release();
+    TEST_ASSERT_EQUAL(GNSSParser::BUFFER_SIZE - length, parser.available_write_space());
+
+    parser.release();
+    TEST_ASSERT_EQUAL(GNSSParser::BUFFER_SIZE, parser.available_write_space());
+}
+
+void test_instances_do_not_share_messages()
+{
+    const char *other = "$GNRMC,140658.00,A,4430.39666339,N,02600.98986769,E,0.007,316.3,070125,6.1,E,M,S*5C\r\n";
+    GNSSParser first;
+    GNSSParser second;
+
+    TEST_ASSERT_TRUE(first.encode((const uint8_t *)SENTENCE, strlen(SENTENCE)));
+    TEST_ASSERT_TRUE(second.encode((const uint8_t *)other, strlen(other)));
+
+    GNSSParser::Message a = first.getMessage();
+    GNSSParser::Message b = second.getMessage();
+
+    TEST_ASSERT_EQUAL_MEMORY(SENTENCE, a.data, a.length);
+    TEST_ASSERT_EQUAL_MEMORY(other, b.data, b.length);
+}
+
+void test_mirrored_views_are_contiguous()
+{
+    GNSSParser parser(GNSSParser::MIRRORED_STORAGE);
+    if (!parser.mirrored())
+    {
+        TEST_MESSAGE("Mirrored storage not available, skipping");
+        return;
+    }
+
+    size_t length = strlen(SENTENCE);
+    size_t sentences = 0;
+
+    for (size_t i = 0; i < 3 * GNSSParser::BUFFER_SIZE / length; i++)
+    {
+        TEST_ASSERT_TRUE(parser.encode((const uint8_t *)SENTENCE, length));
+
+        while (parser.available())
+        {
+            GNSSParser::MessageView view = parser.peekMessage();
+            TEST_ASSERT_NULL(view.second);
+            TEST_ASSERT_EQUAL(length, view.first_length);
+            TEST_ASSERT_EQUAL_MEMORY(SENTENCE, view.first, length);
+            parser.release();
+            sentences++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL(3 * GNSSParser::BUFFER_SIZE / length, sentences);
+}
+
+// A queued sentence and half of the next one, then the rest into each parser
+static void assertCopyIsIndependent(GNSSParser &original, GNSSParser &copy)
+{
+    size_t length = strlen(SENTENCE);
+    const uint8_t *rest = (const uint8_t *)SENTENCE + length / 2;
+
+    TEST_ASSERT_TRUE(copy.encode(rest, length - length / 2));
+    original.clear();
+
+    GNSSParser::MessageView views[2];
+    TEST_ASSERT_EQUAL(2, copy.peekMessages(views, 2));
+    for (size_t i = 0; i < 2; i++)
+    {
+        uint8_t message[128];
+        TEST_ASSERT_EQUAL(length, views[i].copyTo(message));
+        TEST_ASSERT_EQUAL_MEMORY(SENTENCE, message, length);
+    }
+    copy.release(2);
+    TEST_ASSERT_FALSE(original.available());
+}
+
+void test_copy_has_own_ring()
+{
+    size_t length = strlen(SENTENCE);
+    GNSSParser parser;
+    parser.encode((const uint8_t *)SENTENCE, length);
+    parser.encode((const uint8_t *)SENTENCE, length / 2);
+
+    GNSSParser copy(parser);
+    assertCopyIsIndependent(parser, copy);
+
+    GNSSParser assigned;
+    parser.encode((const uint8_t *)SENTENCE, length);
+    parser.encode((const uint8_t *)SENTENCE, length / 2);
+    assigned = parser;
+    assertCopyIsIndependent(parser, assigned);
+}
+
+void test_copy_of_mirrored_parser()
+{
+    size_t length = strlen(SENTENCE);
+    GNSSParser parser(GNSSParser::MIRRORED_STORAGE);
+    if (!parser.mirrored())
+    {
+        TEST_MESSAGE("Mirrored storage not available, skipping");
+        return;
+    }
+
+    // Leave the sentences wrapping around the end of the ring
+    for (size_t i = 0; i < GNSSParser::BUFFER_SIZE / length; i++)
+    {
+        parser.encode((const uint8_t *)SENTENCE, length);
+        parser.release();
+    }
+    parser.encode((const uint8_t *)SENTENCE, length);
+    parser.encode((const uint8_t *)SENTENCE, length / 2);
+
+    GNSSParser copy(parser);
+    TEST_ASSERT_TRUE(copy.mirrored());
+    TEST_ASSERT_TRUE(copy.peekMessage().first != parser.peekMessage().first);
+    assertCopyIsIndependent(parser, copy);
+
+    GNSSParser moved(std::move(copy));
+    TEST_ASSERT_TRUE(moved.mirrored());
+}
+
+void register_message_view_tests()
+{
+    RUN_TEST(test_view_is_in_place);
+    RUN_TEST(test_view_of_wrapped_message);
+    RUN_TEST(test_release_frees_space);
+    RUN_TEST(test_instances_do_not_share_messages);
+    RUN_TEST(test_mirrored_views_are_contiguous);
+    RUN_TEST(test_copy_has_own_ring);
+    RUN_TEST(test_copy_of_mirrored_parser);
+}
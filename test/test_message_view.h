@@ -0,0 +1,6 @@
+#ifndef __TEST_MESSAGE_VIEW_H__
+#define __TEST_MESSAGE_VIEW_H__
+
+void register_message_view_tests();
+
+#endif // __TEST_MESSAGE_VIEW_H__
@@ -0,0 +1,340 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "GNSSMSM.h"
+#include "test_bit_writer.h"
+
+// Metres per millisecond
+static const double MS = GNSSMSMDecoder::SPEED_OF_LIGHT / 1000.0;
+
+// MSM header with the given masks; cell mask bits in satellite-major order
+static void putHeader(BitWriter &writer, uint16_t number, uint64_t satellite_mask, uint32_t signal_mask,
+                      uint64_t cell_mask, unsigned cell_bits)
+{
+    writer.put(number, 12);
+    writer.put(1234, 12); // station
+    writer.put(345600000, 30);
+    writer.put(0, 1);     // multiple message
+    writer.put(5, 3);     // IODS
+    writer.put(0, 7);
+    writer.put(2, 2);     // clock steering
+    writer.put(1, 2);     // external clock
+    writer.put(1, 1);     // smoothing
+    writer.put(3, 3);     // smoothing interval
+    writer.put(satellite_mask, 64);
+    writer.put(signal_mask, 32);
+    writer.put(cell_mask, cell_bits);
+}
+
+static std::vector<std::vector<uint8_t>> captureFrames(const char *path)
+{
+    std::vector<std::vector<uint8_t>> frames;
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    GNSSParser parser;
+    uint8_t chunk[256];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        parser.encode_to(chunk, read, [&](const GNSSParser::MessageView &view, bool valid)
+                         {
+                             if (valid && view.type == GNSSParser::Message::Type::RTCM3)
+                             {
+                                 std::vector<uint8_t> frame(view.length());
+                                 view.copyTo(frame.data());
+                                 frames.push_back(frame);
+                             }
+                         });
+    }
+    fclose(file);
+    return frames;
+}
+
+// Reference values come from an independent decode of the capture following
+// RTCM 10403.3, the same fields test/validation/rtcm-parser.js prints
+void test_msm4_from_capture()
+{
+    std::vector<std::vector<uint8_t>> frames = captureFrames("test/test-data/test-data-656-43.bin");
+    GNSSMSMObservations obs;
+
+    // First frame: Galileo MSM4
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::decode(frames[0].data(), frames[0].size(), obs));
+    TEST_ASSERT_EQUAL(1094, obs.message_number);
+    TEST_ASSERT_EQUAL(0, obs.station_id);
+    TEST_ASSERT_EQUAL(GNSSSystem::GALILEO, obs.system);
+    TEST_ASSERT_EQUAL(4, obs.msm_type);
+    TEST_ASSERT_EQUAL(223634000, obs.epoch_time);
+    TEST_ASSERT_TRUE(obs.multiple_message);
+    TEST_ASSERT_EQUAL(1, obs.clock_steering);
+
+    const uint8_t satellites[] = {4, 13, 19, 21, 26, 27, 29};
+    TEST_ASSERT_EQUAL(7, obs.satellite_count);
+    TEST_ASSERT_EQUAL_MEMORY(satellites, obs.satellite_id, sizeof(satellites));
+    TEST_ASSERT_EQUAL(19, obs.cell_count);
+
+    // Satellite 4 has no E1 cell, so its first cell is signal 15 (E5b)
+    TEST_ASSERT_EQUAL(0, obs.cell_satellite[0]);
+    TEST_ASSERT_EQUAL(15, obs.signal_id[0]);
+    TEST_ASSERT_TRUE(fabs(obs.pseudorange[0] - 27232024.612870283) < 1e-6);
+    TEST_ASSERT_TRUE(fabs(obs.phaserange[0] - 27232022.82317595) < 1e-6);
+    TEST_ASSERT_TRUE(isnan(obs.phaserange_rate[0]));
+    TEST_ASSERT_TRUE(obs.cnr[0] == 38.0f);
+    TEST_ASSERT_EQUAL(15, obs.lock_time[0]);
+    TEST_ASSERT_FALSE(obs.half_cycle[0]);
+
+    // Last cell: satellite 29, signal 23 (E5a)
+    TEST_ASSERT_EQUAL(6, obs.cell_satellite[18]);
+    TEST_ASSERT_EQUAL(23, obs.signal_id[18]);
+    TEST_ASSERT_TRUE(fabs(obs.pseudorange[18] - 28644319.37178939) < 1e-6);
+    TEST_ASSERT_TRUE(fabs(obs.phaserange[18] - 28644277.876009207) < 1e-6);
+    TEST_ASSERT_TRUE(obs.cnr[18] == 36.0f);
+
+    // Second frame: BeiDou MSM4 whose first cell has no valid phase
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::decode(frames[1].data(), frames[1].size(), obs));
+    TEST_ASSERT_EQUAL(1124, obs.message_number);
+    TEST_ASSERT_EQUAL(25, obs.cell_count);
+    TEST_ASSERT_TRUE(fabs(obs.pseudorange[0] - 23574455.45443606) < 1e-6);
+    TEST_ASSERT_TRUE(isnan(obs.phaserange[0]));
+    TEST_ASSERT_EQUAL(0, obs.lock_time[0]);
+}
+
+void test_msm_totals_over_captures()
+{
+    struct
+    {
+        const char *path;
+        size_t messages;
+        size_t cells;
+    } captures[] = {
+        {"test/test-data/test-data-56-5.bin", 4, 84},
+        {"test/test-data/test-data-656-43.bin", 39, 617},
+        {"test/test-data/test-data-33816-2193.bin", 1963, 27428},
+    };
+
+    for (auto &capture : captures)
+    {
+        size_t messages = 0;
+        size_t cells = 0;
+        GNSSMSMObservations obs;
+
+        for (const std::vector<uint8_t> &frame : captureFrames(capture.path))
+        {
+            GNSSRTCM3Header header(frame.data(), frame.size());
+            if (!header.isMSM())
+            {
+                TEST_ASSERT_FALSE(GNSSMSMDecoder::decode(frame.data(), frame.size(), obs));
+                continue;
+            }
+
+            TEST_ASSERT_TRUE(GNSSMSMDecoder::decode(frame.data(), frame.size(), obs));
+            messages++;
+            cells += obs.cell_count;
+
+            for (size_t i = 0; i < obs.cell_count; i++)
+            {
+                // Every range is somewhere between the ground and geostationary orbit
+                TEST_ASSERT_TRUE(isnan(obs.pseudorange[i]) || (obs.pseudorange[i] > 1.8e7 && obs.pseudorange[i] < 4.2e7));
+            }
+        }
+
+        TEST_ASSERT_EQUAL(capture.messages, messages);
+        TEST_ASSERT_EQUAL(capture.cells, cells);
+    }
+}
+
+void test_msm7_round_trip()
+{
+    // Satellites 3 and 40, signals 2 and 22, three of the four cells
+    uint64_t satellite_mask = (uint64_t(1) << (64 - 3)) | (uint64_t(1) << (64 - 40));
+    uint32_t signal_mask = (1u << (32 - 2)) | (1u << (32 - 22));
+
+    BitWriter writer;
+    putHeader(writer, 1077, satellite_mask, signal_mask, 0xB, 4); // 1011
+    writer.put(70, 8);
+    writer.put(255, 8); // satellite 40: rough range invalid
+    writer.put(9, 4);
+    writer.put(0, 4);
+    writer.put(512, 10);
+    writer.put(0, 10);
+    writer.put(-1200 & 0x3FFF, 14);
+    writer.put(-8192 & 0x3FFF, 14);
+
+    writer.put(1 << 18, 20);                   // +2^-11 ms
+    writer.put(-(1 << 19) & 0xFFFFF, 20);      // invalid
+    writer.put(0, 20);
+    writer.put(-(1 << 20) & 0xFFFFFF, 24);     // -2^-11 ms
+    writer.put(12345, 24);
+    writer.put(-(1 << 23) & 0xFFFFFF, 24);     // invalid
+    writer.put(700, 10);
+    writer.put(3, 10);
+    writer.put(1023, 10);
+    writer.put(1, 1);
+    writer.put(0, 1);
+    writer.put(0, 1);
+    writer.put(45 * 16 + 8, 10);               // 45.5 dB-Hz
+    writer.put(30 * 16, 10);
+    writer.put(0, 10);
+    writer.put(2500, 15);                      // +0.25 m/s
+    writer.put(-16384 & 0x7FFF, 15);           // invalid
+    writer.put(100, 15);
+
+    std::vector<uint8_t> frame = writer.frame();
+    GNSSMSMObservations obs;
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::decode(frame.data(), frame.size(), obs));
+
+    TEST_ASSERT_EQUAL(1077, obs.message_number);
+    TEST_ASSERT_EQUAL(1234, obs.station_id);
+    TEST_ASSERT_EQUAL(GNSSSystem::GPS, obs.system);
+    TEST_ASSERT_EQUAL(7, obs.msm_type);
+    TEST_ASSERT_EQUAL(345600000, obs.epoch_time);
+    TEST_ASSERT_FALSE(obs.multiple_message);
+    TEST_ASSERT_EQUAL(5, obs.iods);
+    TEST_ASSERT_EQUAL(2, obs.clock_steering);
+    TEST_ASSERT_EQUAL(1, obs.external_clock);
+    TEST_ASSERT_TRUE(obs.smoothing);
+    TEST_ASSERT_EQUAL(3, obs.smoothing_interval);
+
+    TEST_ASSERT_EQUAL(2, obs.satellite_count);
+    TEST_ASSERT_EQUAL(3, obs.satellite_id[0]);
+    TEST_ASSERT_EQUAL(40, obs.satellite_id[1]);
+    TEST_ASSERT_EQUAL(9, obs.satellite_info[0]);
+
+    TEST_ASSERT_EQUAL(3, obs.cell_count);
+    TEST_ASSERT_EQUAL(0, obs.cell_satellite[0]);
+    TEST_ASSERT_EQUAL(2, obs.signal_id[0]);
+    TEST_ASSERT_EQUAL(1, obs.cell_satellite[1]);
+    TEST_ASSERT_EQUAL(2, obs.signal_id[1]);
+    TEST_ASSERT_EQUAL(1, obs.cell_satellite[2]);
+    TEST_ASSERT_EQUAL(22, obs.signal_id[2]);
+
+    double rough = 70.5;
+    TEST_ASSERT_TRUE(fabs(obs.pseudorange[0] - (rough + 1.0 / 2048) * MS) < 1e-6);
+    TEST_ASSERT_TRUE(fabs(obs.phaserange[0] - (rough - 1.0 / 2048) * MS) < 1e-6);
+    TEST_ASSERT_TRUE(fabs(obs.phaserange_rate[0] - -1199.75) < 1e-9);
+    TEST_ASSERT_TRUE(obs.cnr[0] == 45.5f);
+    TEST_ASSERT_EQUAL(700, obs.lock_time[0]);
+    TEST_ASSERT_TRUE(obs.half_cycle[0]);
+
+    // Satellite 40 has neither a rough range nor a rough rate
+    TEST_ASSERT_TRUE(isnan(obs.pseudorange[1]));
+    TEST_ASSERT_TRUE(isnan(obs.phaserange[1]));
+    TEST_ASSERT_TRUE(isnan(obs.phaserange_rate[1]));
+    TEST_ASSERT_TRUE(isnan(obs.pseudorange[2]));
+    TEST_ASSERT_TRUE(isnan(obs.phaserange_rate[2]));
+    TEST_ASSERT_TRUE(obs.cnr[1] == 30.0f);
+    TEST_ASSERT_EQUAL(1023, obs.lock_time[2]);
+}
+
+void test_msm5_round_trip()
+{
+    BitWriter writer;
+    putHeader(writer, 1085, uint64_t(1) << 63, 1u << 30, 1, 1); // slot 1, signal 2
+    writer.put(68, 8);
+    writer.put(7 - 4, 4);   // frequency channel -4
+    writer.put(256, 10);
+    writer.put(-300 & 0x3FFF, 14);
+    writer.put(-16384 & 0x7FFF, 15); // invalid fine pseudorange
+    writer.put(1 << 20, 22);         // +2^-9 ms
+    writer.put(9, 4);
+    writer.put(0, 1);
+    writer.put(41, 6);
+    writer.put(-5000 & 0x7FFF, 15);  // -0.5 m/s
+
+    std::vector<uint8_t> frame = writer.frame();
+    GNSSMSMObservations obs;
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::decode(frame.data(), frame.size(), obs));
+
+    TEST_ASSERT_EQUAL(GNSSSystem::GLONASS, obs.system);
+    TEST_ASSERT_EQUAL(5, obs.msm_type);
+    TEST_ASSERT_EQUAL(1, obs.cell_count);
+    TEST_ASSERT_EQUAL(3, obs.satellite_info[0]);
+    TEST_ASSERT_TRUE(isnan(obs.pseudorange[0]));
+    TEST_ASSERT_TRUE(fabs(obs.phaserange[0] - (68.25 + 1.0 / 512) * MS) < 1e-6);
+    TEST_ASSERT_TRUE(fabs(obs.phaserange_rate[0] - -300.5) < 1e-9);
+    TEST_ASSERT_TRUE(obs.cnr[0] == 41.0f);
+    TEST_ASSERT_EQUAL(9, obs.lock_time[0]);
+
+    double frequency = GNSSMSMDecoder::carrierFrequency(obs.system, obs.signal_id[0], obs.satellite_info[0] - 7);
+    TEST_ASSERT_TRUE(frequency == 1602.0e6 - 4 * 0.5625e6);
+}
+
+void test_msm_rejects()
+{
+    GNSSMSMObservations obs;
+
+    // Not an MSM
+    BitWriter station;
+    station.put(1005, 12);
+    station.put(0, 140);
+    std::vector<uint8_t> frame = station.frame();
+    TEST_ASSERT_FALSE(GNSSMSMDecoder::decode(frame.data(), frame.size(), obs));
+
+    // MSM1 to MSM3 are not decoded
+    BitWriter compact;
+    putHeader(compact, 1073, uint64_t(1) << 63, 1u << 30, 1, 1);
+    frame = compact.frame();
+    TEST_ASSERT_FALSE(GNSSMSMDecoder::decode(frame.data(), frame.size(), obs));
+
+    // More than 64 cells
+    BitWriter crowded;
+    putHeader(crowded, 1074, 0xFFFFF, 0xF, 0, 0);
+    crowded.put(0, 128);
+    frame = crowded.frame();
+    TEST_ASSERT_FALSE(GNSSMSMDecoder::decode(frame.data(), frame.size(), obs));
+
+    // Payload ending inside the signal data
+    BitWriter truncated;
+    putHeader(truncated, 1074, uint64_t(1) << 63, 1u << 30, 1, 1);
+    truncated.put(70, 8);
+    truncated.put(0, 10);
+    truncated.put(0, 15);
+    frame = truncated.frame();
+    TEST_ASSERT_FALSE(GNSSMSMDecoder::decode(frame.data(), frame.size(), obs));
+
+    // Frame shorter than its length field says
+    std::vector<std::vector<uint8_t>> frames = captureFrames("test/test-data/test-data-56-5.bin");
+    TEST_ASSERT_FALSE(GNSSMSMDecoder::decode(frames[0].data(), frames[0].size() - 4, obs));
+}
+
+void test_msm_from_split_view()
+{
+    std::vector<std::vector<uint8_t>> frames = captureFrames("test/test-data/test-data-656-43.bin");
+    const std::vector<uint8_t> &frame = frames[0];
+
+    GNSSMSMObservations whole;
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::decode(frame.data(), frame.size(), whole));
+
+    GNSSParserBase::MessageView view = {GNSSParserBase::Message::Type::RTCM3,
+                                        frame.data(), 40,
+                                        frame.data() + 40, frame.size() - 40};
+    GNSSMSMObservations split;
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::decode(view, split));
+    TEST_ASSERT_EQUAL(whole.cell_count, split.cell_count);
+    TEST_ASSERT_EQUAL_MEMORY(whole.pseudorange, split.pseudorange, whole.cell_count * sizeof(double));
+    TEST_ASSERT_EQUAL_MEMORY(whole.signal_id, split.signal_id, whole.cell_count);
+}
+
+void test_carrier_frequencies()
+{
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::carrierFrequency(GNSSSystem::GPS, 2) == 1575.42e6);
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::carrierFrequency(GNSSSystem::GPS, 15) == 1227.60e6);
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::carrierFrequency(GNSSSystem::GALILEO, 15) == 1207.14e6);
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::carrierFrequency(GNSSSystem::GALILEO, 23) == 1176.45e6);
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::carrierFrequency(GNSSSystem::BEIDOU, 2) == 1561.098e6);
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::carrierFrequency(GNSSSystem::GLONASS, 8, 6) == 1246.0e6 + 6 * 0.4375e6);
+    TEST_ASSERT_TRUE(GNSSMSMDecoder::carrierFrequency(GNSSSystem::GPS, 1) == 0);
+}
+
+void register_msm_tests()
+{
+    RUN_TEST(test_msm4_from_capture);
+    RUN_TEST(test_msm_totals_over_captures);
+    RUN_TEST(test_msm7_round_trip);
+    RUN_TEST(test_msm5_round_trip);
+    RUN_TEST(test_msm_rejects);
+    RUN_TEST(test_msm_from_split_view);
+    RUN_TEST(test_carrier_frequencies);
+}
@@ -0,0 +1,6 @@
+#ifndef __TEST_MSM_H__
+#define __TEST_MSM_H__
+
+void register_msm_tests();
+
+#endif // __TEST_MSM_H__
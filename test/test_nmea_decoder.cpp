@@ -0,0 +1,249 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "GNSSNMEA.h"
+
+static const char *GGA = "$GNGGA,140656.00,4430.39666339,N,02600.98986769,E,7,17,1.0,89.7706,M,35.4899,M,,*42\r\n";
+static const char *RMC = "$GNRMC,140656.00,A,4430.39666339,N,02600.98986769,E,0.006,221.9,070125,6.1,E,M,S*5C\r\n";
+static const char *GSA = "$GNGSA,M,3,24,28,29,31,32,,,,,,,,1.5,1.0,1.1,1*3C\r\n";
+static const char *VTG = "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K,A*25\r\n";
+static const char *GST = "$GPGST,172814.0,0.006,0.023,0.020,273.6,0.023,0.020,0.031*6A\r\n";
+
+// Sentence body with its checksum and line end
+static std::string sentence(const char *body)
+{
+    uint8_t checksum = 0;
+    for (const char *c = body + 1; *c; c++)
+        checksum ^= static_cast<uint8_t>(*c);
+    char tail[8];
+    snprintf(tail, sizeof(tail), "*%02X\r\n", checksum);
+    return std::string(body) + tail;
+}
+
+static bool field_is(const GNSSNMEAFields &fields, size_t index, const char *expected)
+{
+    GNSSNMEAField f = fields.field(index);
+    return f.length == strlen(expected) && memcmp(f.data, expected, f.length) == 0;
+}
+
+void test_nmea_fields_split()
+{
+    GNSSNMEAFields fields(GSA, strlen(GSA));
+    TEST_ASSERT_EQUAL(19, fields.count());
+    TEST_ASSERT_TRUE(field_is(fields, 0, "GNGSA"));
+    TEST_ASSERT_TRUE(field_is(fields, 1, "M"));
+    TEST_ASSERT_TRUE(field_is(fields, 7, "32"));
+    TEST_ASSERT_TRUE(fields.field(8).empty());
+    TEST_ASSERT_TRUE(fields.field(14).empty());
+    TEST_ASSERT_TRUE(field_is(fields, 15, "1.5"));
+    TEST_ASSERT_TRUE(field_is(fields, 18, "1")); // checksum left out
+    TEST_ASSERT_TRUE(fields.field(19).empty());
+    TEST_ASSERT_TRUE(fields.is("GSA"));
+    TEST_ASSERT_FALSE(fields.is("GGA"));
+
+    // Fields point into the sentence
+    TEST_ASSERT_TRUE(fields.field(0).data == GSA + 1);
+
+    // No checksum, no line end, trailing empty field
+    const char *bare = "$GPGLL,4916.45,N,12311.12,W,225444,A,";
+    GNSSNMEAFields partial(bare, strlen(bare));
+    TEST_ASSERT_EQUAL(8, partial.count());
+    TEST_ASSERT_TRUE(partial.field(7).empty());
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, -(123 + 11.12 / 60), partial.coordinate(3));
+
+    // Fields past MAX_FIELDS are dropped
+    std::string many = "$GPXXX";
+    for (size_t i = 0; i < 80; i++)
+        many += ",7";
+    GNSSNMEAFields truncated(many.c_str(), many.size());
+    TEST_ASSERT_EQUAL(GNSSNMEAFields::MAX_FIELDS, truncated.count());
+    TEST_ASSERT_TRUE(field_is(truncated, GNSSNMEAFields::MAX_FIELDS - 1, "7"));
+}
+
+void test_nmea_number_parsing()
+{
+    // Same double as strtod for the digits NMEA sends
+    uint32_t state = 12345;
+    char text[32];
+    for (size_t n = 0; n < 20000; n++)
+    {
+        size_t length = 0;
+        state = state * 1664525u + 1013904223u;
+        if (state >> 31)
+            text[length++] = '-';
+        size_t digits = 1 + (state >> 8) % 15;
+        size_t point = (state >> 16) % (digits + 1);
+        for (size_t i = 0; i < digits; i++)
+        {
+            if (i == point && i)
+                text[length++] = '.';
+            state = state * 1664525u + 1013904223u;
+            text[length++] = static_cast<char>('0' + (state >> 24) % 10);
+        }
+        text[length] = '\0';
+
+        double value = 0;
+        TEST_ASSERT_TRUE(GNSSNMEAFields::parseNumber(text, length, value));
+        double expected = strtod(text, nullptr);
+        TEST_ASSERT_TRUE_MESSAGE(memcmp(&value, &expected, sizeof(value)) == 0, text);
+    }
+
+    double value = 0;
+    TEST_ASSERT_TRUE(GNSSNMEAFields::parseNumber(".5", 2, value));
+    TEST_ASSERT_DOUBLE_WITHIN(0, 0.5, value);
+    TEST_ASSERT_TRUE(GNSSNMEAFields::parseNumber("+5.", 3, value));
+    TEST_ASSERT_DOUBLE_WITHIN(0, 5.0, value);
+    TEST_ASSERT_TRUE(GNSSNMEAFields::parseNumber("00000000000000000000012.50", 26, value));
+    TEST_ASSERT_DOUBLE_WITHIN(0, 12.5, value);
+
+    const char *invalid[] = {"", "-", ".", "-.", "1.2.3", "1e5", " 1", "1,", "0x10", "N"};
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    {
+        value = 42;
+        TEST_ASSERT_FALSE_MESSAGE(GNSSNMEAFields::parseNumber(invalid[i], strlen(invalid[i]), value), invalid[i]);
+        TEST_ASSERT_DOUBLE_WITHIN(0, 42, value);
+    }
+
+    uint32_t integer = 0;
+    TEST_ASSERT_TRUE(GNSSNMEAFields::parseInteger("08", 2, integer));
+    TEST_ASSERT_EQUAL_UINT32(8, integer);
+    TEST_ASSERT_FALSE(GNSSNMEAFields::parseInteger("8.0", 3, integer));
+    TEST_ASSERT_FALSE(GNSSNMEAFields::parseInteger("", 0, integer));
+
+    double degrees = 0;
+    TEST_ASSERT_TRUE(GNSSNMEAFields::parseCoordinate("4430.39666339", 13, 'N', degrees));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 44 + 30.39666339 / 60, degrees);
+    TEST_ASSERT_TRUE(GNSSNMEAFields::parseCoordinate("02600.98986769", 14, 'W', degrees));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, -(26 + 0.98986769 / 60), degrees);
+    TEST_ASSERT_TRUE(GNSSNMEAFields::parseCoordinate("3345", 4, 'S', degrees));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, -33.75, degrees);
+    TEST_ASSERT_FALSE(GNSSNMEAFields::parseCoordinate("4430.3966", 9, '\0', degrees));
+    TEST_ASSERT_FALSE(GNSSNMEAFields::parseCoordinate("", 0, 'N', degrees));
+
+    double seconds = 0;
+    TEST_ASSERT_TRUE(GNSSNMEAFields::parseTime("235959.995", 10, seconds));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 86399.995, seconds);
+    TEST_ASSERT_TRUE(GNSSNMEAFields::parseTime("123519", 6, seconds));
+    TEST_ASSERT_DOUBLE_WITHIN(0, 45319, seconds);
+    TEST_ASSERT_FALSE(GNSSNMEAFields::parseTime("12351", 5, seconds));
+    TEST_ASSERT_FALSE(GNSSNMEAFields::parseTime("126019", 6, seconds));
+}
+
+void test_nmea_decode_gga_rmc()
+{
+    GNSSNMEAGGA gga;
+    TEST_ASSERT_TRUE(GNSSNMEADecoder::decode(GNSSNMEAFields(GGA, strlen(GGA)), gga));
+    TEST_ASSERT_DOUBLE_WITHIN(0, 14 * 3600 + 6 * 60 + 56, gga.time);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 44 + 30.39666339 / 60, gga.latitude);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 26 + 0.98986769 / 60, gga.longitude);
+    TEST_ASSERT_EQUAL(7, gga.quality);
+    TEST_ASSERT_EQUAL(17, gga.satellites);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 1.0, gga.hdop);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 89.7706, gga.altitude);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 35.4899, gga.geoid_separation);
+    TEST_ASSERT_TRUE(isnan(gga.correction_age));
+    TEST_ASSERT_EQUAL(0, gga.reference_station);
+
+    // No fix: empty position
+    std::string empty = sentence("$GPGGA,002153.000,,,,,0,00,,,M,,M,,");
+    TEST_ASSERT_TRUE(GNSSNMEADecoder::decode(GNSSNMEAFields(empty.c_str(), empty.size()), gga));
+    TEST_ASSERT_DOUBLE_WITHIN(0, 1313, gga.time);
+    TEST_ASSERT_TRUE(isnan(gga.latitude));
+    TEST_ASSERT_TRUE(isnan(gga.altitude));
+    TEST_ASSERT_EQUAL(0, gga.quality);
+
+    GNSSNMEARMC rmc;
+    GNSSNMEAFields fields(RMC, strlen(RMC));
+    TEST_ASSERT_TRUE(GNSSNMEADecoder::decode(fields, rmc));
+    TEST_ASSERT_TRUE(rmc.valid);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 50816, rmc.time);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 44 + 30.39666339 / 60, rmc.latitude);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 0.006, rmc.speed);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 221.9, rmc.course);
+    TEST_ASSERT_EQUAL(7, rmc.day);
+    TEST_ASSERT_EQUAL(1, rmc.month);
+    TEST_ASSERT_EQUAL(2025, rmc.year);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 6.1, rmc.magnetic_variation);
+    TEST_ASSERT_EQUAL('M', rmc.mode);
+    TEST_ASSERT_EQUAL('S', rmc.nav_status);
+
+    // Another sentence leaves the output untouched
+    TEST_ASSERT_FALSE(GNSSNMEADecoder::decode(fields, gga));
+    TEST_ASSERT_DOUBLE_WITHIN(0, 1313, gga.time);
+}
+
+void test_nmea_decode_gsa_vtg_gst()
+{
+    GNSSNMEAGSA gsa;
+    TEST_ASSERT_TRUE(GNSSNMEADecoder::decode(GNSSNMEAFields(GSA, strlen(GSA)), gsa));
+    TEST_ASSERT_EQUAL('M', gsa.selection);
+    TEST_ASSERT_EQUAL(3, gsa.fix);
+    TEST_ASSERT_EQUAL(5, gsa.satellite_count);
+    uint16_t used[] = {24, 28, 29, 31, 32};
+    for (size_t i = 0; i < 5; i++)
+        TEST_ASSERT_EQUAL_UINT16(used[i], gsa.satellites[i]);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 1.5, gsa.pdop);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 1.0, gsa.hdop);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 1.1, gsa.vdop);
+    TEST_ASSERT_EQUAL(1, gsa.system_id);
+
+    GNSSNMEAVTG vtg;
+    TEST_ASSERT_TRUE(GNSSNMEADecoder::decode(GNSSNMEAFields(VTG, strlen(VTG)), vtg));
+    TEST_ASSERT_DOUBLE_WITHIN(0, 54.7, vtg.course);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 34.4, vtg.magnetic_course);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 5.5, vtg.speed_knots);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 10.2, vtg.speed_kmh);
+    TEST_ASSERT_EQUAL('A', vtg.mode);
+
+    GNSSNMEAGST gst;
+    TEST_ASSERT_TRUE(GNSSNMEADecoder::decode(GNSSNMEAFields(GST, strlen(GST)), gst));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 62894.0, gst.time);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 0.006, gst.rms);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 0.023, gst.semi_major);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 0.020, gst.semi_minor);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 273.6, gst.orientation);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 0.023, gst.latitude_sigma);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 0.020, gst.longitude_sigma);
+    TEST_ASSERT_DOUBLE_WITHIN(0, 0.031, gst.altitude_sigma);
+}
+
+void test_nmea_fields_wrapped_view()
+{
+    size_t length = strlen(GGA);
+    GNSSNMEAGGA expected;
+    memset(&expected, 0, sizeof(expected)); // padding, compared below
+    GNSSNMEADecoder::decode(GNSSNMEAFields(GGA, length), expected);
+
+    // The sentence wraps around the end of the parser's ring at every offset
+    size_t wrapped = 0;
+    for (size_t padding = 1; padding < length; padding++)
+    {
+        BasicGNSSParser<128, 8> parser;
+        std::vector<uint8_t> filler(128 - padding, 0);
+        parser.encode(filler.data(), filler.size());
+        parser.encode(reinterpret_cast<const uint8_t *>(GGA), length);
+        GNSSParserBase::MessageView view = parser.peekMessage();
+        TEST_ASSERT_EQUAL(GNSSParserBase::Message::Type::NMEA, view.type);
+        wrapped += view.second != nullptr;
+
+        GNSSNMEAGGA gga;
+        memset(&gga, 0, sizeof(gga));
+        TEST_ASSERT_TRUE(GNSSNMEADecoder::decode(GNSSNMEAFields(view), gga));
+        TEST_ASSERT_EQUAL_MEMORY(&expected, &gga, sizeof(gga));
+        parser.release();
+    }
+    TEST_ASSERT_TRUE(wrapped > 0);
+}
+
+void register_nmea_decoder_tests()
+{
+    RUN_TEST(test_nmea_fields_split);
+    RUN_TEST(test_nmea_number_parsing);
+    RUN_TEST(test_nmea_decode_gga_rmc);
+    RUN_TEST(test_nmea_decode_gsa_vtg_gst);
+    RUN_TEST(test_nmea_fields_wrapped_view);
+}
@@ -0,0 +1,6 @@
+#ifndef __TEST_NMEA_DECODER_H__
+#define __TEST_NMEA_DECODER_H__
+
+void register_nmea_decoder_tests();
+
+#endif // __TEST_NMEA_DECODER_H__
@@ -0,0 +1,97 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "GNSSParser.h"
+
+static const char *SENTENCE = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+
+template <class Parser>
+static void countMessages(const char *path, size_t &nmea, size_t &rtcm)
+{
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    Parser parser;
+    uint8_t chunk[100];
+    size_t read;
+    nmea = 0;
+    rtcm = 0;
+
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        TEST_ASSERT_TRUE(parser.encode(chunk, read));
+
+        while (parser.available())
+        {
+            typename Parser::Message msg = parser.getMessage();
+            if (msg.type == Parser::Message::Type::NMEA)
+                nmea++;
+            else if (msg.type == Parser::Message::Type::RTCM3)
+                rtcm++;
+        }
+    }
+
+    fclose(file);
+}
+
+void test_full_ring_has_no_space()
+{
+    size_t length = strlen(SENTENCE);
+    BasicGNSSParser<134, 4> parser;
+
+    TEST_ASSERT_TRUE(parser.encode((const uint8_t *)SENTENCE, length));
+    TEST_ASSERT_TRUE(parser.encode((const uint8_t *)SENTENCE, length));
+
+    // Both queued sentences fill the ring exactly
+    TEST_ASSERT_EQUAL(0, parser.available_write_space());
+    TEST_ASSERT_FALSE(parser.encode('$'));
+
+    parser.release();
+    TEST_ASSERT_EQUAL(length, parser.available_write_space());
+}
+
+void test_non_power_of_two_buffer()
+{
+    size_t nmea, rtcm;
+    countMessages<BasicGNSSParser<1500, 32>>("test/test-data/test-data-656-43.bin", nmea, rtcm);
+
+    TEST_ASSERT_EQUAL(656, nmea);
+    TEST_ASSERT_EQUAL(43, rtcm);
+}
+
+void test_single_protocol_parsers()
+{
+    size_t nmea, rtcm;
+
+    countMessages<BasicGNSSParser<4096, 128, GNSSProtocol::NMEA>>("test/test-data/test-data-656-43.bin", nmea, rtcm);
+    TEST_ASSERT_EQUAL(656, nmea);
+    TEST_ASSERT_EQUAL(0, rtcm);
+
+    countMessages<BasicGNSSParser<2048, 128, GNSSProtocol::RTCM3>>("test/test-data/test-data-656-43.bin", nmea, rtcm);
+    TEST_ASSERT_EQUAL(0, nmea);
+    TEST_ASSERT_EQUAL(43, rtcm);
+}
+
+void test_rtcm3_frame_longer_than_buffer()
+{
+    // Header announcing a 1023 byte payload, which a 256 byte ring can never hold
+    const uint8_t header[] = {0xD3, 0x03, 0xFF};
+    typedef BasicGNSSParser<256, 8> SmallParser;
+    SmallParser parser;
+
+    TEST_ASSERT_EQUAL(256, SmallParser::MAX_MESSAGE_LENGTH);
+    TEST_ASSERT_TRUE(parser.encode(header, sizeof(header)));
+    TEST_ASSERT_TRUE(parser.encode((const uint8_t *)SENTENCE, strlen(SENTENCE)));
+
+    GNSSParser::Message msg = parser.getMessage();
+    TEST_ASSERT_EQUAL(GNSSParser::Message::Type::NMEA, msg.type);
+    TEST_ASSERT_EQUAL(strlen(SENTENCE), msg.length);
+}
+
+void register_parser_config_tests()
+{
+    RUN_TEST(test_full_ring_has_no_space);
+    RUN_TEST(test_non_power_of_two_buffer);
+    RUN_TEST(test_single_protocol_parsers);
+    RUN_TEST(test_rtcm3_frame_longer_than_buffer);
+}
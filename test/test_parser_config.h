@@ -0,0 +1,6 @@
+#ifndef __TEST_PARSER_CONFIG_H__
+#define __TEST_PARSER_CONFIG_H__
+
+void register_parser_config_tests();
+
+#endif // __TEST_PARSER_CONFIG_H__
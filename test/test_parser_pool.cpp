@@ -0,0 +1,145 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if !defined(ARDUINO)
+#include <vector>
+#include "GNSSParserPool.h"
+
+static const char *CAPTURES[] = {
+    "test/test-data/test-data-5-2.bin",
+    "test/test-data/test-data-56-5.bin",
+    "test/test-data/test-data-656-43.bin",
+    "test/test-data/test-data-33816-2193.bin",
+};
+
+static uint32_t fnv1a(const uint8_t *data, size_t length, uint32_t hash = 2166136261u)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static std::vector<uint8_t> loadFile(const char *path)
+{
+    std::vector<uint8_t> data;
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    fclose(file);
+    return data;
+}
+
+// Hash of one frame, folded into the running hash of its stream
+static uint32_t foldFrame(uint32_t hash, const GNSSParserBase::MessageView &view, bool valid)
+{
+    uint8_t header[2] = {static_cast<uint8_t>(view.type), valid};
+    hash = fnv1a(header, sizeof(header), hash);
+    hash = fnv1a(view.first, view.first_length, hash);
+    return fnv1a(view.second, view.second_length, hash);
+}
+
+struct StreamResult
+{
+    uint32_t hash;
+    size_t frames;
+};
+
+struct RecordingSink
+{
+    std::vector<StreamResult> *results;
+
+    void operator()(size_t stream_id, const GNSSParserBase::MessageView &view, bool valid) const
+    {
+        StreamResult &result = (*results)[stream_id];
+        result.hash = foldFrame(result.hash, view, valid);
+        result.frames++;
+    }
+};
+
+void test_pool_preserves_stream_order()
+{
+    const size_t streams = 24;
+    std::vector<std::vector<uint8_t>> captures;
+    std::vector<StreamResult> expected;
+
+    for (const char *capture : CAPTURES)
+    {
+        captures.push_back(loadFile(capture));
+
+        GNSSParser parser;
+        StreamResult result = {2166136261u, 0};
+        parser.encode_to(captures.back().data(), captures.back().size(), [&](const GNSSParserBase::MessageView &view, bool valid)
+                         {
+                             result.hash = foldFrame(result.hash, view, valid);
+                             result.frames++;
+                         });
+        expected.push_back(result);
+    }
+
+    std::vector<StreamResult> results(streams, StreamResult{2166136261u, 0});
+    RecordingSink sink = {&results};
+    GNSSParserPool<RecordingSink> pool(streams, sink, 4);
+
+    // Interleave batches of random size across all streams
+    std::vector<size_t> offsets(streams, 0);
+    srand(42);
+    bool remaining = true;
+    while (remaining)
+    {
+        remaining = false;
+        for (size_t id = 0; id < streams; id++)
+        {
+            const std::vector<uint8_t> &capture = captures[id % captures.size()];
+            size_t length = std::min<size_t>(1 + rand() % 2000, capture.size() - offsets[id]);
+            if (length == 0)
+                continue;
+
+            pool.submit(id, &capture[offsets[id]], length);
+            offsets[id] += length;
+            remaining = true;
+        }
+    }
+
+    pool.wait();
+
+    for (size_t id = 0; id < streams; id++)
+    {
+        TEST_ASSERT_EQUAL(expected[id % captures.size()].frames, results[id].frames);
+        TEST_ASSERT_EQUAL_HEX32(expected[id % captures.size()].hash, results[id].hash);
+    }
+}
+
+void test_pool_wait_with_nothing_submitted()
+{
+    std::vector<StreamResult> results(2, StreamResult{2166136261u, 0});
+    RecordingSink sink = {&results};
+    GNSSParserPool<RecordingSink> pool(2, sink, 2);
+
+    pool.wait();
+    TEST_ASSERT_EQUAL(2, pool.streams());
+    TEST_ASSERT_EQUAL(2, pool.workers());
+    TEST_ASSERT_EQUAL(0, results[0].frames);
+}
+
+void register_parser_pool_tests()
+{
+    RUN_TEST(test_pool_preserves_stream_order);
+    RUN_TEST(test_pool_wait_with_nothing_submitted);
+}
+
+#else
+
+void register_parser_pool_tests()
+{
+}
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef __TEST_PARSER_POOL_H__
+#define __TEST_PARSER_POOL_H__
+
+void register_parser_pool_tests();
+
+#endif // __TEST_PARSER_POOL_H__
@@ -0,0 +1,135 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "GNSSParser.h"
+
+#if GNSS_PARSER_STATS
+
+static const char *SENTENCE = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+
+static std::vector<uint8_t> loadCapture(const char *path)
+{
+    std::vector<uint8_t> data;
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    int c;
+    while ((c = fgetc(file)) != EOF)
+        data.push_back(static_cast<uint8_t>(c));
+
+    fclose(file);
+    return data;
+}
+
+void test_stats_count_capture_frames()
+{
+    std::vector<uint8_t> data = loadCapture("test/test-data/test-data-656-43.bin");
+
+    GNSSParser parser;
+    size_t nmea = 0, rtcm = 0, bad_nmea = 0, bad_rtcm = 0, frame_bytes = 0;
+    parser.encode_to(data.data(), data.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                     {
+                         bool is_nmea = view.type == GNSSParser::Message::Type::NMEA;
+                         if (valid)
+                         {
+                             (is_nmea ? nmea : rtcm)++;
+                             frame_bytes += view.length();
+                         }
+                         else
+                         {
+                             (is_nmea ? bad_nmea : bad_rtcm)++;
+                         }
+                     });
+
+    GNSSParser::Stats stats = parser.stats();
+    TEST_ASSERT_EQUAL(656, stats.nmea_frames);
+    TEST_ASSERT_EQUAL(43, stats.rtcm3_frames);
+    TEST_ASSERT_EQUAL(nmea, stats.nmea_frames);
+    TEST_ASSERT_EQUAL(rtcm, stats.rtcm3_frames);
+    TEST_ASSERT_EQUAL(bad_nmea, stats.checksum_failures);
+    TEST_ASSERT_EQUAL(bad_rtcm, stats.crc_failures);
+    TEST_ASSERT_EQUAL(data.size(), stats.bytes_scanned);
+
+    // Everything else was skipped, apart from a candidate cut off at the end
+    TEST_ASSERT_TRUE(frame_bytes + stats.bytes_skipped <= data.size());
+    TEST_ASSERT_TRUE(data.size() - frame_bytes - stats.bytes_skipped < GNSSParser::MAX_RTCM3_LENGTH);
+}
+
+void test_stats_count_failures()
+{
+    GNSSParser parser;
+
+    // Wrong checksum
+    const char *bad_sentence = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48\r\n";
+    parser.encode((const uint8_t *)bad_sentence, strlen(bad_sentence));
+
+    // RTCM3 frame with a broken CRC
+    const uint8_t bad_frame[] = {0xD3, 0x00, 0x02, 0x3E, 0xD0, 0x00, 0x00, 0x00};
+    parser.encode(bad_frame, sizeof(bad_frame));
+
+    // A '$' never followed by a line end
+    std::vector<uint8_t> endless(1, '$');
+    endless.resize(GNSSParser::MAX_NMEA_LENGTH + 8, 'A');
+    parser.encode(endless.data(), endless.size());
+
+    GNSSParser::Stats stats = parser.stats();
+    TEST_ASSERT_EQUAL(1, stats.checksum_failures);
+    TEST_ASSERT_EQUAL(1, stats.crc_failures);
+    TEST_ASSERT_EQUAL(1, stats.invalid_lengths);
+    TEST_ASSERT_EQUAL(0, stats.nmea_frames);
+    TEST_ASSERT_EQUAL(0, stats.rtcm3_frames);
+    TEST_ASSERT_EQUAL(strlen(bad_sentence) + sizeof(bad_frame) + endless.size(), stats.bytes_scanned);
+    TEST_ASSERT_EQUAL(stats.bytes_scanned, stats.bytes_skipped);
+}
+
+void test_stats_count_drops_and_rejections()
+{
+    size_t length = strlen(SENTENCE);
+    BasicGNSSParser<1024, 2> parser;
+
+    for (int i = 0; i < 3; i++)
+        TEST_ASSERT_TRUE(parser.encode((const uint8_t *)SENTENCE, length));
+
+    std::vector<uint8_t> too_long(1025, 'A');
+    TEST_ASSERT_FALSE(parser.encode(too_long.data(), too_long.size()));
+
+    BasicGNSSParser<1024, 2>::Stats stats = parser.stats();
+    TEST_ASSERT_EQUAL(3, stats.nmea_frames);
+    TEST_ASSERT_EQUAL(1, stats.queue_drops);
+    TEST_ASSERT_EQUAL(parser.dropped(), stats.queue_drops);
+    TEST_ASSERT_EQUAL(1, stats.write_rejections);
+
+    parser.resetStats();
+    stats = parser.stats();
+    TEST_ASSERT_EQUAL(0, stats.nmea_frames);
+    TEST_ASSERT_EQUAL(0, stats.queue_drops);
+    TEST_ASSERT_EQUAL(0, stats.bytes_scanned);
+}
+
+void register_parser_stats_tests()
+{
+    RUN_TEST(test_stats_count_capture_frames);
+    RUN_TEST(test_stats_count_failures);
+    RUN_TEST(test_stats_count_drops_and_rejections);
+}
+
+#else
+
+void test_stats_disabled()
+{
+    GNSSParser parser;
+    const char *sentence = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+    parser.encode((const uint8_t *)sentence, strlen(sentence));
+
+    GNSSParser::Stats stats = parser.stats();
+    TEST_ASSERT_EQUAL(0, stats.bytes_scanned);
+    TEST_ASSERT_EQUAL(0, stats.nmea_frames);
+}
+
+void register_parser_stats_tests()
+{
+    RUN_TEST(test_stats_disabled);
+}
+
+#endif
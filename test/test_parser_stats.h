@@ -0,0 +1,6 @@
+#ifndef __TEST_PARSER_STATS_H__
+#define __TEST_PARSER_STATS_H__
+
+void register_parser_stats_tests();
+
+#endif // __TEST_PARSER_STATS_H__
@@ -0,0 +1,89 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "GNSSParser.h"
+
+static const char *SENTENCE = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+static const char *BAD_SENTENCE = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48\r\n";
+
+struct Counts
+{
+    size_t nmea;
+    size_t rtcm;
+    size_t invalid;
+};
+
+static void countMessage(void *user, const GNSSParser::MessageView *view, bool valid)
+{
+    Counts *counts = static_cast<Counts *>(user);
+    if (!valid)
+        counts->invalid++;
+    else if (view->type == GNSSParser::Message::Type::NMEA)
+        counts->nmea++;
+    else if (view->type == GNSSParser::Message::Type::RTCM3)
+        counts->rtcm++;
+}
+
+void test_sink_receives_frames_in_place()
+{
+    GNSSParser parser;
+    size_t length = strlen(SENTENCE);
+    size_t frames = 0;
+
+    size_t consumed = parser.encode_to((const uint8_t *)SENTENCE, length, [&](const GNSSParser::MessageView &view, bool valid)
+                                       {
+                                           TEST_ASSERT_TRUE(valid);
+                                           TEST_ASSERT_EQUAL(GNSSParser::Message::Type::NMEA, view.type);
+                                           TEST_ASSERT_EQUAL(length, view.length());
+                                           TEST_ASSERT_EQUAL_MEMORY(SENTENCE, view.first, length);
+                                           frames++;
+                                       });
+
+    TEST_ASSERT_EQUAL(length, consumed);
+    TEST_ASSERT_EQUAL(1, frames);
+    TEST_ASSERT_FALSE(parser.available());
+    TEST_ASSERT_EQUAL(GNSSParser::BUFFER_SIZE, parser.available_write_space());
+}
+
+void test_sink_receives_invalid_frames()
+{
+    GNSSParser parser;
+    Counts counts = {0, 0, 0};
+
+    parser.encode_to((const uint8_t *)BAD_SENTENCE, strlen(BAD_SENTENCE), countMessage, &counts);
+    parser.encode_to((const uint8_t *)SENTENCE, strlen(SENTENCE), countMessage, &counts);
+
+    TEST_ASSERT_EQUAL(1, counts.invalid);
+    TEST_ASSERT_EQUAL(1, counts.nmea);
+}
+
+void test_callback_over_capture()
+{
+    FILE *file = fopen("test/test-data/test-data-33816-2193.bin", "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    fclose(file);
+
+    GNSSParser parser;
+    Counts counts = {0, 0, 0};
+
+    TEST_ASSERT_EQUAL(data.size(), parser.encode_to(data.data(), data.size(), countMessage, &counts));
+    TEST_ASSERT_EQUAL(33816, counts.nmea);
+    TEST_ASSERT_EQUAL(2193, counts.rtcm);
+    TEST_ASSERT_FALSE(parser.available());
+}
+
+void register_push_sink_tests()
+{
+    RUN_TEST(test_sink_receives_frames_in_place);
+    RUN_TEST(test_sink_receives_invalid_frames);
+    RUN_TEST(test_callback_over_capture);
+}
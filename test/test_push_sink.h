@@ -0,0 +1,6 @@
+#ifndef __TEST_PUSH_SINK_H__
+#define __TEST_PUSH_SINK_H__
+
+void register_push_sink_tests();
+
+#endif // __TEST_PUSH_SINK_H__
@@ -0,0 +1,212 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "GNSSBitReader.h"
+#include "GNSSRTCM3.h"
+
+// Bit by bit, the obvious way
+static uint64_t referenceField(const uint8_t *data, size_t length, size_t bit, unsigned count)
+{
+    uint64_t value = 0;
+    for (unsigned i = 0; i < count; i++)
+    {
+        size_t b = bit + i;
+        value = (value << 1) | (b / 8 < length ? (data[b / 8] >> (7 - b % 8)) & 1 : 0);
+    }
+    return value;
+}
+
+// Builds a frame whose payload starts with the given fields
+static std::vector<uint8_t> makeFrame(const uint64_t *values, const unsigned *widths, size_t fields, size_t payload_length)
+{
+    std::vector<uint8_t> frame(3 + payload_length + 3, 0);
+    frame[0] = 0xD3;
+    frame[1] = payload_length >> 8;
+    frame[2] = payload_length & 0xFF;
+
+    size_t bit = 0;
+    for (size_t f = 0; f < fields; f++)
+    {
+        for (unsigned i = 0; i < widths[f]; i++, bit++)
+        {
+            if ((values[f] >> (widths[f] - 1 - i)) & 1)
+                frame[3 + bit / 8] |= 0x80 >> (bit % 8);
+        }
+    }
+
+    uint32_t crc = GNSSCRC24Q::calculate(frame.data(), 3 + payload_length);
+    frame[3 + payload_length] = crc >> 16;
+    frame[4 + payload_length] = crc >> 8;
+    frame[5 + payload_length] = crc;
+    return frame;
+}
+
+void test_bit_reader_fields()
+{
+    const uint8_t data[] = {0xD3, 0x00, 0x13, 0x3E, 0xD0, 0x07, 0xFF, 0x80, 0x01};
+    GNSSBitReader reader(data, sizeof(data));
+
+    TEST_ASSERT_EQUAL_HEX32(0xD3, reader.read(8));
+    TEST_ASSERT_EQUAL_HEX32(0x00, reader.read(6));
+    TEST_ASSERT_EQUAL_HEX32(0x013, reader.read(10));
+    TEST_ASSERT_EQUAL(1005, reader.read(12));
+    TEST_ASSERT_EQUAL(7, reader.read(12));
+    TEST_ASSERT_EQUAL(-1, reader.readSigned(8));
+    TEST_ASSERT_TRUE(reader.readBit());
+    TEST_ASSERT_EQUAL(1, reader.read(15));
+    TEST_ASSERT_EQUAL(0, reader.remaining());
+    TEST_ASSERT_FALSE(reader.overflow());
+
+    // Past the end: zeros and the overflow flag
+    TEST_ASSERT_EQUAL(0, reader.read(4));
+    TEST_ASSERT_TRUE(reader.overflow());
+}
+
+void test_bit_reader_matches_reference()
+{
+    uint8_t data[64];
+    srand(16);
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = rand() & 0xFF;
+
+    for (size_t bit = 0; bit < sizeof(data) * 8; bit += 3)
+    {
+        for (unsigned count = 0; count <= 64; count++)
+        {
+            uint64_t expected = referenceField(data, sizeof(data), bit, count);
+            if (GNSSBitReader::get(data, sizeof(data), bit, count) != expected)
+            {
+                char message[64];
+                snprintf(message, sizeof(message), "bit %u count %u", (unsigned)bit, count);
+                TEST_FAIL_MESSAGE(message);
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL(-2, GNSSBitReader::signExtend(0x3FFFFFFFFEull, 38));
+    TEST_ASSERT_EQUAL(0x1FFFFFFFFFll, GNSSBitReader::signExtend(0x1FFFFFFFFFull, 38));
+}
+
+void test_header_of_capture_frames()
+{
+    FILE *file = fopen("test/test-data/test-data-656-43.bin", "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    GNSSParser parser;
+    std::vector<GNSSRTCM3Header> headers;
+    uint8_t chunk[100];
+    size_t read;
+
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        TEST_ASSERT_TRUE(parser.encode(chunk, read));
+        while (parser.available())
+        {
+            GNSSParser::MessageView view = parser.peekMessage();
+            if (view.type == GNSSParser::Message::Type::RTCM3)
+                headers.push_back(GNSSRTCM3Header(view));
+            parser.release();
+        }
+    }
+    fclose(file);
+
+    TEST_ASSERT_EQUAL(43, headers.size());
+
+    // Galileo MSM4, more MSMs of the epoch to follow
+    TEST_ASSERT_EQUAL(1094, headers[0].messageNumber());
+    TEST_ASSERT_EQUAL(154, headers[0].payloadLength());
+    TEST_ASSERT_TRUE(headers[0].isMSM());
+    TEST_ASSERT_EQUAL(4, headers[0].msmType());
+    TEST_ASSERT_EQUAL(GNSSSystem::GALILEO, headers[0].system());
+    TEST_ASSERT_EQUAL(0, headers[0].stationId());
+    TEST_ASSERT_EQUAL(223634000, headers[0].msmEpochTime());
+    TEST_ASSERT_TRUE(headers[0].msmMultipleMessage());
+
+    // BeiDou MSM4, last of its epoch
+    TEST_ASSERT_EQUAL(1124, headers[1].messageNumber());
+    TEST_ASSERT_EQUAL(GNSSSystem::BEIDOU, headers[1].system());
+    TEST_ASSERT_EQUAL(223620000, headers[1].msmEpochTime());
+    TEST_ASSERT_FALSE(headers[1].msmMultipleMessage());
+
+    // GLONASS MSM4: day of week 2, 61619 s into the day
+    TEST_ASSERT_EQUAL(1084, headers[6].messageNumber());
+    TEST_ASSERT_EQUAL(2, headers[6].msmEpochTime() >> 27);
+    TEST_ASSERT_EQUAL(61619000, headers[6].msmEpochTime() & 0x7FFFFFF);
+
+    size_t stations = 0;
+    for (const GNSSRTCM3Header &header : headers)
+    {
+        if (header.messageNumber() == 1006 || header.messageNumber() == 1033)
+        {
+            TEST_ASSERT_FALSE(header.isMSM());
+            TEST_ASSERT_TRUE(header.hasStationId());
+            TEST_ASSERT_EQUAL(0, header.msmEpochTime());
+            stations++;
+        }
+    }
+    TEST_ASSERT_EQUAL(4, stations);
+}
+
+void test_header_of_split_view()
+{
+    const uint64_t values[] = {1077, 2345, 0x3ABCDEF1, 1};
+    const unsigned widths[] = {12, 12, 30, 1};
+    std::vector<uint8_t> frame = makeFrame(values, widths, 4, 40);
+
+    GNSSRTCM3Header whole(frame.data(), frame.size());
+    TEST_ASSERT_EQUAL(1077, whole.messageNumber());
+    TEST_ASSERT_EQUAL(2345, whole.stationId());
+    TEST_ASSERT_EQUAL_HEX32(0x3ABCDEF1, whole.msmEpochTime());
+    TEST_ASSERT_TRUE(whole.msmMultipleMessage());
+    TEST_ASSERT_EQUAL(GNSSSystem::GPS, whole.system());
+    TEST_ASSERT_EQUAL(7, whole.msmType());
+
+    // The same frame cut by the end of a ring at every possible point
+    for (size_t cut = 1; cut < GNSSRTCM3Header::HEAD_LENGTH + 1; cut++)
+    {
+        GNSSParserBase::MessageView view = {GNSSParserBase::Message::Type::RTCM3,
+                                            frame.data(), cut,
+                                            frame.data() + cut, frame.size() - cut};
+        GNSSRTCM3Header split(view);
+        TEST_ASSERT_EQUAL(1077, split.messageNumber());
+        TEST_ASSERT_EQUAL(2345, split.stationId());
+        TEST_ASSERT_EQUAL_HEX32(0x3ABCDEF1, split.msmEpochTime());
+        TEST_ASSERT_TRUE(split.msmMultipleMessage());
+    }
+}
+
+void test_header_of_short_frames()
+{
+    // 1019 carries a satellite ID, not a station ID
+    const uint64_t values[] = {1019, 0xFFF};
+    const unsigned widths[] = {12, 12};
+    std::vector<uint8_t> ephemeris = makeFrame(values, widths, 2, 61);
+    GNSSRTCM3Header header(ephemeris.data(), ephemeris.size());
+    TEST_ASSERT_EQUAL(1019, header.messageNumber());
+    TEST_ASSERT_FALSE(header.hasStationId());
+    TEST_ASSERT_EQUAL(0, header.stationId());
+    TEST_ASSERT_EQUAL(GNSSSystem::GPS, header.system());
+
+    // An MSM number in a payload too short for the MSM header
+    const uint64_t msm[] = {1077};
+    std::vector<uint8_t> truncated = makeFrame(msm, widths, 1, 2);
+    GNSSRTCM3Header short_header(truncated.data(), truncated.size());
+    TEST_ASSERT_EQUAL(1077, short_header.messageNumber());
+    TEST_ASSERT_EQUAL(0, short_header.stationId());
+    TEST_ASSERT_EQUAL(0, short_header.msmEpochTime());
+
+    // Empty payload
+    std::vector<uint8_t> empty = makeFrame(msm, widths, 0, 0);
+    TEST_ASSERT_EQUAL(0, GNSSRTCM3Header(empty.data(), empty.size()).messageNumber());
+}
+
+void register_rtcm3_header_tests()
+{
+    RUN_TEST(test_bit_reader_fields);
+    RUN_TEST(test_bit_reader_matches_reference);
+    RUN_TEST(test_header_of_capture_frames);
+    RUN_TEST(test_header_of_split_view);
+    RUN_TEST(test_header_of_short_frames);
+}
@@ -0,0 +1,6 @@
+#ifndef __TEST_RTCM3_HEADER_H__
+#define __TEST_RTCM3_HEADER_H__
+
+void register_rtcm3_header_tests();
+
+#endif // __TEST_RTCM3_HEADER_H__
@@ -0,0 +1,312 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "GNSSStation.h"
+#include "test_bit_writer.h"
+
+static GNSSParserBase::MessageView viewOf(const std::vector<uint8_t> &frame)
+{
+    GNSSParserBase::MessageView view = {GNSSParserBase::Message::Type::RTCM3, frame.data(), frame.size(), nullptr, 0};
+    return view;
+}
+
+// 1005, or 1006 with an antenna height, coordinates in 0.1 mm
+static std::vector<uint8_t> position(uint16_t number, uint16_t station, int64_t x, int64_t y, int64_t z,
+                                     uint16_t height = 0)
+{
+    BitWriter writer;
+    writer.put(number, 12);
+    writer.put(station, 12);
+    writer.put(14, 6);  // ITRF2014
+    writer.put(1, 1);   // GPS
+    writer.put(0, 1);   // GLONASS
+    writer.put(1, 1);   // Galileo
+    writer.put(1, 1);   // reference station
+    writer.put(x & ((1ull << 38) - 1), 38);
+    writer.put(1, 1);   // single oscillator
+    writer.put(0, 1);
+    writer.put(y & ((1ull << 38) - 1), 38);
+    writer.put(2, 2);   // quarter cycle
+    writer.put(z & ((1ull << 38) - 1), 38);
+    if (number == 1006)
+        writer.put(height, 16);
+    return writer.frame();
+}
+
+static std::vector<uint8_t> descriptors(uint16_t station, const char *antenna, const char *receiver)
+{
+    BitWriter writer;
+    writer.put(1033, 12);
+    writer.put(station, 12);
+    writer.putString(antenna);
+    writer.put(3, 8); // setup ID
+    writer.putString("SN-ANT");
+    writer.putString(receiver);
+    writer.putString("1.2.3");
+    writer.putString("SN-RCV");
+    return writer.frame();
+}
+
+static std::vector<std::vector<uint8_t>> captureFrames(const char *path)
+{
+    std::vector<std::vector<uint8_t>> frames;
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    GNSSParser parser;
+    uint8_t chunk[256];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        parser.encode_to(chunk, read, [&](const GNSSParser::MessageView &view, bool valid)
+                         {
+                             if (valid && view.type == GNSSParser::Message::Type::RTCM3)
+                             {
+                                 std::vector<uint8_t> frame(view.length());
+                                 view.copyTo(frame.data());
+                                 frames.push_back(frame);
+                             }
+                         });
+    }
+    fclose(file);
+    return frames;
+}
+
+void test_station_cache_capture()
+{
+    static GNSSStationCache cache;
+    cache.clear();
+
+    // Counts from an independent decoder of the capture
+    size_t updated = 0, unchanged = 0, ignored = 0, notified = 0;
+    std::vector<std::vector<uint8_t>> frames = captureFrames("test/test-data/test-data-33816-2193.bin");
+    for (const std::vector<uint8_t> &frame : frames)
+    {
+        switch (cache.add(viewOf(frame), [&](const GNSSStationInfo &, uint16_t) { notified++; }))
+        {
+        case GNSSStationCache::UPDATED:
+            updated++;
+            break;
+        case GNSSStationCache::UNCHANGED:
+            unchanged++;
+            break;
+        default:
+            ignored++;
+            break;
+        }
+    }
+    TEST_ASSERT_EQUAL(2, updated);
+    TEST_ASSERT_EQUAL(228, unchanged);
+    TEST_ASSERT_EQUAL(frames.size() - 230, ignored);
+    TEST_ASSERT_EQUAL(2, notified);
+    TEST_ASSERT_EQUAL(1, cache.size());
+
+    const GNSSStationInfo *info = cache.find(0);
+    TEST_ASSERT_NOT_NULL(info);
+    TEST_ASSERT_EQUAL(GNSSStationInfo::MESSAGE_1006 | GNSSStationInfo::MESSAGE_1033, info->messages);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 4094584.4158, info->x);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 1998521.9230, info->y);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 4448499.9447, info->z);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0, info->antenna_height);
+    TEST_ASSERT_EQUAL_STRING("ADVNULLANTENNA", info->antenna_descriptor);
+    TEST_ASSERT_EQUAL(255, info->antenna_setup_id);
+    TEST_ASSERT_EQUAL_STRING("a0001", info->antenna_serial);
+    TEST_ASSERT_EQUAL_STRING("UNICORE UM980", info->receiver_type);
+    TEST_ASSERT_EQUAL_STRING("10110-25025", info->receiver_firmware);
+    TEST_ASSERT_EQUAL_STRING("ff27829657812f1b", info->receiver_serial);
+    TEST_ASSERT_NULL(cache.find(1));
+}
+
+void test_station_change_detection()
+{
+    static GNSSStationCache cache;
+    cache.clear();
+
+    uint16_t last_number = 0;
+    size_t notified = 0;
+    auto notify = [&](const GNSSStationInfo &, uint16_t number)
+    {
+        last_number = number;
+        notified++;
+    };
+
+    std::vector<uint8_t> arp = position(1005, 2001, 40945844158LL, 19985219230LL, -44484999447LL);
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(arp), notify));
+    TEST_ASSERT_EQUAL(GNSSStationCache::UNCHANGED, cache.add(viewOf(arp), notify));
+    TEST_ASSERT_EQUAL(1, notified);
+    TEST_ASSERT_EQUAL(1005, last_number);
+
+    const GNSSStationInfo *info = cache.find(2001);
+    TEST_ASSERT_NOT_NULL(info);
+    TEST_ASSERT_EQUAL(GNSSStationInfo::MESSAGE_1005, info->messages);
+    TEST_ASSERT_EQUAL(14, info->itrf_year);
+    TEST_ASSERT_TRUE(info->gps);
+    TEST_ASSERT_FALSE(info->glonass);
+    TEST_ASSERT_TRUE(info->galileo);
+    TEST_ASSERT_TRUE(info->reference_station);
+    TEST_ASSERT_TRUE(info->single_oscillator);
+    TEST_ASSERT_EQUAL(2, info->quarter_cycle);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, -4448499.9447, info->z);
+    TEST_ASSERT_TRUE(isnan(info->l1_ca_bias));
+
+    // The station moved by 0.1 mm
+    std::vector<uint8_t> moved = position(1005, 2001, 40945844159LL, 19985219230LL, -44484999447LL);
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(moved), notify));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 4094584.4159, info->x);
+    TEST_ASSERT_EQUAL(GNSSStationCache::UNCHANGED, cache.add(viewOf(moved), notify));
+
+    // 1006 is tracked apart from 1005 and adds the height
+    std::vector<uint8_t> height = position(1006, 2001, 40945844159LL, 19985219230LL, -44484999447LL, 15000);
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(height), notify));
+    TEST_ASSERT_EQUAL(GNSSStationCache::UNCHANGED, cache.add(viewOf(moved), notify));
+    TEST_ASSERT_EQUAL(GNSSStationCache::UNCHANGED, cache.add(viewOf(height), notify));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 1.5, info->antenna_height);
+    TEST_ASSERT_EQUAL(GNSSStationInfo::MESSAGE_1005 | GNSSStationInfo::MESSAGE_1006, info->messages);
+
+    // GLONASS biases: L1 C/A and L2 P only
+    BitWriter biases;
+    biases.put(1230, 12);
+    biases.put(2001, 12);
+    biases.put(1, 1);
+    biases.put(0, 3);
+    biases.put(0x9, 4);
+    biases.put(uint16_t(-150), 16);
+    biases.put(75, 16);
+    std::vector<uint8_t> bias_frame = biases.frame();
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(bias_frame), notify));
+    TEST_ASSERT_EQUAL(1230, last_number);
+    TEST_ASSERT_TRUE(info->biases_aligned);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, -3.0, info->l1_ca_bias);
+    TEST_ASSERT_TRUE(isnan(info->l1_p_bias));
+    TEST_ASSERT_TRUE(isnan(info->l2_ca_bias));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 1.5, info->l2_p_bias);
+
+    // Descriptor strings beyond 31 characters are cut, the fields after them
+    // still line up
+    std::vector<uint8_t> names = descriptors(2001, "A-VERY-LONG-ANTENNA-DESCRIPTOR-NAME-XYZ", "RCV");
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(names), notify));
+    TEST_ASSERT_EQUAL_STRING("A-VERY-LONG-ANTENNA-DESCRIPTOR-", info->antenna_descriptor);
+    TEST_ASSERT_EQUAL(3, info->antenna_setup_id);
+    TEST_ASSERT_EQUAL_STRING("SN-ANT", info->antenna_serial);
+    TEST_ASSERT_EQUAL_STRING("RCV", info->receiver_type);
+    TEST_ASSERT_EQUAL_STRING("1.2.3", info->receiver_firmware);
+    TEST_ASSERT_EQUAL_STRING("SN-RCV", info->receiver_serial);
+    TEST_ASSERT_EQUAL(5, notified);
+
+    // A truncated frame leaves the entry alone
+    BitWriter short_arp;
+    short_arp.put(1005, 12);
+    short_arp.put(2001, 12);
+    short_arp.put(0, 40);
+    std::vector<uint8_t> truncated = short_arp.frame();
+    TEST_ASSERT_EQUAL(GNSSStationCache::IGNORED, cache.add(viewOf(truncated), notify));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 4094584.4159, info->x);
+    TEST_ASSERT_EQUAL(5, notified);
+}
+
+void test_station_shared_fields()
+{
+    static GNSSStationCache cache;
+    cache.clear();
+
+    // A 1005 moving the reference point makes the same 1006 count again
+    std::vector<uint8_t> height = position(1006, 2002, 40945844158LL, 19985219230LL, -44484999447LL, 15000);
+    std::vector<uint8_t> moved = position(1005, 2002, 40945850000LL, 19985219230LL, -44484999447LL);
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(height)));
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(moved)));
+    const GNSSStationInfo *info = cache.find(2002);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 4094585.0, info->x);
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(height)));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 4094584.4158, info->x);
+    TEST_ASSERT_EQUAL(GNSSStationCache::UNCHANGED, cache.add(viewOf(height)));
+
+    // A 1005 agreeing with it leaves the 1006 unchanged
+    std::vector<uint8_t> same = position(1005, 2002, 40945844158LL, 19985219230LL, -44484999447LL);
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(same)));
+    TEST_ASSERT_EQUAL(GNSSStationCache::UNCHANGED, cache.add(viewOf(height)));
+    TEST_ASSERT_EQUAL(GNSSStationCache::UNCHANGED, cache.add(viewOf(same)));
+
+    // Likewise a 1007 renaming the antenna the 1033 describes
+    std::vector<uint8_t> names = descriptors(2002, "ANT-A", "RCV");
+    BitWriter antenna;
+    antenna.put(1007, 12);
+    antenna.put(2002, 12);
+    antenna.putString("ANT-B");
+    antenna.put(3, 8);
+    std::vector<uint8_t> renamed = antenna.frame();
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(names)));
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(renamed)));
+    TEST_ASSERT_EQUAL_STRING("ANT-B", info->antenna_descriptor);
+    TEST_ASSERT_EQUAL(GNSSStationCache::UPDATED, cache.add(viewOf(names)));
+    TEST_ASSERT_EQUAL_STRING("ANT-A", info->antenna_descriptor);
+    TEST_ASSERT_EQUAL(GNSSStationCache::UNCHANGED, cache.add(viewOf(names)));
+}
+
+void test_station_lookup_and_capacity()
+{
+    BasicGNSSStationCache<2> cache;
+
+    std::vector<uint8_t> a = position(1005, 4095, 1, 2, 3);
+    std::vector<uint8_t> b = position(1005, 7, 4, 5, 6);
+    std::vector<uint8_t> c = position(1005, 100, 7, 8, 9);
+    TEST_ASSERT_EQUAL(BasicGNSSStationCache<2>::UPDATED, cache.add(viewOf(a)));
+    TEST_ASSERT_EQUAL(BasicGNSSStationCache<2>::UPDATED, cache.add(viewOf(b)));
+    TEST_ASSERT_EQUAL(BasicGNSSStationCache<2>::IGNORED, cache.add(viewOf(c)));
+    TEST_ASSERT_EQUAL(2, cache.size());
+    TEST_ASSERT_EQUAL(1, cache.overflows());
+
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.0001, cache.find(4095)->x);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.0006, cache.find(7)->z);
+    TEST_ASSERT_NULL(cache.find(100));
+    TEST_ASSERT_NULL(cache.find(5000));
+
+    // Known stations still update when full
+    std::vector<uint8_t> moved = position(1005, 7, 4, 5, 60);
+    TEST_ASSERT_EQUAL(BasicGNSSStationCache<2>::UPDATED, cache.add(viewOf(moved)));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.006, cache.find(7)->z);
+
+    // Not station metadata
+    std::vector<uint8_t> other = position(1004, 7, 0, 0, 0);
+    TEST_ASSERT_EQUAL(BasicGNSSStationCache<2>::IGNORED, cache.add(viewOf(other)));
+
+    cache.clear();
+    TEST_ASSERT_EQUAL(0, cache.size());
+    TEST_ASSERT_NULL(cache.find(7));
+}
+
+void test_station_wrapped_view()
+{
+    static GNSSStationCache cache;
+    cache.clear();
+
+    // The frame wraps around the end of the parser's ring, CRC included
+    std::vector<uint8_t> names = descriptors(12, "TRM59800.00     NONE", "SEPT POLARX5");
+    for (size_t padding = names.size() - 8; padding < names.size(); padding++)
+    {
+        BasicGNSSParser<128, 8> parser;
+        std::vector<uint8_t> filler(128 - padding, 0);
+        parser.encode(filler.data(), filler.size());
+        parser.encode(names.data(), names.size());
+        GNSSParserBase::MessageView view = parser.peekMessage();
+        TEST_ASSERT_EQUAL(GNSSParserBase::Message::Type::RTCM3, view.type);
+        TEST_ASSERT_NOT_NULL(view.second);
+
+        GNSSStationCache::Update expected = padding == names.size() - 8 ? GNSSStationCache::UPDATED
+                                                                         : GNSSStationCache::UNCHANGED;
+        TEST_ASSERT_EQUAL(expected, cache.add(view));
+        parser.release();
+    }
+
+    TEST_ASSERT_EQUAL_STRING("SEPT POLARX5", cache.find(12)->receiver_type);
+}
+
+void register_station_tests()
+{
+    RUN_TEST(test_station_cache_capture);
+    RUN_TEST(test_station_change_detection);
+    RUN_TEST(test_station_shared_fields);
+    RUN_TEST(test_station_lookup_and_capacity);
+    RUN_TEST(test_station_wrapped_view);
+}
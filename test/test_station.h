@@ -0,0 +1,6 @@
+#ifndef __TEST_STATION_H__
+#define __TEST_STATION_H__
+
+void register_station_tests();
+
+#endif // __TEST_STATION_H__
@@ -0,0 +1,107 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GNSSSyncSearch.h"
+#include "GNSSParser.h"
+
+void test_sync_search_engines_agree()
+{
+    static uint8_t data[512];
+    const uint8_t sync_bytes[] = {0xD3, 0xB5, '$', '!'};
+    srand(99);
+
+    printf("Sync search engine: %d\n", GNSSSyncSearch::engine());
+
+    for (int iteration = 0; iteration < 3000; iteration++)
+    {
+        for (size_t i = 0; i < sizeof(data); i++)
+        {
+            uint8_t c = rand() & 0xFF;
+            data[i] = GNSSSyncSearch::isSyncByte(c) ? c ^ 0x01 : c;
+        }
+
+        size_t length = rand() % sizeof(data);
+        size_t offset = rand() % 32;
+        if (offset > length)
+            offset = length;
+
+        // Plant a sync byte at a random position, or none at all
+        if (iteration % 4 != 0 && length > offset)
+            data[offset + rand() % (length - offset)] = sync_bytes[rand() % 4];
+
+        size_t expected = GNSSSyncSearch::findScalar(data + offset, length - offset);
+
+        TEST_ASSERT_EQUAL(expected, GNSSSyncSearch::find(data + offset, length - offset));
+        TEST_ASSERT_EQUAL(expected, GNSSSyncSearch::findSSE2(data + offset, length - offset));
+        TEST_ASSERT_EQUAL(expected, GNSSSyncSearch::findAVX2(data + offset, length - offset));
+        TEST_ASSERT_EQUAL(expected, GNSSSyncSearch::findNEON(data + offset, length - offset));
+    }
+}
+
+// Sets of every size, as framer lists other than the default produce
+void test_sync_search_sets()
+{
+    static uint8_t data[512];
+    srand(7);
+
+    for (int iteration = 0; iteration < 2000; iteration++)
+    {
+        GNSSSyncSearch::Set set = {};
+        set.count = 1 + iteration % GNSSSyncSearch::MAX_SET_SIZE;
+        for (size_t k = 0; k < set.count; k++)
+        {
+            uint8_t c;
+            do
+                c = rand() & 0xFF;
+            while (set.contains(c));
+            set.bytes[k] = c;
+            set.map[c >> 5] |= 1u << (c & 31);
+        }
+
+        for (size_t i = 0; i < sizeof(data); i++)
+        {
+            do
+                data[i] = rand() & 0xFF;
+            while (set.contains(data[i]));
+        }
+
+        size_t length = rand() % sizeof(data);
+        if (iteration % 4 != 0 && length > 0)
+            data[rand() % length] = set.bytes[rand() % set.count];
+
+        size_t expected = GNSSSyncSearch::findScalar(data, length, set);
+
+        TEST_ASSERT_EQUAL(expected, GNSSSyncSearch::find(data, length, set));
+        TEST_ASSERT_EQUAL(expected, GNSSSyncSearch::findSSE2(data, length, set));
+        TEST_ASSERT_EQUAL(expected, GNSSSyncSearch::findAVX2(data, length, set));
+        TEST_ASSERT_EQUAL(expected, GNSSSyncSearch::findNEON(data, length, set));
+    }
+}
+
+void test_message_after_noise()
+{
+    const char *sentence = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+    uint8_t data[1024];
+    size_t noise = sizeof(data) - strlen(sentence);
+
+    for (size_t i = 0; i < noise; i++)
+        data[i] = GNSSSyncSearch::isSyncByte(i & 0xFF) ? 0 : (i & 0xFF);
+    memcpy(data + noise, sentence, strlen(sentence));
+
+    GNSSParser parser;
+    TEST_ASSERT_TRUE(parser.encode(data, sizeof(data)));
+    TEST_ASSERT_TRUE(parser.available());
+
+    auto msg = parser.getMessage();
+    TEST_ASSERT_EQUAL(GNSSParser::Message::Type::NMEA, msg.type);
+    TEST_ASSERT_EQUAL(strlen(sentence), msg.length);
+    TEST_ASSERT_EQUAL_MEMORY(sentence, msg.data, msg.length);
+}
+
+void register_sync_search_tests()
+{
+    RUN_TEST(test_sync_search_engines_agree);
+    RUN_TEST(test_sync_search_sets);
+    RUN_TEST(test_message_after_noise);
+}
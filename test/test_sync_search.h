@@ -0,0 +1,6 @@
+#ifndef __TEST_SYNC_SEARCH_H__
+#define __TEST_SYNC_SEARCH_H__
+
+void register_sync_search_tests();
+
+#endif // __TEST_SYNC_SEARCH_H__
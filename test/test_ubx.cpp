@@ -0,0 +1,379 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "GNSSParser.h"
+
+#if !defined(ARDUINO)
+#include "GNSSChunkedParser.h"
+#endif
+
+static const char *SENTENCE = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+
+static void append(std::vector<uint8_t> &stream, const std::vector<uint8_t> &frame)
+{
+    stream.insert(stream.end(), frame.begin(), frame.end());
+}
+
+static void append(std::vector<uint8_t> &stream, const char *sentence)
+{
+    stream.insert(stream.end(), sentence, sentence + strlen(sentence));
+}
+
+// Payload bytes include RTCM3 preambles and NMEA starts, which must not be
+// taken for frames of their own
+static std::vector<uint8_t> ubxFrame(uint8_t message_class, uint8_t id, size_t payload_length)
+{
+    std::vector<uint8_t> frame = {0xB5, 0x62, message_class, id, uint8_t(payload_length & 0xFF), uint8_t(payload_length >> 8)};
+    for (size_t i = 0; i < payload_length; i++)
+    {
+        static const uint8_t traps[] = {0xD3, 0x00, 0x13, '$', 0xB5, 0x62};
+        frame.push_back(i % 7 == 0 ? traps[(i / 7) % sizeof(traps)] : uint8_t(i * 41 + id));
+    }
+    uint16_t sum = GNSSFletcher::calculate(frame.data() + 2, frame.size() - 2);
+    frame.push_back(sum & 0xFF);
+    frame.push_back(sum >> 8);
+    return frame;
+}
+
+static std::vector<uint8_t> rtcm3Frame(size_t payload_length)
+{
+    std::vector<uint8_t> frame = {0xD3, uint8_t(payload_length >> 8), uint8_t(payload_length & 0xFF)};
+    for (size_t i = 0; i < payload_length; i++)
+        frame.push_back(uint8_t(i * 13));
+    uint32_t crc = GNSSCRC24Q::calculate(frame.data(), frame.size());
+    frame.push_back(crc >> 16);
+    frame.push_back(crc >> 8);
+    frame.push_back(crc);
+    return frame;
+}
+
+static std::vector<uint8_t> mixedStream()
+{
+    std::vector<uint8_t> stream;
+    append(stream, SENTENCE);
+    append(stream, ubxFrame(0x01, 0x07, 92)); // NAV-PVT
+    append(stream, rtcm3Frame(40));
+    append(stream, ubxFrame(0x02, 0x15, 16 + 32 * 24)); // RXM-RAWX
+    append(stream, SENTENCE);
+    append(stream, ubxFrame(0x05, 0x01, 2)); // ACK-ACK
+    append(stream, ubxFrame(0x0A, 0x04, 0)); // MON-VER poll
+    append(stream, rtcm3Frame(200));
+    append(stream, SENTENCE);
+    return stream;
+}
+
+static const GNSSParserBase::Message::Type MIXED_TYPES[] = {
+    GNSSParserBase::Message::Type::NMEA, GNSSParserBase::Message::Type::UBX, GNSSParserBase::Message::Type::RTCM3,
+    GNSSParserBase::Message::Type::UBX, GNSSParserBase::Message::Type::NMEA, GNSSParserBase::Message::Type::UBX,
+    GNSSParserBase::Message::Type::UBX, GNSSParserBase::Message::Type::RTCM3, GNSSParserBase::Message::Type::NMEA};
+
+static const size_t MIXED_LENGTHS[] = {67, 100, 46, 792, 67, 10, 8, 206, 67};
+
+void test_fletcher_known_frames()
+{
+    // CFG-PRT and MON-VER polls as listed in the u-blox interface descriptions
+    const uint8_t cfg_prt[] = {0xB5, 0x62, 0x06, 0x00, 0x00, 0x00, 0x06, 0x18};
+    const uint8_t mon_ver[] = {0xB5, 0x62, 0x0A, 0x04, 0x00, 0x00, 0x0E, 0x34};
+
+    TEST_ASSERT_EQUAL_UINT16(0x1806, GNSSFletcher::calculate(cfg_prt + 2, 4));
+    TEST_ASSERT_EQUAL_UINT16(0x340E, GNSSFletcher::calculate(mon_ver + 2, 4));
+}
+
+void test_fletcher_engines_agree()
+{
+    static uint8_t data[4096 + 64];
+    srand(2024);
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = rand() & 0xFF;
+
+    printf("Fletcher engine: %d\n", GNSSFletcher::engine());
+
+    for (int iteration = 0; iteration < 2000; iteration++)
+    {
+        size_t offset = rand() % 64;
+        size_t length = iteration < 300 ? iteration : rand() % 4096;
+        uint16_t initial = rand() & 0xFFFF;
+        uint16_t expected = GNSSFletcher::updateBytewise(initial, data + offset, length);
+
+        TEST_ASSERT_EQUAL_UINT16(expected, GNSSFletcher::updateBlocked(initial, data + offset, length));
+        TEST_ASSERT_EQUAL_UINT16(expected, GNSSFletcher::updateSSE2(initial, data + offset, length));
+        TEST_ASSERT_EQUAL_UINT16(expected, GNSSFletcher::updateNEON(initial, data + offset, length));
+        TEST_ASSERT_EQUAL_UINT16(expected, GNSSFletcher::update(initial, data + offset, length));
+
+        size_t split = length ? rand() % length : 0;
+        TEST_ASSERT_EQUAL_UINT16(expected, GNSSFletcher::update(initial, data + offset, split,
+                                                                data + offset + split, length - split));
+    }
+}
+
+void test_ubx_frames_in_mixed_stream()
+{
+    std::vector<uint8_t> stream = mixedStream();
+    const size_t chunks[] = {1, 7, 64, 1000, stream.size()};
+
+    for (size_t chunk : chunks)
+    {
+        GNSSParser parser;
+        std::vector<GNSSParserBase::MessageView> views;
+        std::vector<std::vector<uint8_t>> frames;
+
+        for (size_t pos = 0; pos < stream.size(); pos += chunk)
+        {
+            size_t length = std::min(chunk, stream.size() - pos);
+            parser.encode_to(stream.data() + pos, length, [&](const GNSSParser::MessageView &view, bool valid)
+                             {
+                                 TEST_ASSERT_TRUE(valid);
+                                 views.push_back(view);
+                                 frames.push_back(std::vector<uint8_t>(view.length()));
+                                 view.copyTo(frames.back().data());
+                             });
+        }
+
+        TEST_ASSERT_EQUAL(sizeof(MIXED_LENGTHS) / sizeof(MIXED_LENGTHS[0]), views.size());
+        size_t offset = 0;
+        for (size_t i = 0; i < views.size(); i++)
+        {
+            TEST_ASSERT_EQUAL(MIXED_TYPES[i], views[i].type);
+            TEST_ASSERT_EQUAL(MIXED_LENGTHS[i], frames[i].size());
+            TEST_ASSERT_EQUAL_MEMORY(stream.data() + offset, frames[i].data(), frames[i].size());
+            offset += frames[i].size();
+        }
+    }
+}
+
+void test_ubx_queued_and_copied()
+{
+    std::vector<uint8_t> stream = mixedStream();
+    GNSSParser parser;
+    size_t index = 0, offset = 0, consumed = 0;
+
+    // Small writes make the long frames wrap the ring
+    while (consumed < stream.size() || parser.available())
+    {
+        size_t length = std::min<size_t>(300, stream.size() - consumed);
+        if (length && parser.available_write_space() >= length)
+        {
+            TEST_ASSERT_TRUE(parser.encode(stream.data() + consumed, length));
+            consumed += length;
+        }
+
+        while (parser.available())
+        {
+            GNSSParser::Message msg = parser.getMessage();
+            TEST_ASSERT_EQUAL(MIXED_TYPES[index], msg.type);
+            TEST_ASSERT_EQUAL(MIXED_LENGTHS[index], msg.length);
+            TEST_ASSERT_EQUAL_MEMORY(stream.data() + offset, msg.data, msg.length);
+            offset += msg.length;
+            index++;
+        }
+    }
+    TEST_ASSERT_EQUAL(sizeof(MIXED_LENGTHS) / sizeof(MIXED_LENGTHS[0]), index);
+}
+
+void test_ubx_long_frame_copied()
+{
+    // Longer than any RTCM3 frame, drained the usual way
+    TEST_ASSERT_EQUAL(GNSSParser::BUFFER_SIZE, GNSSParser::MAX_MESSAGE_LENGTH);
+
+    std::vector<uint8_t> stream = ubxFrame(0x02, 0x15, 1500);
+    append(stream, SENTENCE);
+    GNSSParser parser;
+    TEST_ASSERT_TRUE(parser.encode(stream.data(), stream.size()));
+
+    GNSSParser::Message msg = parser.getMessage();
+    TEST_ASSERT_EQUAL(GNSSParser::Message::Type::UBX, msg.type);
+    TEST_ASSERT_EQUAL(1508, msg.length);
+    TEST_ASSERT_NOT_NULL(msg.data);
+    TEST_ASSERT_EQUAL_MEMORY(stream.data(), msg.data, 1508);
+
+    msg = parser.getMessage();
+    TEST_ASSERT_EQUAL(GNSSParser::Message::Type::NMEA, msg.type);
+    TEST_ASSERT_EQUAL_MEMORY(SENTENCE, msg.data, strlen(SENTENCE));
+    TEST_ASSERT_FALSE(parser.available());
+}
+
+void test_ubx_checksum_failure_resynchronises()
+{
+    // A sentence hidden in a frame whose checksum fails is still found
+    std::vector<uint8_t> frame = ubxFrame(0x01, 0x07, 0);
+    std::vector<uint8_t> stream = {0xB5, 0x62, 0x01, 0x07, uint8_t(strlen(SENTENCE)), 0x00};
+    append(stream, SENTENCE);
+    stream.push_back(0x00);
+    stream.push_back(0x00);
+    append(stream, frame);
+
+    GNSSParser parser;
+    size_t invalid = 0;
+    std::vector<GNSSParserBase::Message::Type> types;
+    parser.encode_to(stream.data(), stream.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                     {
+                         if (!valid)
+                         {
+                             TEST_ASSERT_EQUAL(GNSSParserBase::Message::Type::UBX, view.type);
+                             invalid++;
+                             return;
+                         }
+                         types.push_back(view.type);
+                     });
+
+    TEST_ASSERT_EQUAL(1, invalid);
+    TEST_ASSERT_EQUAL(2, types.size());
+    TEST_ASSERT_EQUAL(GNSSParserBase::Message::Type::NMEA, types[0]);
+    TEST_ASSERT_EQUAL(GNSSParserBase::Message::Type::UBX, types[1]);
+}
+
+void test_ubx_frame_longer_than_buffer()
+{
+    // 1000 byte payload, which a 256 byte ring can never hold
+    const uint8_t header[] = {0xB5, 0x62, 0x02, 0x13, 0xE8, 0x03};
+    typedef BasicGNSSParser<256, 8> SmallParser;
+    SmallParser parser;
+
+    TEST_ASSERT_EQUAL(256, SmallParser::MAX_MESSAGE_LENGTH);
+    TEST_ASSERT_TRUE(parser.encode(header, sizeof(header)));
+    TEST_ASSERT_TRUE(parser.encode((const uint8_t *)SENTENCE, strlen(SENTENCE)));
+
+    GNSSParser::Message msg = parser.getMessage();
+    TEST_ASSERT_EQUAL(GNSSParser::Message::Type::NMEA, msg.type);
+    TEST_ASSERT_EQUAL(strlen(SENTENCE), msg.length);
+}
+
+void test_ubx_left_out_of_protocols()
+{
+    // Unframed UBX payloads are rescanned byte by byte, and a 0xD3 in them can
+    // hold up what follows until a whole RTCM3 frame's worth has arrived
+    std::vector<uint8_t> stream = mixedStream();
+    stream.resize(stream.size() + GNSSParserBase::MAX_RTCM3_LENGTH, 0);
+    BasicGNSSParser<4096, 128, GNSSProtocol::NMEA | GNSSProtocol::RTCM3> parser;
+    size_t nmea = 0, rtcm = 0;
+
+    parser.encode_to(stream.data(), stream.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                     {
+                         if (!valid)
+                             return;
+                         TEST_ASSERT_TRUE(view.type != GNSSParserBase::Message::Type::UBX);
+                         (view.type == GNSSParserBase::Message::Type::NMEA ? nmea : rtcm)++;
+                     });
+
+    TEST_ASSERT_EQUAL(3, nmea);
+    TEST_ASSERT_EQUAL(2, rtcm);
+}
+
+void test_ubx_filter()
+{
+    std::vector<uint8_t> stream = mixedStream();
+
+    GNSSMessageFilter filter;
+    filter.allowUBX(0x05);
+    TEST_ASSERT_TRUE(filter.allowUBX(0x01, 0x07));
+    filter.blockRTCM3();
+
+    for (int skip = 0; skip < 2; skip++)
+    {
+        filter.setSkipRejected(skip != 0);
+
+        GNSSParser parser;
+        parser.setFilter(&filter);
+        std::vector<size_t> lengths;
+        parser.encode_to(stream.data(), stream.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                         {
+                             if (valid)
+                                 lengths.push_back(view.length());
+                         });
+
+        // NAV-PVT, ACK-ACK and the sentences; RXM-RAWX, MON-VER and RTCM3 dropped
+        const size_t expected[] = {67, 100, 67, 10, 67};
+        TEST_ASSERT_EQUAL(sizeof(expected) / sizeof(expected[0]), lengths.size());
+        for (size_t i = 0; i < lengths.size(); i++)
+            TEST_ASSERT_EQUAL(expected[i], lengths[i]);
+    }
+
+    filter.blockUBX();
+    TEST_ASSERT_FALSE(filter.passesUBX(0x01, 0x07));
+    TEST_ASSERT_FALSE(filter.passesUBX(0x05, 0x01));
+    filter.clear();
+    TEST_ASSERT_TRUE(filter.passesUBX(0x02, 0x15));
+}
+
+#if !defined(ARDUINO)
+void test_ubx_chunked_matches_sequential()
+{
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < 50; i++)
+        append(stream, mixedStream());
+
+    std::vector<size_t> lengths;
+    GNSSParser parser;
+    parser.encode_to(stream.data(), stream.size(), [&](const GNSSParser::MessageView &view, bool valid)
+                     {
+                         if (valid)
+                             lengths.push_back(view.length());
+                     });
+
+    const size_t chunk_sizes[] = {97, 1024, 4096};
+    for (size_t chunk_size : chunk_sizes)
+    {
+        GNSSChunkedParser chunked(4, chunk_size);
+        std::vector<GNSSChunkedParser::Frame> frames = chunked.parse(stream.data(), stream.size());
+
+        // Every byte belongs to a frame
+        TEST_ASSERT_EQUAL(lengths.size(), frames.size());
+        size_t offset = 0;
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            TEST_ASSERT_EQUAL(MIXED_TYPES[i % 9], frames[i].type);
+            TEST_ASSERT_EQUAL(offset, frames[i].offset);
+            TEST_ASSERT_EQUAL(lengths[i], frames[i].length);
+            offset += frames[i].length;
+        }
+    }
+}
+#endif
+
+#if GNSS_PARSER_STATS
+void test_ubx_stats()
+{
+    std::vector<uint8_t> stream = mixedStream();
+    std::vector<uint8_t> bad = ubxFrame(0x01, 0x07, 0);
+    bad[6] ^= 0xFF;
+    append(stream, bad);
+
+    // 0xB5 without its second sync character, and a length too long to buffer
+    const uint8_t noise[] = {0xB5, 0x00, 0xB5, 0x62, 0x01, 0x02, 0xFF, 0xFF};
+    stream.insert(stream.end(), noise, noise + sizeof(noise));
+    append(stream, SENTENCE);
+
+    GNSSParser parser;
+    parser.encode_to(stream.data(), stream.size(), [](const GNSSParser::MessageView &, bool) {});
+
+    GNSSParser::Stats stats = parser.stats();
+    TEST_ASSERT_EQUAL(4, stats.ubx_frames);
+    TEST_ASSERT_EQUAL(4, stats.nmea_frames);
+    TEST_ASSERT_EQUAL(2, stats.rtcm3_frames);
+    TEST_ASSERT_EQUAL(1, stats.fletcher_failures);
+    TEST_ASSERT_EQUAL(1, stats.invalid_lengths);
+    TEST_ASSERT_EQUAL(0, stats.crc_failures);
+    TEST_ASSERT_EQUAL(0, stats.checksum_failures);
+}
+#endif
+
+void register_ubx_tests()
+{
+    RUN_TEST(test_fletcher_known_frames);
+    RUN_TEST(test_fletcher_engines_agree);
+    RUN_TEST(test_ubx_frames_in_mixed_stream);
+    RUN_TEST(test_ubx_queued_and_copied);
+    RUN_TEST(test_ubx_long_frame_copied);
+    RUN_TEST(test_ubx_checksum_failure_resynchronises);
+    RUN_TEST(test_ubx_frame_longer_than_buffer);
+    RUN_TEST(test_ubx_left_out_of_protocols);
+    RUN_TEST(test_ubx_filter);
+#if !defined(ARDUINO)
+    RUN_TEST(test_ubx_chunked_matches_sequential);
+#endif
+#if GNSS_PARSER_STATS
+    RUN_TEST(test_ubx_stats);
+#endif
+}
@@ -0,0 +1,6 @@
+#ifndef __TEST_UBX_H__
+#define __TEST_UBX_H__
+
+void register_ubx_tests();
+
+#endif // __TEST_UBX_H__
@@ -0,0 +1,144 @@
+// gnss_parse: frames a raw capture file and reports what is in it
+//
+//   gnss_parse [-l] [-j threads] capture.bin
+//
+//   -l          list every frame: offset, protocol, message id, length
+//   -j threads  parser threads (default: all hardware threads)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include "GNSSChunkedParser.h"
+#include "GNSSMappedFile.h"
+#include "GNSSRTCM3.h"
+
+// NMEA address field ("GPGGA"), RTCM3 message number ("1077") or UBX class
+// and ID ("01-07")
+static std::string messageId(const uint8_t *frame, const GNSSChunkedParser::Frame &info)
+{
+    if (info.type == GNSSParserBase::Message::Type::RTCM3)
+    {
+        if (info.length < 8)
+            return "?";
+        return std::to_string(GNSSRTCM3Header(frame, info.length).messageNumber());
+    }
+
+    if (info.type == GNSSParserBase::Message::Type::UBX)
+    {
+        char id[8];
+        snprintf(id, sizeof(id), "%02X-%02X", frame[2], frame[3]);
+        return id;
+    }
+
+    size_t end = 1;
+    while (end < info.length && end < 16 && frame[end] != ',' && frame[end] != '*')
+        end++;
+    return std::string(reinterpret_cast<const char *>(frame) + 1, end - 1);
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: gnss_parse [-l] [-j threads] capture.bin\n");
+}
+
+int main(int argc, char **argv)
+{
+    bool list = false;
+    size_t threads = 0;
+    const char *path = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-l") == 0)
+        {
+            list = true;
+        }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            threads = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (argv[i][0] != '-' && !path)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    if (!path)
+    {
+        usage();
+        return 2;
+    }
+
+    GNSSMappedFile file(path);
+    if (!file.valid())
+    {
+        fprintf(stderr, "gnss_parse: cannot read %s\n", path);
+        return 1;
+    }
+
+    std::map<std::string, size_t> nmea;
+    std::map<int, size_t> rtcm;
+    std::map<std::string, size_t> ubx;
+    size_t frames = 0;
+    GNSSChunkedParser parser(threads);
+
+    auto start = std::chrono::steady_clock::now();
+    parser.parse(file.data(), file.size(), [&](const GNSSChunkedParser::Frame &frame)
+                 {
+                     const uint8_t *data = file.data() + frame.offset;
+                     std::string id = messageId(data, frame);
+                     const char *protocol = "NMEA";
+
+                     if (frame.type == GNSSParserBase::Message::Type::RTCM3)
+                     {
+                         rtcm[atoi(id.c_str())]++;
+                         protocol = "RTCM3";
+                     }
+                     else if (frame.type == GNSSParserBase::Message::Type::UBX)
+                     {
+                         ubx[id]++;
+                         protocol = "UBX";
+                     }
+                     else
+                     {
+                         nmea[id]++;
+                     }
+                     frames++;
+
+                     if (list)
+                         printf("%12zu  %-5s  %-8s  %4zu\n", frame.offset, protocol, id.c_str(), frame.length); });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t nmea_total = 0;
+    size_t rtcm_total = 0;
+    size_t ubx_total = 0;
+    for (const auto &entry : nmea)
+        nmea_total += entry.second;
+    for (const auto &entry : rtcm)
+        rtcm_total += entry.second;
+    for (const auto &entry : ubx)
+        ubx_total += entry.second;
+
+    printf("%s: %zu bytes%s, %zu frames (%zu NMEA, %zu RTCM3, %zu UBX)\n", path, file.size(),
+           file.mapped() ? " mapped" : "", frames, nmea_total, rtcm_total, ubx_total);
+    printf("parsed in %.3f s, %.1f MB/s, %.0f frames/s, %zu threads\n", seconds,
+           seconds > 0 ? file.size() / seconds / 1e6 : 0.0,
+           seconds > 0 ? frames / seconds : 0.0, parser.threads());
+
+    for (const auto &entry : nmea)
+        printf("NMEA   %-8s %10zu\n", entry.first.c_str(), entry.second);
+    for (const auto &entry : rtcm)
+        printf("RTCM3  %-8d %10zu\n", entry.first, entry.second);
+    for (const auto &entry : ubx)
+        printf("UBX    %-8s %10zu\n", entry.first.c_str(), entry.second);
+
+    return 0;
+}